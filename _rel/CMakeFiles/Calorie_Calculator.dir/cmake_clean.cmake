@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Calorie_Calculator.dir/main.cpp.o"
+  "CMakeFiles/Calorie_Calculator.dir/main.cpp.o.d"
+  "Calorie_Calculator"
+  "Calorie_Calculator.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Calorie_Calculator.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
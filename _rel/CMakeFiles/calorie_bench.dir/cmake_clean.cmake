@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/calorie_bench.dir/bench/calorie_bench.cpp.o"
+  "CMakeFiles/calorie_bench.dir/bench/calorie_bench.cpp.o.d"
+  "calorie_bench"
+  "calorie_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/calorie_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
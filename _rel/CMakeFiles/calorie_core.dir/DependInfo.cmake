@@ -0,0 +1,42 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/binary_store.cpp" "CMakeFiles/calorie_core.dir/binary_store.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/binary_store.cpp.o.d"
+  "/root/repo/column_kernels.cpp" "CMakeFiles/calorie_core.dir/column_kernels.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/column_kernels.cpp.o.d"
+  "/root/repo/console_renderer.cpp" "CMakeFiles/calorie_core.dir/console_renderer.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/console_renderer.cpp.o.d"
+  "/root/repo/data_manager.cpp" "CMakeFiles/calorie_core.dir/data_manager.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/data_manager.cpp.o.d"
+  "/root/repo/data_snapshot.cpp" "CMakeFiles/calorie_core.dir/data_snapshot.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/data_snapshot.cpp.o.d"
+  "/root/repo/date.cpp" "CMakeFiles/calorie_core.dir/date.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/date.cpp.o.d"
+  "/root/repo/day_store.cpp" "CMakeFiles/calorie_core.dir/day_store.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/day_store.cpp.o.d"
+  "/root/repo/durable_file.cpp" "CMakeFiles/calorie_core.dir/durable_file.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/durable_file.cpp.o.d"
+  "/root/repo/food.cpp" "CMakeFiles/calorie_core.dir/food.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/food.cpp.o.d"
+  "/root/repo/food_columns.cpp" "CMakeFiles/calorie_core.dir/food_columns.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/food_columns.cpp.o.d"
+  "/root/repo/journal.cpp" "CMakeFiles/calorie_core.dir/journal.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/journal.cpp.o.d"
+  "/root/repo/mapped_file.cpp" "CMakeFiles/calorie_core.dir/mapped_file.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/mapped_file.cpp.o.d"
+  "/root/repo/name_pool.cpp" "CMakeFiles/calorie_core.dir/name_pool.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/name_pool.cpp.o.d"
+  "/root/repo/parallel_text_loader.cpp" "CMakeFiles/calorie_core.dir/parallel_text_loader.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/parallel_text_loader.cpp.o.d"
+  "/root/repo/persistence_worker.cpp" "CMakeFiles/calorie_core.dir/persistence_worker.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/persistence_worker.cpp.o.d"
+  "/root/repo/platform.cpp" "CMakeFiles/calorie_core.dir/platform.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/platform.cpp.o.d"
+  "/root/repo/profile_registry.cpp" "CMakeFiles/calorie_core.dir/profile_registry.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/profile_registry.cpp.o.d"
+  "/root/repo/range_aggregator.cpp" "CMakeFiles/calorie_core.dir/range_aggregator.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/range_aggregator.cpp.o.d"
+  "/root/repo/sound_player.cpp" "CMakeFiles/calorie_core.dir/sound_player.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/sound_player.cpp.o.d"
+  "/root/repo/template_index.cpp" "CMakeFiles/calorie_core.dir/template_index.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/template_index.cpp.o.d"
+  "/root/repo/template_store.cpp" "CMakeFiles/calorie_core.dir/template_store.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/template_store.cpp.o.d"
+  "/root/repo/terminal_posix.cpp" "CMakeFiles/calorie_core.dir/terminal_posix.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/terminal_posix.cpp.o.d"
+  "/root/repo/terminal_win32.cpp" "CMakeFiles/calorie_core.dir/terminal_win32.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/terminal_win32.cpp.o.d"
+  "/root/repo/ui_manager.cpp" "CMakeFiles/calorie_core.dir/ui_manager.cpp.o" "gcc" "CMakeFiles/calorie_core.dir/ui_manager.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,57 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/calorie_core.dir/binary_store.cpp.o"
+  "CMakeFiles/calorie_core.dir/binary_store.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/column_kernels.cpp.o"
+  "CMakeFiles/calorie_core.dir/column_kernels.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/console_renderer.cpp.o"
+  "CMakeFiles/calorie_core.dir/console_renderer.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/data_manager.cpp.o"
+  "CMakeFiles/calorie_core.dir/data_manager.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/data_snapshot.cpp.o"
+  "CMakeFiles/calorie_core.dir/data_snapshot.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/date.cpp.o"
+  "CMakeFiles/calorie_core.dir/date.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/day_store.cpp.o"
+  "CMakeFiles/calorie_core.dir/day_store.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/durable_file.cpp.o"
+  "CMakeFiles/calorie_core.dir/durable_file.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/food.cpp.o"
+  "CMakeFiles/calorie_core.dir/food.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/food_columns.cpp.o"
+  "CMakeFiles/calorie_core.dir/food_columns.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/journal.cpp.o"
+  "CMakeFiles/calorie_core.dir/journal.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/mapped_file.cpp.o"
+  "CMakeFiles/calorie_core.dir/mapped_file.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/name_pool.cpp.o"
+  "CMakeFiles/calorie_core.dir/name_pool.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/parallel_text_loader.cpp.o"
+  "CMakeFiles/calorie_core.dir/parallel_text_loader.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/persistence_worker.cpp.o"
+  "CMakeFiles/calorie_core.dir/persistence_worker.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/platform.cpp.o"
+  "CMakeFiles/calorie_core.dir/platform.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/profile_registry.cpp.o"
+  "CMakeFiles/calorie_core.dir/profile_registry.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/range_aggregator.cpp.o"
+  "CMakeFiles/calorie_core.dir/range_aggregator.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/sound_player.cpp.o"
+  "CMakeFiles/calorie_core.dir/sound_player.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/template_index.cpp.o"
+  "CMakeFiles/calorie_core.dir/template_index.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/template_store.cpp.o"
+  "CMakeFiles/calorie_core.dir/template_store.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/terminal_posix.cpp.o"
+  "CMakeFiles/calorie_core.dir/terminal_posix.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/terminal_win32.cpp.o"
+  "CMakeFiles/calorie_core.dir/terminal_win32.cpp.o.d"
+  "CMakeFiles/calorie_core.dir/ui_manager.cpp.o"
+  "CMakeFiles/calorie_core.dir/ui_manager.cpp.o.d"
+  "libcalorie_core.a"
+  "libcalorie_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/calorie_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
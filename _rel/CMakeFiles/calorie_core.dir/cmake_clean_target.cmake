@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libcalorie_core.a"
+)
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/column_kernels_test.dir/tests/column_kernels_test.cpp.o"
+  "CMakeFiles/column_kernels_test.dir/tests/column_kernels_test.cpp.o.d"
+  "column_kernels_test"
+  "column_kernels_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/column_kernels_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/data_snapshot_test.dir/tests/data_snapshot_test.cpp.o"
+  "CMakeFiles/data_snapshot_test.dir/tests/data_snapshot_test.cpp.o.d"
+  "data_snapshot_test"
+  "data_snapshot_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/data_snapshot_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
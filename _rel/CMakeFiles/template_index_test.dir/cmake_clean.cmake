@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/template_index_test.dir/tests/template_index_test.cpp.o"
+  "CMakeFiles/template_index_test.dir/tests/template_index_test.cpp.o.d"
+  "template_index_test"
+  "template_index_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/template_index_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/text_loader_test.dir/tests/text_loader_test.cpp.o"
+  "CMakeFiles/text_loader_test.dir/tests/text_loader_test.cpp.o.d"
+  "text_loader_test"
+  "text_loader_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/text_loader_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
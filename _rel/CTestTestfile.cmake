@@ -0,0 +1,16 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_rel
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(column_kernels "/root/repo/_rel/column_kernels_test")
+set_tests_properties(column_kernels PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;62;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(text_loader "/root/repo/_rel/text_loader_test")
+set_tests_properties(text_loader PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;65;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(data_snapshot "/root/repo/_rel/data_snapshot_test")
+set_tests_properties(data_snapshot PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;68;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(template_index "/root/repo/_rel/template_index_test")
+set_tests_properties(template_index PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;71;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(crash_injection "/root/repo/_rel/crash_injection_test")
+set_tests_properties(crash_injection PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
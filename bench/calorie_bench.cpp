@@ -0,0 +1,799 @@
+// -----------------------------------------------------------------------------
+// File: calorie_bench.cpp
+// Purpose: Benchmark driver for the timings quoted in the commit history.
+//          "calorie_bench" runs every benchmark, "calorie_bench <name> ..."
+//          only the named ones. Exits non-zero if a result is wrong or a
+//          benchmark misses its target. Data files are generated in a scratch
+//          directory under the system temporary directory and removed again.
+// -----------------------------------------------------------------------------
+
+#include "data_manager.h"
+#include "profile_registry.h"
+#include "constants.h"
+#include "template_index.h"
+#include "name_pool.h"
+#include "mapped_file.h"
+#include "parallel_text_loader.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>  // malloc_trim
+#endif
+
+namespace fs = std::filesystem;
+
+// Food names the generated files cycle through.
+static const char *const BENCH_FOODS[] = { "Apple", "Chicken Breast", "Brown Rice", "Greek Yogurt",
+                                           "Oatmeal", "Salmon", "Broccoli", "Almonds" };
+static const size_t BENCH_FOOD_COUNT = sizeof(BENCH_FOODS) / sizeof(BENCH_FOODS[0]);
+
+// Matches a search is asked for, as many as the template popup shows.
+static const size_t TEMPLATE_PAGE = 32;
+
+// Keeps results alive so the measured calls are not optimized away.
+static volatile uint64_t benchSink;
+
+// -----------------------------------------------------------------------------
+// Helper: secondsSince
+// Purpose: Wall-clock seconds elapsed since 'start'.
+// -----------------------------------------------------------------------------
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// -----------------------------------------------------------------------------
+// Helper: scratchFiles
+// Purpose: DataFiles named 'stem' in the scratch directory, with any files
+//          left from an earlier run removed.
+// -----------------------------------------------------------------------------
+static DataFiles scratchFiles(const std::string &stem) {
+    fs::path directory = fs::temp_directory_path() / "calorie_bench";
+    fs::create_directories(directory);
+    DataFiles files{ (directory / (stem + ".txt")).string(), (directory / (stem + ".bin")).string(),
+                     (directory / (stem + ".journal")).string() };
+    fs::remove(files.text);
+    fs::remove(files.binary);
+    fs::remove(files.journal);
+    return files;
+}
+
+static void removeFiles(const DataFiles &files) {
+    fs::remove(files.text);
+    fs::remove(files.binary);
+    fs::remove(files.journal);
+}
+
+// -----------------------------------------------------------------------------
+// Helper: writeTextData
+// Purpose: A text data file of 'dayCount' consecutive days from 01/01/2000
+//          with 'foodsPerDay' entries each. Returns the number of lines.
+// -----------------------------------------------------------------------------
+static size_t writeTextData(const std::string &path, size_t dayCount, size_t foodsPerDay) {
+    std::ofstream out(path, std::ios::binary);
+    out << "DAILY_GOALS: 2000,250,150,70\n";
+    size_t lines = 1;
+    Date first = Date::fromCivil(2000, 1, 1);
+    for (size_t d = 0; d < dayCount; d++) {
+        out << "DATE: " << (first + static_cast<int32_t>(d)).toString() << '\n';
+        for (size_t f = 0; f < foodsPerDay; f++) {
+            size_t i = d * foodsPerDay + f;
+            out << "FOOD: " << BENCH_FOODS[i % BENCH_FOOD_COUNT] << '|' << 50 + i % 700 << '|' << i % 90 << '|'
+                << i % 45 << '|' << i % 30 << '|' << 100 + i % 200 << '\n';
+        }
+        lines += 1 + foodsPerDay;
+    }
+    return lines;
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark: lookup
+// Purpose: findRecord cost from 10 to 100k logged days. "resident" looks up
+//          days already in memory, the hash lookup every keypress does;
+//          "any day" picks days at random, so beyond RESIDENT_DAY_LIMIT most
+//          of them are read from the data file and others are evicted.
+// -----------------------------------------------------------------------------
+static bool benchLookup() {
+    std::printf("lookup: DataManager::findRecord\n");
+    std::printf("  %8s  %14s  %14s\n", "records", "resident ns", "any day ns");
+    const size_t counts[] = { 10, 100, 1000, 10000, 100000 };
+    std::mt19937 random(1);
+    for (size_t count : counts) {
+        DataFiles files = scratchFiles("lookup");
+        writeTextData(files.text, count, 3);
+        double resident = 0, anyDay = 0;
+        {
+            DataManager data(files);
+            data.loadData();
+            Date first = Date::fromCivil(2000, 1, 1);
+            size_t hot = std::min<size_t>(count, 256);
+            std::vector<Date> hotDays, randomDays;
+            for (size_t i = 0; i < hot; i++)
+                hotDays.push_back(first + static_cast<int32_t>(count - hot + i));
+            for (Date date : hotDays)
+                data.findRecord(date);
+            for (size_t i = 0; i < 4096; i++)
+                hotDays.push_back(hotDays[random() % hot]);
+            for (size_t i = 0; i < 100000; i++)
+                randomDays.push_back(first + static_cast<int32_t>(random() % count));
+
+            const size_t rounds = 250;
+            auto start = std::chrono::steady_clock::now();
+            uint64_t sum = 0;
+            for (size_t r = 0; r < rounds; r++) {
+                for (Date date : hotDays)
+                    sum += data.findRecord(date).foodCount();
+            }
+            resident = secondsSince(start) * 1e9 / (rounds * hotDays.size());
+            start = std::chrono::steady_clock::now();
+            for (Date date : randomDays)
+                sum += data.findRecord(date).foodCount();
+            anyDay = secondsSince(start) * 1e9 / randomDays.size();
+            benchSink = sum;
+        }
+        removeFiles(files);
+        std::printf("  %8zu  %14.1f  %14.1f\n", count, resident, anyDay);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: readFile
+// Purpose: Whole file contents, for comparing exports.
+// -----------------------------------------------------------------------------
+static std::string readFile(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark: parser
+// Purpose: loadData on a 1M-line text file with each loader. Everything after
+//          the parse (aggregate, snapshot, conversion to the binary file) is
+//          the same for all of them, so the differences are the parsers'.
+//          The data each loader built is exported and compared.
+// -----------------------------------------------------------------------------
+static bool benchParser() {
+    std::printf("parser: DataManager::loadData from text\n");
+    DataFiles source = scratchFiles("parser_source");
+    size_t lines = writeTextData(source.text, 250000, 3);
+    std::printf("  %zu lines, %.1f MB\n", lines, fs::file_size(source.text) / 1e6);
+    const struct { LoaderType type; const char *name; } loaders[] = {
+        { LOADER_STREAM, "stream" }, { LOADER_MAPPED, "mmap" }, { LOADER_PARALLEL, "parallel" }
+    };
+    std::string reference;
+    bool same = true;
+    for (const auto &loader : loaders) {
+        DataFiles files = scratchFiles("parser");
+        fs::copy_file(source.text, files.text);
+        double seconds = 0;
+        std::string exported;
+        {
+            DataManager data(files);
+            data.setLoader(loader.type);
+            auto start = std::chrono::steady_clock::now();
+            data.loadData();
+            seconds = secondsSince(start);
+            data.exportText(files.text + ".out");
+            exported = readFile(files.text + ".out");
+            fs::remove(files.text + ".out");
+        }
+        removeFiles(files);
+        if (reference.empty())
+            reference = exported;
+        same = same && exported == reference;
+        std::printf("  %-8s  %8.1f ms  %s\n", loader.name, seconds * 1e3,
+                    exported == reference ? "same data" : "DIFFERENT DATA");
+    }
+    removeFiles(source);
+    return same;
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark: threads
+// Purpose: LOADER_PARALLEL on a 1M-line text file with 1 to N threads, N being
+//          at least 8 or the hardware thread count if higher. Reports the
+//          parallel parse on its own and the whole loadData, which adds the
+//          merge, the aggregate, the first snapshot and the binary save, each
+//          as the median of three runs and as a speedup over one thread.
+//          Threads beyond the hardware thread count share cores, so they
+//          show the splitting overhead, not a speedup. Fails if any thread
+//          count builds different data.
+// -----------------------------------------------------------------------------
+static bool benchThreads() {
+    size_t hardware = std::thread::hardware_concurrency();
+    std::printf("threads: LOADER_PARALLEL by thread count, %zu hardware thread%s\n", hardware,
+                hardware == 1 ? "" : "s");
+    DataFiles source = scratchFiles("threads_source");
+    size_t lines = writeTextData(source.text, 250000, 3);
+    std::printf("  %zu lines, %.1f MB\n", lines, fs::file_size(source.text) / 1e6);
+    std::vector<size_t> counts = { 1, 2, 4, 8 };
+    if (hardware > 8)
+        counts.push_back(hardware);
+    const int ROUNDS = 3;
+    std::printf("  %7s  %10s  %8s  %10s  %8s\n", "threads", "parse ms", "speedup", "load ms", "speedup");
+    std::string reference;
+    double parseOne = 0, loadOne = 0;
+    bool same = true;
+    for (size_t threads : counts) {
+        std::vector<double> parseTimes, loadTimes;
+        std::string exported;
+        for (int round = 0; round < ROUNDS; round++) {
+            {
+                MappedFile file;
+                file.open(source.text);
+                std::vector<TextChunk> chunks;
+                auto start = std::chrono::steady_clock::now();
+                parseTextParallel(file.view(), chunks, threads);
+                parseTimes.push_back(secondsSince(start));
+                benchSink = chunks.size();
+            }
+            DataFiles files = scratchFiles("threads");
+            fs::copy_file(source.text, files.text);
+            {
+                DataManager data(files);
+                data.setLoaderThreads(threads);
+                auto start = std::chrono::steady_clock::now();
+                data.loadData();
+                loadTimes.push_back(secondsSince(start));
+                if (round == 0) {
+                    data.exportText(files.text + ".out");
+                    exported = readFile(files.text + ".out");
+                    fs::remove(files.text + ".out");
+                }
+            }
+            removeFiles(files);
+        }
+        std::sort(parseTimes.begin(), parseTimes.end());
+        std::sort(loadTimes.begin(), loadTimes.end());
+        double parse = parseTimes[ROUNDS / 2], load = loadTimes[ROUNDS / 2];
+        if (threads == 1) {
+            parseOne = parse;
+            loadOne = load;
+            reference = exported;
+        }
+        same = same && exported == reference;
+        std::printf("  %7zu  %10.1f  %7.2fx  %10.1f  %7.2fx  %s\n", threads, parse * 1e3, parseOne / parse, load * 1e3,
+                    loadOne / load, exported == reference ? "same data" : "DIFFERENT DATA");
+    }
+    removeFiles(source);
+    return same;
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark: formats
+// Purpose: The same 1M-line history as the text file and as the binary file:
+//          size on disk, loadData time, and loadData plus the history totals,
+//          which read every day. The text load converts to the binary file,
+//          so its time includes that save, as on the first run after an
+//          update. Times are the median of three runs. Fails if the binary
+//          file is larger or slower to load, or holds different data.
+// -----------------------------------------------------------------------------
+static bool benchFormats() {
+    std::printf("formats: text vs binary data file\n");
+    DataFiles source = scratchFiles("formats_source");
+    size_t lines = writeTextData(source.text, 250000, 3);
+    const int ROUNDS = 3;
+    std::vector<double> textLoad, textTotals, binaryLoad, binaryTotals;
+    std::string textExport, binaryExport;
+    uintmax_t textSize = fs::file_size(source.text), binarySize = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        DataFiles files = scratchFiles("formats");
+        fs::copy_file(source.text, files.text);
+        {
+            DataManager data(files);
+            auto start = std::chrono::steady_clock::now();
+            data.loadData();
+            textLoad.push_back(secondsSince(start));
+            benchSink = static_cast<uint64_t>(data.summarizeHistory().values[0]);
+            textTotals.push_back(secondsSince(start));
+            if (round == 0) {
+                data.exportText(files.text + ".out");
+                textExport = readFile(files.text + ".out");
+            }
+        }
+        binarySize = fs::file_size(files.binary);
+        {
+            DataManager data(files);
+            auto start = std::chrono::steady_clock::now();
+            data.loadData();
+            binaryLoad.push_back(secondsSince(start));
+            benchSink = static_cast<uint64_t>(data.summarizeHistory().values[0]);
+            binaryTotals.push_back(secondsSince(start));
+            if (round == 0) {
+                data.exportText(files.text + ".out");
+                binaryExport = readFile(files.text + ".out");
+            }
+        }
+        fs::remove(files.text + ".out");
+        removeFiles(files);
+    }
+    removeFiles(source);
+    for (std::vector<double> *times : { &textLoad, &textTotals, &binaryLoad, &binaryTotals })
+        std::sort(times->begin(), times->end());
+    std::printf("  %zu lines\n", lines);
+    std::printf("  %-7s  %8s  %10s  %12s\n", "format", "MB", "load ms", "+ totals ms");
+    std::printf("  %-7s  %8.1f  %10.1f  %12.1f\n", "text", textSize / 1e6, textLoad[ROUNDS / 2] * 1e3,
+                textTotals[ROUNDS / 2] * 1e3);
+    std::printf("  %-7s  %8.1f  %10.1f  %12.1f\n", "binary", binarySize / 1e6, binaryLoad[ROUNDS / 2] * 1e3,
+                binaryTotals[ROUNDS / 2] * 1e3);
+    bool same = !textExport.empty() && textExport == binaryExport;
+    std::printf("  %s\n", same ? "same data" : "DIFFERENT DATA");
+    return same && binarySize <= textSize && binaryTotals[ROUNDS / 2] < textLoad[ROUNDS / 2];
+}
+
+// -----------------------------------------------------------------------------
+// Helper: writeTemplateLibrary
+// Purpose: A template library file of 'count' templates with distinct names.
+// -----------------------------------------------------------------------------
+static void writeTemplateLibrary(const std::string &path, size_t count) {
+    // Brand word + preparation + one of 48 foods, so every name is distinct
+    // and a food word matches about 2% of the library.
+    static const char *const foods[] = {
+        "Apple", "Banana", "Orange", "Pear", "Grapes", "Mango", "Pineapple", "Strawberries",
+        "Chicken Breast", "Chicken Thigh", "Beef Steak", "Pork Chop", "Lamb", "Turkey", "Duck", "Ham",
+        "Salmon", "Tuna", "Cod", "Shrimp", "Sardines", "Trout", "Mackerel", "Crab",
+        "Brown Rice", "White Rice", "Pasta", "Bread", "Oatmeal", "Quinoa", "Couscous", "Bagel",
+        "Broccoli", "Spinach", "Carrots", "Peas", "Potato", "Sweet Potato", "Corn", "Tomato",
+        "Greek Yogurt", "Milk", "Cheddar", "Mozzarella", "Eggs", "Butter", "Almonds", "Peanuts"
+    };
+    static const char *const preparations[] = { "Grilled", "Baked", "Raw", "Smoked", "Fried", "Steamed",
+                                                "Roasted", "Boiled", "Spicy", "Sweet" };
+    static const char *const syllables[] = { "ka", "lo", "mi", "ne", "ru", "sa", "ti", "vo", "ze", "po",
+                                             "da", "fi", "gu", "be", "xo", "qui" };
+    std::ofstream out(path, std::ios::binary);
+    for (size_t i = 0; i < count; i++) {
+        std::string brand;
+        for (size_t n = i, s = 0; s < 5; s++, n /= 16)
+            brand += syllables[n % 16];
+        brand[0] = static_cast<char>(brand[0] - 'a' + 'A');
+        out << "TPL: " << brand << ' ' << preparations[(i * 7) % 10] << ' ' << foods[(i * 13) % 48] << '|'
+            << 50 + i % 700 << '|' << i % 90 << '|' << i % 45 << '|' << i % 30 << "|100\n";
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark: templates
+// Purpose: TemplateIndex::search per keystroke over 500k templates, typing
+//          "Chicken Bre" one character at a time as the template popup does,
+//          then again with a typo, asking for one page of results. The first
+//          search builds the index and is reported on its own. Fails if the
+//          median time of any keystroke reaches 1 ms.
+// -----------------------------------------------------------------------------
+static bool benchTemplates() {
+    std::printf("templates: TemplateIndex::search per keystroke, 500k templates\n");
+    fs::path path = fs::temp_directory_path() / "calorie_bench" / "templates.txt";
+    fs::create_directories(path.parent_path());
+    writeTemplateLibrary(path.string(), 500000);
+    TemplateStore store(path.string());
+    store.ensureLoaded();
+    TemplateIndex index;
+    auto start = std::chrono::steady_clock::now();
+    index.search(store, "", TEMPLATE_PAGE);
+    std::printf("  index build   %8.1f ms\n", secondsSince(start) * 1e3);
+
+    // Typed straight, and with a transposition that leaves no exact match.
+    // Each keystroke is timed over several rounds and judged by its median,
+    // so a round the scheduler interrupts does not decide the result.
+    const char *const typedTerms[] = { "Chicken Bre", "Chikcen Bre" };
+    const int ROUNDS = 7;
+    double slowest = 0, worst = 0;
+    for (const char *typed : typedTerms) {
+        std::string text = typed;
+        std::vector<std::vector<double>> times(text.size() + 1);
+        std::vector<size_t> found(text.size() + 1), shown(text.size() + 1);
+        std::vector<bool> complete(text.size() + 1);
+        for (int round = 0; round < ROUNDS; round++) {
+            index.search(store, "", TEMPLATE_PAGE);
+            for (size_t length = 1; length <= text.size(); length++) {
+                start = std::chrono::steady_clock::now();
+                shown[length] = index.search(store, text.substr(0, length), TEMPLATE_PAGE).size();
+                times[length].push_back(secondsSince(start));
+                found[length] = index.matchCount();
+                complete[length] = index.complete();
+            }
+            // Backspacing back to the start reuses every prefix's matches.
+            for (size_t length = text.size(); length-- > 0;) {
+                start = std::chrono::steady_clock::now();
+                index.search(store, text.substr(0, length), TEMPLATE_PAGE);
+                times[length].push_back(secondsSince(start));
+            }
+        }
+        for (size_t length = 1; length <= text.size(); length++) {
+            std::vector<double> &keystroke = times[length];
+            std::sort(keystroke.begin(), keystroke.end());
+            double median = keystroke[keystroke.size() / 2];
+            slowest = std::max(slowest, median);
+            worst = std::max(worst, keystroke.back());
+            std::printf("  %-14s  %8.3f ms  %zu found, %zu ranked%s\n", ("\"" + text.substr(0, length) + "\"").c_str(),
+                        median * 1e3, found[length], shown[length], complete[length] ? ", all" : "");
+        }
+    }
+    bool fast = slowest < 1e-3;
+    std::printf("  slowest keystroke (median of %d)  %.3f ms: %s\n", ROUNDS, slowest * 1e3,
+                fast ? "within 1 ms" : "OVER THE 1 ms LIMIT");
+    std::printf("  worst single run  %.3f ms\n", worst * 1e3);
+    fs::remove(path);
+    return fast;
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark: ranges
+// Purpose: summarizeRange over 20 years of data (7305 days, 0-5 entries a
+//          day) against a loop of findRecord over the same days, plus a
+//          check of random ranges against per-day sums kept by the
+//          benchmark, before and after random edits and after an entry on
+//          01/01/0001 far from the rest.
+// -----------------------------------------------------------------------------
+static bool benchRanges() {
+    std::printf("ranges: DataManager::summarizeRange over 20 years\n");
+    const int32_t dayCount = 7305;
+    const Date first = Date::fromCivil(2005, 1, 1);
+    std::mt19937 random(7);
+    std::vector<int64_t> calories(dayCount, 0);
+    int wrong = 0;
+    DataFiles files = scratchFiles("ranges");
+    {
+        std::ofstream out(files.text, std::ios::binary);
+        out << "DAILY_GOALS: 2000,250,150,70\n";
+        for (int32_t d = 0; d < dayCount; d++) {
+            out << "DATE: " << (first + d).toString() << '\n';
+            for (unsigned f = random() % 6; f > 0; f--) {
+                int value = 50 + static_cast<int>(random() % 700);
+                calories[d] += value;
+                out << "FOOD: " << BENCH_FOODS[random() % BENCH_FOOD_COUNT] << '|' << value << "|10|5|3|100\n";
+            }
+        }
+    }
+    {
+        DataManager data(files);
+        data.loadData();
+        std::vector<std::pair<int32_t, int32_t>> ranges(1000000);
+        for (auto &range : ranges) {
+            int32_t a = static_cast<int32_t>(random() % dayCount), b = static_cast<int32_t>(random() % dayCount);
+            range = std::make_pair(std::min(a, b), std::max(a, b));
+        }
+        // Checks 400 random ranges against the per-day sums.
+        auto check = [&]() {
+            int failures = 0;
+            for (size_t i = 0; i < 400; i++) {
+                int64_t expected = 0;
+                for (int32_t d = ranges[i].first; d <= ranges[i].second; d++)
+                    expected += calories[d];
+                if (data.summarizeRange(first + ranges[i].first, first + ranges[i].second).totals.calories != expected)
+                    failures++;
+            }
+            return failures;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        int64_t sum = 0;
+        for (const auto &range : ranges)
+            sum += data.summarizeRange(first + range.first, first + range.second).totals.calories;
+        double tree = secondsSince(start) * 1e9 / ranges.size();
+        start = std::chrono::steady_clock::now();
+        const size_t naiveQueries = 200;
+        for (size_t i = 0; i < naiveQueries; i++) {
+            for (int32_t d = ranges[i].first; d <= ranges[i].second; d++)
+                sum += data.findRecord(first + d).totals.calories;
+        }
+        double naive = secondsSince(start) * 1e9 / naiveQueries;
+        benchSink = static_cast<uint64_t>(sum);
+        std::printf("  Fenwick tree      %10.1f ns/query\n", tree);
+        std::printf("  findRecord loop   %10.1f ns/query\n", naive);
+        wrong = check();
+        std::printf("  check after load: %d of 400 ranges wrong\n", wrong);
+
+        for (int edit = 0; edit < 1000; edit++) {
+            int32_t d = static_cast<int32_t>(random() % dayCount);
+            Date date = first + d;
+            size_t count = data.findRecord(date).foodCount();
+            if (count > 0 && random() % 2) {
+                calories[d] -= data.findRecord(date).foods()[0].calories;
+                data.removeFood(date, 0);
+            } else {
+                int value = 50 + static_cast<int>(random() % 700);
+                calories[d] += value;
+                data.addFood(date, Food("Edit", value, 10, 5, 3, 100));
+            }
+        }
+        int wrongAfterEdits = check();
+        wrong += wrongAfterEdits;
+        std::printf("  check after 1000 edits: %d of 400 ranges wrong\n", wrongAfterEdits);
+
+        data.addFood(Date::fromCivil(1, 1, 1), Food("Outlier", 100, 1, 1, 1, 1));
+        start = std::chrono::steady_clock::now();
+        for (const auto &range : ranges)
+            sum += data.summarizeRange(first + range.first, first + range.second).totals.calories;
+        tree = secondsSince(start) * 1e9 / ranges.size();
+        benchSink = static_cast<uint64_t>(sum);
+        RangeSummary all = data.summarizeRange(Date::fromCivil(1, 1, 1), first + (dayCount - 1));
+        int wrongWithOutlier = check();
+        wrong += wrongWithOutlier;
+        std::printf("  with an entry on 01/01/0001: %.1f ns/query, %lld logged days, %d of 400 ranges wrong\n",
+                    tree, static_cast<long long>(all.totals.loggedDays), wrongWithOutlier);
+    }
+    removeFiles(files);
+    return wrong == 0;
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark: kernels
+// Purpose: FoodColumns::sumLive with each column sum kernel over 16k, 64k
+//          and 10M entries. The small stores fit in cache; 10M entries
+//          (200 MB of columns) measure memory bandwidth.
+// -----------------------------------------------------------------------------
+static bool benchKernels() {
+    std::printf("kernels: FoodColumns::sumLive, ns per entry (all five columns)\n");
+    const SumKernel kernels[] = { SUM_KERNEL_SCALAR, SUM_KERNEL_SSE2, SUM_KERNEL_AVX2 };
+    std::printf("  %10s", "entries");
+    for (SumKernel kernel : kernels)
+        std::printf("  %8s", sumKernelSupported(kernel) ? sumKernelName(kernel) : "(n/a)");
+    std::printf("\n");
+    const size_t counts[] = { 16384, 65536, 10000000 };
+    std::mt19937 random(3);
+    for (size_t count : counts) {
+        FoodColumns columns;
+        Food food;
+        for (size_t i = 0; i < count; i++) {
+            food.calories = static_cast<int>(random() % 1000);
+            food.carbs = static_cast<int>(random() % 100);
+            food.protein = static_cast<int>(random() % 60);
+            food.fat = static_cast<int>(random() % 40);
+            food.grams = static_cast<int>(random() % 500);
+            columns.append(food);
+        }
+        size_t rounds = std::max<size_t>(1, 200000000 / count);
+        std::printf("  %10zu", count);
+        for (SumKernel kernel : kernels) {
+            auto start = std::chrono::steady_clock::now();
+            int64_t sum = 0;
+            for (size_t r = 0; r < rounds; r++)
+                sum += columns.sumLive(kernel).values[COLUMN_CALORIES];
+            benchSink = static_cast<uint64_t>(sum);
+            std::printf("  %8.3f", secondsSince(start) * 1e9 / (static_cast<double>(rounds) * count));
+        }
+        std::printf("\n");
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark: profiles
+// Purpose: ProfileRegistry::open latency with PROFILE_CACHE_SIZE profiles
+//          loaded. Three times as many profiles of 730 days x 8 entries are
+//          opened in turn, so every switch loads one from its data file and
+//          unloads the least recently used, queueing the save of the entry
+//          added to it while it was open. A 182k-day profile is then opened
+//          and switched away from the same way. Only switches to profiles
+//          not in memory count as "not loaded". Reports medians and the
+//          slowest switch; fails if any median reaches 10 ms.
+// -----------------------------------------------------------------------------
+static bool benchProfiles() {
+    std::printf("profiles: ProfileRegistry::open, %zu profiles in memory\n", PROFILE_CACHE_SIZE);
+    // Profile files are named relative to the working directory.
+    fs::path directory = fs::temp_directory_path() / "calorie_bench" / "profiles";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    fs::path previousDirectory = fs::current_path();
+    fs::current_path(directory);
+
+    bool fast = true;
+    {
+        // Unloaded profiles stay in memory while they save, up to
+        // PROFILE_CACHE_SIZE of them, so a profile opened again after this
+        // many others is read from its file.
+        const size_t PROFILE_COUNT = 3 * PROFILE_CACHE_SIZE;
+        std::vector<std::string> names;
+        for (size_t p = 0; p < PROFILE_COUNT; p++)
+            names.push_back("user" + std::to_string(p));
+        ProfileRegistry registry(PROFILE_LIST_FILE, PROFILE_CACHE_SIZE);
+        registry.load();
+        for (const std::string &name : names) {
+            registry.add(name);
+            writeTextData(DataFiles::forProfile(name).text, 730, 8);
+        }
+        registry.add("large");
+        writeTextData(DataFiles::forProfile("large").text, 182000, 3);
+        // The first load converts the text file; later ones read the data file.
+        for (const std::string &name : names)
+            DataManager(DataFiles::forProfile(name)).loadData();
+        DataManager(DataFiles::forProfile("large")).loadData();
+
+        // Each switch opens a profile and logs one entry to it, so the switch
+        // that later unloads it has a change to save.
+        const Food entry("Apple", 95, 25, 0, 0, 180);
+        const Date today = Date::fromCivil(2001, 12, 31);
+        auto switchTo = [&](const std::string &name, std::vector<double> *coldTimes) {
+            bool loaded = registry.isLoaded(name);
+            auto start = std::chrono::steady_clock::now();
+            DataManager &data = registry.open(name);
+            double seconds = secondsSince(start);
+            data.addFood(today, entry);
+            if (coldTimes && !loaded)
+                coldTimes->push_back(seconds);
+            return seconds;
+        };
+        auto median = [](std::vector<double> times) {
+            std::sort(times.begin(), times.end());
+            return times[times.size() / 2];
+        };
+
+        for (size_t p = 0; p < PROFILE_CACHE_SIZE; p++)
+            switchTo(names[p], nullptr);
+        std::vector<double> cold, hot, largeOpen, largeLeave;
+        size_t next = PROFILE_CACHE_SIZE;
+        for (size_t i = 0; i < 3 * PROFILE_COUNT; i++)
+            switchTo(names[next++ % PROFILE_COUNT], &cold);
+        for (size_t i = 0; i < 1000; i++) {
+            auto start = std::chrono::steady_clock::now();
+            benchSink = reinterpret_cast<uintptr_t>(&registry.open(names[PROFILE_COUNT - 1 - i % 2]));
+            hot.push_back(secondsSince(start));
+        }
+        for (int round = 0; round < 5; round++) {
+            switchTo("large", &largeOpen);
+            // The switch that unloads the large profile queues its save; the
+            // ones after it let it go before the next round.
+            for (size_t p = 0; p < PROFILE_CACHE_SIZE - 1; p++)
+                switchTo(names[next++ % PROFILE_COUNT], nullptr);
+            largeLeave.push_back(switchTo(names[next++ % PROFILE_COUNT], nullptr));
+            for (size_t p = 0; p < 2 * PROFILE_CACHE_SIZE; p++)
+                switchTo(names[next++ % PROFILE_COUNT], nullptr);
+        }
+
+        struct Row { const char *what; const std::vector<double> &times; };
+        const Row rows[] = { { "not loaded, 730 days", cold },
+                             { "not loaded, 182k days", largeOpen },
+                             { "unloading 182k days", largeLeave } };
+        std::printf("  %-24s  %10.4f ms\n", "already loaded", median(hot) * 1e3);
+        fast = true;
+        for (const Row &row : rows) {
+            if (row.times.empty()) {
+                std::printf("  %-24s  NOT MEASURED\n", row.what);
+                fast = false;
+                continue;
+            }
+            double typical = median(row.times);
+            fast = fast && typical < 10e-3;
+            std::printf("  %-24s  %10.3f ms  slowest %8.3f ms  (%zu switches)\n", row.what, typical * 1e3,
+                        *std::max_element(row.times.begin(), row.times.end()) * 1e3, row.times.size());
+        }
+        std::printf("  %s\n", fast ? "every median within 10 ms" : "A MEDIAN IS OVER THE 10 ms TARGET");
+    }  // The registry saves the loaded profiles here, before leaving the directory.
+    fs::current_path(previousDirectory);
+    fs::remove_all(directory);
+    return fast;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: residentMemory
+// Purpose: Current and peak resident set size of this process in bytes, from
+//          /proc/self/status. False where that file does not exist.
+// -----------------------------------------------------------------------------
+static bool residentMemory(size_t &current, size_t &peak) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    current = peak = 0;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+            current = std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+        else if (line.compare(0, 6, "VmHWM:") == 0)
+            peak = std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+    }
+    return current != 0;
+}
+
+// Hands memory the allocator keeps from freed blocks back to the system and
+// restarts the peak reported by residentMemory at the current size.
+static void settleMemory() {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark: memory
+// Purpose: Resident memory taken by a binary load of a 1M-entry history and by
+//          500k templates with distinct names, as the growth of this
+//          process's resident set, plus the peak while loading. Freed memory
+//          is handed back first where the C library allows it; elsewhere the
+//          numbers are only clean in a run of "calorie_bench memory" on its
+//          own. Fails if Food grows past its 24 bytes.
+// -----------------------------------------------------------------------------
+static bool benchMemory() {
+    std::printf("memory: resident set growth, sizeof(Food) = %zu\n", sizeof(Food));
+    DataFiles files = scratchFiles("memory");
+    writeTextData(files.text, 250000, 4);
+    {
+        DataManager convert(files);
+        convert.loadData();  // Writes the binary file the measured load reads
+    }
+    fs::path templatePath = fs::temp_directory_path() / "calorie_bench" / "memory_templates.txt";
+    writeTemplateLibrary(templatePath.string(), 500000);
+
+    size_t base = 0, basePeak = 0;
+    settleMemory();
+    if (!residentMemory(base, basePeak)) {
+        std::printf("  resident memory is not available on this platform\n");
+        removeFiles(files);
+        fs::remove(templatePath);
+        return sizeof(Food) <= 24;
+    }
+    NamePool &pool = NamePool::instance();
+    size_t namesBefore = pool.size(), arenaBefore = pool.arenaBytes();
+    size_t afterHistory = 0, historyPeak = 0, afterTemplates = 0, templatesPeak = 0;
+    {
+        settleMemory();
+        DataManager data(files);
+        data.loadData();
+        residentMemory(afterHistory, historyPeak);
+        settleMemory();
+        TemplateStore store(templatePath.string());
+        store.ensureLoaded();
+        residentMemory(afterTemplates, templatesPeak);
+        benchSink = data.findRecord(Date::fromCivil(2000, 1, 1)).foodCount() + store.all().size();
+    }
+    std::printf("  %-36s  %8.1f MB  peak %8.1f MB\n", "1M-entry history, binary load", (afterHistory - base) / 1e6,
+                (std::max(historyPeak, base) - base) / 1e6);
+    std::printf("  %-36s  %8.1f MB  peak %8.1f MB\n", "500k templates, distinct names",
+                (afterTemplates - afterHistory) / 1e6, (std::max(templatesPeak, afterHistory) - afterHistory) / 1e6);
+    std::printf("  name pool: %zu new names, %.1f MB of arena\n", pool.size() - namesBefore,
+                (pool.arenaBytes() - arenaBefore) / 1e6);
+    removeFiles(files);
+    fs::remove(templatePath);
+    return sizeof(Food) <= 24;
+}
+
+// -----------------------------------------------------------------------------
+// Structure: Benchmark
+// Purpose: Name on the command line and the function that runs it, which
+//          returns false if a result is wrong or misses its target.
+// -----------------------------------------------------------------------------
+struct Benchmark {
+    const char *name;
+    bool (*run)();
+};
+
+static const Benchmark BENCHMARKS[] = {
+    { "lookup", benchLookup },
+    { "parser", benchParser },
+    { "threads", benchThreads },
+    { "formats", benchFormats },
+    { "templates", benchTemplates },
+    { "ranges", benchRanges },
+    { "profiles", benchProfiles },
+    { "kernels", benchKernels },
+    { "memory", benchMemory },
+};
+
+int main(int argc, char *argv[]) {
+    bool ranAny = false, passed = true;
+    for (const Benchmark &benchmark : BENCHMARKS) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) {
+            if (std::string(argv[i]) == benchmark.name)
+                selected = true;
+        }
+        if (!selected)
+            continue;
+        passed = benchmark.run() && passed;
+        ranAny = true;
+    }
+    if (!ranAny) {
+        std::fprintf(stderr, "Unknown benchmark. Available:");
+        for (const Benchmark &benchmark : BENCHMARKS)
+            std::fprintf(stderr, " %s", benchmark.name);
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+    return passed ? 0 : 1;
+}
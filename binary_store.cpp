@@ -0,0 +1,351 @@
+#include "binary_store.h"
+#include <unordered_map>
+#include <deque>
+#include <cstring>
+#include <limits>
+
+// Sizes of the fixed-width sections described in binary_store.h.
+static const size_t HEADER_SIZE = 40;
+static const size_t DAY_ENTRY_SIZE = 32;
+static const size_t DAY_ENTRY_SIZE_V1 = 12;
+static const size_t FOOD_RECORD_SIZE = 24;
+
+// BinaryStoreReader::poolIds entry whose name has not been interned yet.
+static const uint32_t UNRESOLVED_NAME = 0xFFFFFFFFu;
+
+// -----------------------------------------------------------------------------
+// Helpers: little-endian encoding
+// Purpose: Read and write fixed-width integers independent of host byte order.
+// -----------------------------------------------------------------------------
+static uint32_t readU32(const unsigned char *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static uint16_t readU16(const unsigned char *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static void putU32(std::vector<unsigned char> &out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 24));
+}
+
+static void putU16(std::vector<unsigned char> &out, uint16_t value) {
+    out.push_back(static_cast<unsigned char>(value));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+}
+
+static void storeU32(unsigned char *p, uint32_t value) {
+    p[0] = static_cast<unsigned char>(value);
+    p[1] = static_cast<unsigned char>(value >> 8);
+    p[2] = static_cast<unsigned char>(value >> 16);
+    p[3] = static_cast<unsigned char>(value >> 24);
+}
+
+// -----------------------------------------------------------------------------
+// Helper: clampSum
+// Purpose: Day sums are added up in 64 bits, since the int32 values of a day
+//          can overflow an int; a sum beyond the int32 range is stored as
+//          the nearest end of it.
+// -----------------------------------------------------------------------------
+static int32_t clampSum(int64_t sum) {
+    if (sum > std::numeric_limits<int32_t>::max())
+        return std::numeric_limits<int32_t>::max();
+    if (sum < std::numeric_limits<int32_t>::min())
+        return std::numeric_limits<int32_t>::min();
+    return static_cast<int32_t>(sum);
+}
+
+// -----------------------------------------------------------------------------
+// Constructor: BinaryStoreReader
+// Purpose: Start with no file open.
+// -----------------------------------------------------------------------------
+BinaryStoreReader::BinaryStoreReader()
+    : base(nullptr), version(0), dayEntrySize(DAY_ENTRY_SIZE), goals{ 0, 0, 0, 0 }, saveGeneration(0), days(0), foods(0), strings(0),
+      foodOffset(0), stringOffset(0), stringDataOffset(0) {
+}
+
+// -----------------------------------------------------------------------------
+// Method: open
+// Purpose: Maps the file and checks the magic number, version and that every
+//          section fits inside the file before any of it is decoded. A file
+//          that fails any check leaves the reader closed.
+// -----------------------------------------------------------------------------
+bool BinaryStoreReader::open(const std::string &path) {
+    close();
+#ifdef _WIN32
+    // Windows refuses to rename over a mapped file, and snapshots keep old
+    // versions of the data file open across saves (see DayStore).
+    if (!file.read(path))
+        return false;
+#else
+    if (!file.open(path))
+        return false;
+#endif
+    std::string_view bytes = file.view();
+    if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), BINARY_STORE_MAGIC, 4) != 0) {
+        close();
+        return false;
+    }
+    base = reinterpret_cast<const unsigned char *>(bytes.data());
+    version = readU16(base + 4);
+    if (version != 1 && version != BINARY_STORE_VERSION) {
+        close();
+        return false;
+    }
+    dayEntrySize = version == 1 ? DAY_ENTRY_SIZE_V1 : DAY_ENTRY_SIZE;
+    saveGeneration = readU16(base + 6);
+    for (int i = 0; i < 4; i++)
+        goals[i] = static_cast<int32_t>(readU32(base + 8 + i * 4));
+    days = readU32(base + 24);
+    foods = readU32(base + 28);
+    strings = readU32(base + 32);
+    uint64_t stringBytes = readU32(base + 36);
+
+    // Compute section offsets in 64 bits so a corrupt count cannot wrap around.
+    uint64_t foodStart = HEADER_SIZE + static_cast<uint64_t>(days) * dayEntrySize;
+    uint64_t stringStart = foodStart + static_cast<uint64_t>(foods) * FOOD_RECORD_SIZE;
+    uint64_t dataStart = stringStart + (static_cast<uint64_t>(strings) + 1) * 4;
+    if (dataStart + stringBytes > bytes.size()) {
+        close();
+        return false;
+    }
+    foodOffset = static_cast<size_t>(foodStart);
+    stringOffset = static_cast<size_t>(stringStart);
+    stringDataOffset = static_cast<size_t>(dataStart);
+    if (readU32(base + stringOffset + static_cast<size_t>(strings) * 4) != stringBytes) {
+        close();
+        return false;
+    }
+    // The offset table fits in the file, so this is bounded by the file size.
+    poolIds.assign(strings, UNRESOLVED_NAME);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: close
+// Purpose: Unmaps the file and forgets its header.
+// -----------------------------------------------------------------------------
+void BinaryStoreReader::close() {
+    file.close();
+    base = nullptr;
+    version = 0;
+    days = foods = strings = 0;
+    poolIds.clear();
+}
+
+// -----------------------------------------------------------------------------
+// Method: goal
+// Purpose: Returns one of the four goals stored in the header.
+// -----------------------------------------------------------------------------
+int BinaryStoreReader::goal(int index) const {
+    return goals[index];
+}
+
+// -----------------------------------------------------------------------------
+// Method: dayAt
+// Purpose: Decodes the day index entry at 'index'. Version 1 entries get
+//          their sums from a pass over the day's records, clamped like the
+//          sums the writer stores.
+// -----------------------------------------------------------------------------
+BinaryDayEntry BinaryStoreReader::dayAt(uint32_t index) const {
+    const unsigned char *p = base + HEADER_SIZE + static_cast<size_t>(index) * dayEntrySize;
+    BinaryDayEntry entry;
+    entry.dateKey = readU32(p);
+    entry.firstFood = readU32(p + 4);
+    entry.foodCount = readU32(p + 8);
+    if (hasDayTotals()) {
+        entry.calories = static_cast<int32_t>(readU32(p + 12));
+        entry.carbs = static_cast<int32_t>(readU32(p + 16));
+        entry.protein = static_cast<int32_t>(readU32(p + 20));
+        entry.fat = static_cast<int32_t>(readU32(p + 24));
+        entry.grams = static_cast<int32_t>(readU32(p + 28));
+        return entry;
+    }
+    entry.calories = entry.carbs = entry.protein = entry.fat = entry.grams = 0;
+    if (static_cast<uint64_t>(entry.firstFood) + entry.foodCount > foods)
+        return entry;
+    int64_t sums[5] = { 0, 0, 0, 0, 0 };
+    Food food;
+    for (uint32_t f = 0; f < entry.foodCount; f++) {
+        foodValuesAt(entry.firstFood + f, food);
+        sums[0] += food.calories;
+        sums[1] += food.carbs;
+        sums[2] += food.protein;
+        sums[3] += food.fat;
+        sums[4] += food.grams;
+    }
+    entry.calories = clampSum(sums[0]);
+    entry.carbs = clampSum(sums[1]);
+    entry.protein = clampSum(sums[2]);
+    entry.fat = clampSum(sums[3]);
+    entry.grams = clampSum(sums[4]);
+    return entry;
+}
+
+// -----------------------------------------------------------------------------
+// Method: findDay
+// Purpose: Locates a date in the sorted day index without scanning the file.
+// -----------------------------------------------------------------------------
+bool BinaryStoreReader::findDay(uint32_t dateKey, BinaryDayEntry &entry) const {
+    uint32_t low = 0, high = days;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        uint32_t key = readU32(base + HEADER_SIZE + static_cast<size_t>(mid) * dayEntrySize);
+        if (key < dateKey)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == days)
+        return false;
+    entry = dayAt(low);
+    return entry.dateKey == dateKey;
+}
+
+// -----------------------------------------------------------------------------
+// Method: nameText
+// Purpose: Bounds-checked lookup in the string table.
+// -----------------------------------------------------------------------------
+std::string_view BinaryStoreReader::nameText(uint32_t nameId) const {
+    if (nameId >= strings)
+        return std::string_view();
+    uint32_t start = readU32(base + stringOffset + static_cast<size_t>(nameId) * 4);
+    uint32_t end = readU32(base + stringOffset + static_cast<size_t>(nameId) * 4 + 4);
+    if (start > end || end > readU32(base + stringOffset + static_cast<size_t>(strings) * 4))
+        return std::string_view();
+    return std::string_view(reinterpret_cast<const char *>(base + stringDataOffset + start), end - start);
+}
+
+// -----------------------------------------------------------------------------
+// Method: foodValuesAt
+// Purpose: Decodes a food record's numbers and finds its name text.
+// -----------------------------------------------------------------------------
+std::string_view BinaryStoreReader::foodValuesAt(uint32_t index, Food &food) const {
+    const unsigned char *p = base + foodOffset + static_cast<size_t>(index) * FOOD_RECORD_SIZE;
+    food.calories = static_cast<int32_t>(readU32(p + 4));
+    food.carbs = static_cast<int32_t>(readU32(p + 8));
+    food.protein = static_cast<int32_t>(readU32(p + 12));
+    food.fat = static_cast<int32_t>(readU32(p + 16));
+    food.grams = static_cast<int32_t>(readU32(p + 20));
+    return nameText(readU32(p));
+}
+
+// -----------------------------------------------------------------------------
+// Method: foodAt
+// Purpose: Decodes a food record. Each string table entry is interned the
+//          first time a record uses it. Out-of-range name ids yield an empty
+//          name.
+// -----------------------------------------------------------------------------
+Food BinaryStoreReader::foodAt(uint32_t index) const {
+    Food food;
+    std::string_view name = foodValuesAt(index, food);
+    uint32_t nameId = readU32(base + foodOffset + static_cast<size_t>(index) * FOOD_RECORD_SIZE);
+    if (nameId < strings) {
+        uint32_t &poolId = poolIds[nameId];
+        if (poolId == UNRESOLVED_NAME)
+            poolId = NamePool::instance().intern(name);
+        food.nameId = poolId;
+    }
+    return food;
+}
+
+// -----------------------------------------------------------------------------
+// Function: encodeBinaryStore
+// Purpose: Serializes everything into one buffer in a single pass over the
+//          entries: each day's records are appended after the index while
+//          its index entry and sums are filled in, then the string table and
+//          the header follow once the counts are known. Names are
+//          deduplicated in the string table. The snapshot lists its days in
+//          date order, which is also packed key order.
+// -----------------------------------------------------------------------------
+bool encodeBinaryStore(const DataSnapshot &snapshot, uint16_t generation, std::vector<unsigned char> &out) {
+    std::vector<const DaySnapshot *> days;
+    snapshot.collectDays(days);
+
+    // Every distinct name gets an id in the string table. Entries held in
+    // memory are looked up by NamePool id, so their text is hashed once per
+    // name; entries copied from the data file are looked up by text, which
+    // is copied because the file may be replaced once the copy is done.
+    std::unordered_map<uint32_t, uint32_t> poolNameIds;
+    std::unordered_map<std::string_view, uint32_t> textNameIds;
+    std::deque<std::string> names;
+    auto nameIdOf = [&textNameIds, &names](std::string_view text) {
+        auto found = textNameIds.find(text);
+        if (found != textNameIds.end())
+            return found->second;
+        uint32_t id = static_cast<uint32_t>(names.size());
+        names.emplace_back(text);
+        textNameIds.emplace(names.back(), id);
+        return id;
+    };
+
+    out.clear();
+    out.reserve(HEADER_SIZE + days.size() * DAY_ENTRY_SIZE);
+    out.resize(HEADER_SIZE + days.size() * DAY_ENTRY_SIZE);  // Filled in below
+    uint32_t foodCount = 0;
+    const NamePool &pool = NamePool::instance();
+    for (size_t d = 0; d < days.size(); d++) {
+        const DaySnapshot *day = days[d];
+        uint32_t firstFood = foodCount;
+        int64_t sums[5] = { 0, 0, 0, 0, 0 };
+        bool read = snapshot.visitFoods(*day, [&](const Food &food, std::string_view name) {
+            uint32_t nameId;
+            if (day->stored) {
+                nameId = nameIdOf(name);
+            } else {
+                auto inserted = poolNameIds.emplace(food.nameId, 0);
+                if (inserted.second)
+                    inserted.first->second = nameIdOf(pool.text(food.nameId));
+                nameId = inserted.first->second;
+            }
+            putU32(out, nameId);
+            putU32(out, static_cast<uint32_t>(food.calories));
+            putU32(out, static_cast<uint32_t>(food.carbs));
+            putU32(out, static_cast<uint32_t>(food.protein));
+            putU32(out, static_cast<uint32_t>(food.fat));
+            putU32(out, static_cast<uint32_t>(food.grams));
+            sums[0] += food.calories;
+            sums[1] += food.carbs;
+            sums[2] += food.protein;
+            sums[3] += food.fat;
+            sums[4] += food.grams;
+            foodCount++;
+        });
+        if (!read)
+            return false;
+        unsigned char *entry = out.data() + HEADER_SIZE + d * DAY_ENTRY_SIZE;
+        storeU32(entry, day->date.packedKey());
+        storeU32(entry + 4, firstFood);
+        storeU32(entry + 8, foodCount - firstFood);
+        for (int i = 0; i < 5; i++)
+            storeU32(entry + 12 + i * 4, static_cast<uint32_t>(clampSum(sums[i])));
+    }
+
+    // String table: start offsets followed by the end offset, then the text.
+    uint32_t offset = 0;
+    for (const std::string &name : names) {
+        putU32(out, offset);
+        offset += static_cast<uint32_t>(name.size());
+    }
+    putU32(out, offset);
+    for (const std::string &name : names)
+        out.insert(out.end(), name.begin(), name.end());
+
+    // Header.
+    std::vector<unsigned char> header;
+    header.insert(header.end(), BINARY_STORE_MAGIC, BINARY_STORE_MAGIC + 4);
+    putU16(header, BINARY_STORE_VERSION);
+    putU16(header, generation);
+    for (int i = 0; i < 4; i++)
+        putU32(header, static_cast<uint32_t>(snapshot.goals()[i]));
+    putU32(header, static_cast<uint32_t>(days.size()));
+    putU32(header, foodCount);
+    putU32(header, static_cast<uint32_t>(names.size()));
+    putU32(header, offset);
+    std::memcpy(out.data(), header.data(), HEADER_SIZE);
+    return true;
+}
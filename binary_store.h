@@ -0,0 +1,124 @@
+#ifndef BINARY_STORE_H
+#define BINARY_STORE_H
+
+// -----------------------------------------------------------------------------
+// File: binary_store.h
+// Purpose: Declare the compact binary storage format for calorie data and the
+//          reader/writer used by DataManager.
+//
+// Layout (all integers little-endian):
+//   Header       40 bytes: magic "CCAL", uint16 version, uint16 generation,
+//                int32 goals[4] (calories, carbs, protein, fat),
+//                uint32 dayCount, uint32 foodCount, uint32 stringCount,
+//                uint32 stringBytes
+//   Day index    dayCount x 32 bytes, sorted by packed date key:
+//                uint32 dateKey, uint32 firstFood, uint32 foodCount,
+//                int32 sums of the day's calories, carbs, protein, fat, grams
+//                (added up in 64 bits and clamped to the int32 range)
+//   Food records foodCount x 24 bytes:
+//                uint32 nameId, int32 calories, carbs, protein, fat, grams
+//   String table (stringCount + 1) x uint32 start offsets, then stringBytes
+//                bytes of name text
+//
+// The index sums let a day's totals be known without reading its food
+// records, so DataManager loads only the header and the index at startup.
+// Version 1 files have 12-byte index entries without the sums; the reader
+// still accepts them and sums the records instead.
+//
+// The generation counts saves (wrapping at 65536; files from before it was
+// used hold 0). The journal records the generation it was started against,
+// so a journal that was already folded into the file can be recognised.
+// -----------------------------------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "food.h"
+#include "data_snapshot.h"  // Input of the writer
+#include "mapped_file.h"
+
+// Identifies a calorie data binary file and the layout version it uses.
+const char BINARY_STORE_MAGIC[4] = { 'C', 'C', 'A', 'L' };
+const uint16_t BINARY_STORE_VERSION = 2;
+
+// -----------------------------------------------------------------------------
+// Structure: BinaryDayEntry
+// Purpose: One slot of the day index: where a day's food records start, how
+//          many there are and what they add up to.
+// -----------------------------------------------------------------------------
+struct BinaryDayEntry {
+    uint32_t dateKey;    // Packed date (see Date::packedKey)
+    uint32_t firstFood;  // Index of the day's first food record
+    uint32_t foodCount;  // Number of food records belonging to the day
+    int calories;        // Sums of the day's food records
+    int carbs;
+    int protein;
+    int fat;
+    int grams;
+};
+
+// -----------------------------------------------------------------------------
+// Class: BinaryStoreReader
+// Purpose: Validates a mapped binary store and decodes it on demand. Nothing
+//          is copied up front, so opening costs the same for any file size.
+// -----------------------------------------------------------------------------
+class BinaryStoreReader {
+public:
+    BinaryStoreReader();
+
+    // Maps and validates the file. Returns false if it is missing or malformed.
+    bool open(const std::string &path);
+    // Unmaps the file; the reader is empty until the next open.
+    void close();
+
+    // True unless the file is version 1, whose index holds no sums.
+    bool hasDayTotals() const { return version >= 2; }
+
+    // Goals stored in the header, in the order calories, carbs, protein, fat.
+    int goal(int index) const;
+    // Save generation stored in the header.
+    uint16_t generation() const { return saveGeneration; }
+
+    uint32_t dayCount() const { return days; }
+    uint32_t foodCount() const { return foods; }
+    // The index entry at 'index'. For a version 1 file the sums are added up
+    // from the day's records (zero if they lie outside the file).
+    BinaryDayEntry dayAt(uint32_t index) const;
+
+    // Binary search of the day index. Returns false if the date is not stored.
+    bool findDay(uint32_t dateKey, BinaryDayEntry &entry) const;
+
+    // Decodes one food record; its name is interned from the string table.
+    Food foodAt(uint32_t index) const;
+    // Decodes one food record without touching the NamePool: the values go
+    // to 'food' (whose nameId is left unchanged) and the name is returned as
+    // a view into the mapping. Safe on any thread that holds the reader.
+    std::string_view foodValuesAt(uint32_t index, Food &food) const;
+
+private:
+    MappedFile file;              // Mapped file contents
+    const unsigned char *base;    // First byte of the mapping
+    uint16_t version;             // Layout version of the open file
+    size_t dayEntrySize;          // Bytes per index entry for that version
+    int goals[4];                 // Decoded header goals
+    uint16_t saveGeneration;      // Decoded header generation
+    uint32_t days;                // Entries in the day index
+    uint32_t foods;               // Food records in the file
+    uint32_t strings;             // Names in the string table
+    size_t foodOffset;            // Byte offset of the first food record
+    size_t stringOffset;          // Byte offset of the string offset table
+    size_t stringDataOffset;      // Byte offset of the name text
+    mutable std::vector<uint32_t> poolIds;  // String table index -> NamePool id, filled on first use
+
+    // Text of string table entry 'nameId'; empty if it is out of range.
+    std::string_view nameText(uint32_t nameId) const;
+};
+
+// Encodes the snapshot's goals and days in the binary layout into 'out'.
+// Only reads the snapshot, so it can run on any thread. Days the snapshot
+// leaves in the data file are copied from it; returns false if one of them
+// can no longer be read there.
+bool encodeBinaryStore(const DataSnapshot &snapshot, uint16_t generation, std::vector<unsigned char> &out);
+
+#endif // BINARY_STORE_H
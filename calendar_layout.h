@@ -0,0 +1,64 @@
+#ifndef CALENDAR_LAYOUT_H
+#define CALENDAR_LAYOUT_H
+
+// -----------------------------------------------------------------------------
+// File: calendar_layout.h
+// Purpose: Declare MonthLayout, the month grid drawn and navigated by the
+//          calendar view. Everything here is constexpr; no libc time calls.
+// -----------------------------------------------------------------------------
+
+#include "date.h"
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// Structure: MonthLayout
+// Purpose: Where each day of a month sits in a Sunday-first week grid.
+//          - startWeekday is the column of day 1 (0 = Sunday).
+//          - cells holds the day number shown in each grid cell, 0 for the
+//            blanks before day 1 and after the last day.
+//          A month spans four to six rows.
+// -----------------------------------------------------------------------------
+struct MonthLayout {
+    static constexpr int COLUMNS = 7;
+    static constexpr int MAX_ROWS = 6;
+
+    int year;                         // e.g. 2025
+    int month;                        // 1-12
+    Date firstDay;                    // Day 1 of the month
+    int startWeekday;                 // Column of day 1
+    int dayCount;                     // 28-31
+    int rows;                         // Grid rows in use
+    uint8_t cells[MAX_ROWS][COLUMNS]; // Day per cell, 0 = blank
+
+    // Lays out a month; year and month must be valid (see Date::isValid).
+    static constexpr MonthLayout of(int year, int month) {
+        MonthLayout layout{};
+        layout.year = year;
+        layout.month = month;
+        layout.firstDay = Date::fromCivil(year, month, 1);
+        layout.startWeekday = layout.firstDay.weekday();
+        layout.dayCount = Date::daysInMonth(year, month);
+        layout.rows = (layout.startWeekday + layout.dayCount + COLUMNS - 1) / COLUMNS;
+        for (int day = 1; day <= layout.dayCount; day++)
+            layout.cells[layout.row(day)][layout.column(day)] = static_cast<uint8_t>(day);
+        return layout;
+    }
+
+    constexpr bool isMonth(int otherYear, int otherMonth) const {
+        return year == otherYear && month == otherMonth;
+    }
+    constexpr int column(int day) const { return (startWeekday + day - 1) % COLUMNS; }
+    constexpr int row(int day) const { return (startWeekday + day - 1) / COLUMNS; }
+    constexpr Date dateOf(int day) const { return firstDay + (day - 1); }
+    constexpr Date lastDay() const { return dateOf(dayCount); }
+};
+
+// Known months: a leap February starting on Thursday, a common February that
+// fills exactly four rows, and a 31-day month starting on Saturday (six rows).
+static_assert(MonthLayout::of(2024, 2).startWeekday == 4 && MonthLayout::of(2024, 2).dayCount == 29 &&
+              MonthLayout::of(2024, 2).rows == 5, "February 2024");
+static_assert(MonthLayout::of(2015, 2).startWeekday == 0 && MonthLayout::of(2015, 2).rows == 4, "February 2015");
+static_assert(MonthLayout::of(2026, 8).rows == 6 && MonthLayout::of(2026, 8).cells[5][1] == 31, "August 2026");
+static_assert(MonthLayout::of(1900, 2).dayCount == 28 && MonthLayout::of(2000, 2).dayCount == 29, "century leap rule");
+
+#endif // CALENDAR_LAYOUT_H
@@ -0,0 +1,245 @@
+#include "column_kernels.h"
+#include "food_columns.h"  // Column order and count
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define COLUMN_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC accepts AVX2 intrinsics in any function.
+#define TARGET_AVX2
+#else
+// GCC and Clang compile just this function for AVX2; the rest of the program
+// keeps the default instruction set.
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// -----------------------------------------------------------------------------
+// Kernel: sumColumnsScalar
+// Purpose: Reference implementation, one independent accumulator per column.
+// -----------------------------------------------------------------------------
+static void sumColumnsScalar(const int32_t *const *columns, uint32_t count, int64_t *sums) {
+    const int32_t *calories = columns[COLUMN_CALORIES];
+    const int32_t *carbs = columns[COLUMN_CARBS];
+    const int32_t *protein = columns[COLUMN_PROTEIN];
+    const int32_t *fat = columns[COLUMN_FAT];
+    const int32_t *grams = columns[COLUMN_GRAMS];
+    int64_t sumCalories = 0, sumCarbs = 0, sumProtein = 0, sumFat = 0, sumGrams = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        sumCalories += calories[i];
+        sumCarbs += carbs[i];
+        sumProtein += protein[i];
+        sumFat += fat[i];
+        sumGrams += grams[i];
+    }
+    sums[COLUMN_CALORIES] += sumCalories;
+    sums[COLUMN_CARBS] += sumCarbs;
+    sums[COLUMN_PROTEIN] += sumProtein;
+    sums[COLUMN_FAT] += sumFat;
+    sums[COLUMN_GRAMS] += sumGrams;
+}
+
+#ifdef COLUMN_KERNELS_X86
+
+// -----------------------------------------------------------------------------
+// Helpers: addWidenedSse2 / reduceSse2
+// Purpose: Sign-extend four int32 values to int64 by interleaving them with
+//          their sign mask, and add them to two 64-bit accumulators; fold the
+//          accumulators into one sum at the end.
+// -----------------------------------------------------------------------------
+static inline void addWidenedSse2(__m128i &low, __m128i &high, const int32_t *values) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    __m128i sign = _mm_srai_epi32(v, 31);
+    low = _mm_add_epi64(low, _mm_unpacklo_epi32(v, sign));
+    high = _mm_add_epi64(high, _mm_unpackhi_epi32(v, sign));
+}
+
+static inline int64_t reduceSse2(__m128i low, __m128i high) {
+    alignas(16) int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), _mm_add_epi64(low, high));
+    return lanes[0] + lanes[1];
+}
+
+// -----------------------------------------------------------------------------
+// Kernel: sumColumnsSse2
+// Purpose: Four rows of every column per step. The ten accumulators are
+//          named locals so they stay in the sixteen XMM registers.
+// -----------------------------------------------------------------------------
+static void sumColumnsSse2(const int32_t *const *columns, uint32_t count, int64_t *sums) {
+    const int32_t *calories = columns[COLUMN_CALORIES];
+    const int32_t *carbs = columns[COLUMN_CARBS];
+    const int32_t *protein = columns[COLUMN_PROTEIN];
+    const int32_t *fat = columns[COLUMN_FAT];
+    const int32_t *grams = columns[COLUMN_GRAMS];
+    __m128i caloriesLow = _mm_setzero_si128(), caloriesHigh = _mm_setzero_si128();
+    __m128i carbsLow = _mm_setzero_si128(), carbsHigh = _mm_setzero_si128();
+    __m128i proteinLow = _mm_setzero_si128(), proteinHigh = _mm_setzero_si128();
+    __m128i fatLow = _mm_setzero_si128(), fatHigh = _mm_setzero_si128();
+    __m128i gramsLow = _mm_setzero_si128(), gramsHigh = _mm_setzero_si128();
+    uint32_t vectorEnd = count & ~3u;
+    for (uint32_t i = 0; i < vectorEnd; i += 4) {
+        addWidenedSse2(caloriesLow, caloriesHigh, calories + i);
+        addWidenedSse2(carbsLow, carbsHigh, carbs + i);
+        addWidenedSse2(proteinLow, proteinHigh, protein + i);
+        addWidenedSse2(fatLow, fatHigh, fat + i);
+        addWidenedSse2(gramsLow, gramsHigh, grams + i);
+    }
+    sums[COLUMN_CALORIES] += reduceSse2(caloriesLow, caloriesHigh);
+    sums[COLUMN_CARBS] += reduceSse2(carbsLow, carbsHigh);
+    sums[COLUMN_PROTEIN] += reduceSse2(proteinLow, proteinHigh);
+    sums[COLUMN_FAT] += reduceSse2(fatLow, fatHigh);
+    sums[COLUMN_GRAMS] += reduceSse2(gramsLow, gramsHigh);
+    if (vectorEnd < count) {
+        const int32_t *tail[FOOD_COLUMN_COUNT] = { calories + vectorEnd, carbs + vectorEnd, protein + vectorEnd,
+                                                   fat + vectorEnd, grams + vectorEnd };
+        sumColumnsScalar(tail, count - vectorEnd, sums);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Helpers: addWidenedAvx2 / reduceAvx2
+// Purpose: vpmovsxdq widens each half of eight int32 values to four int64
+//          lanes; the two accumulators are folded at the end.
+// -----------------------------------------------------------------------------
+TARGET_AVX2 static inline void addWidenedAvx2(__m256i &low, __m256i &high, const int32_t *values) {
+    __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + 4));
+    low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(first));
+    high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(second));
+}
+
+TARGET_AVX2 static inline int64_t reduceAvx2(__m256i low, __m256i high) {
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), _mm256_add_epi64(low, high));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+// -----------------------------------------------------------------------------
+// Kernel: sumColumnsAvx2
+// Purpose: Eight rows of every column per step, ten YMM accumulators.
+// -----------------------------------------------------------------------------
+TARGET_AVX2 static void sumColumnsAvx2(const int32_t *const *columns, uint32_t count, int64_t *sums) {
+    const int32_t *calories = columns[COLUMN_CALORIES];
+    const int32_t *carbs = columns[COLUMN_CARBS];
+    const int32_t *protein = columns[COLUMN_PROTEIN];
+    const int32_t *fat = columns[COLUMN_FAT];
+    const int32_t *grams = columns[COLUMN_GRAMS];
+    __m256i caloriesLow = _mm256_setzero_si256(), caloriesHigh = _mm256_setzero_si256();
+    __m256i carbsLow = _mm256_setzero_si256(), carbsHigh = _mm256_setzero_si256();
+    __m256i proteinLow = _mm256_setzero_si256(), proteinHigh = _mm256_setzero_si256();
+    __m256i fatLow = _mm256_setzero_si256(), fatHigh = _mm256_setzero_si256();
+    __m256i gramsLow = _mm256_setzero_si256(), gramsHigh = _mm256_setzero_si256();
+    uint32_t vectorEnd = count & ~7u;
+    for (uint32_t i = 0; i < vectorEnd; i += 8) {
+        addWidenedAvx2(caloriesLow, caloriesHigh, calories + i);
+        addWidenedAvx2(carbsLow, carbsHigh, carbs + i);
+        addWidenedAvx2(proteinLow, proteinHigh, protein + i);
+        addWidenedAvx2(fatLow, fatHigh, fat + i);
+        addWidenedAvx2(gramsLow, gramsHigh, grams + i);
+    }
+    sums[COLUMN_CALORIES] += reduceAvx2(caloriesLow, caloriesHigh);
+    sums[COLUMN_CARBS] += reduceAvx2(carbsLow, carbsHigh);
+    sums[COLUMN_PROTEIN] += reduceAvx2(proteinLow, proteinHigh);
+    sums[COLUMN_FAT] += reduceAvx2(fatLow, fatHigh);
+    sums[COLUMN_GRAMS] += reduceAvx2(gramsLow, gramsHigh);
+    if (vectorEnd < count) {
+        const int32_t *tail[FOOD_COLUMN_COUNT] = { calories + vectorEnd, carbs + vectorEnd, protein + vectorEnd,
+                                                   fat + vectorEnd, grams + vectorEnd };
+        sumColumnsScalar(tail, count - vectorEnd, sums);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Helper: detectAvx2
+// Purpose: AVX2 needs the CPUID feature bit and an OS that saves the upper
+//          halves of the YMM registers (OSXSAVE plus XCR0 bits 1 and 2).
+// -----------------------------------------------------------------------------
+static bool detectAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    // Also checks OS support for the YMM state.
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // COLUMN_KERNELS_X86
+
+// -----------------------------------------------------------------------------
+// Function: sumKernelSupported
+// Purpose: Scalar always works; SSE2 is part of x86-64; AVX2 is probed.
+// -----------------------------------------------------------------------------
+bool sumKernelSupported(SumKernel kernel) {
+    switch (kernel) {
+    case SUM_KERNEL_SCALAR:
+        return true;
+#ifdef COLUMN_KERNELS_X86
+    case SUM_KERNEL_SSE2:
+        return true;
+    case SUM_KERNEL_AVX2: {
+        static const bool avx2 = detectAvx2();
+        return avx2;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function: bestSumKernel
+// Purpose: Picks the widest kernel the machine runs.
+// -----------------------------------------------------------------------------
+SumKernel bestSumKernel() {
+    if (sumKernelSupported(SUM_KERNEL_AVX2))
+        return SUM_KERNEL_AVX2;
+    if (sumKernelSupported(SUM_KERNEL_SSE2))
+        return SUM_KERNEL_SSE2;
+    return SUM_KERNEL_SCALAR;
+}
+
+// -----------------------------------------------------------------------------
+// Function: columnSumFunction
+// Purpose: Maps a kernel to its implementation, falling back to scalar.
+// -----------------------------------------------------------------------------
+ColumnSumFunction columnSumFunction(SumKernel kernel) {
+    if (!sumKernelSupported(kernel))
+        return sumColumnsScalar;
+    switch (kernel) {
+#ifdef COLUMN_KERNELS_X86
+    case SUM_KERNEL_SSE2:
+        return sumColumnsSse2;
+    case SUM_KERNEL_AVX2:
+        return sumColumnsAvx2;
+#endif
+    default:
+        return sumColumnsScalar;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function: sumKernelName
+// Purpose: Names a kernel.
+// -----------------------------------------------------------------------------
+const char *sumKernelName(SumKernel kernel) {
+    switch (kernel) {
+    case SUM_KERNEL_SSE2:
+        return "sse2";
+    case SUM_KERNEL_AVX2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef COLUMN_KERNELS_H
+#define COLUMN_KERNELS_H
+
+// -----------------------------------------------------------------------------
+// File: column_kernels.h
+// Purpose: Declare the summation kernels FoodColumns uses to add up one block
+//          of every column, and the runtime choice between them.
+// -----------------------------------------------------------------------------
+
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// Enum: SumKernel
+// Purpose: Implementations of the column sum, from most to least portable.
+//          Every kernel widens to 64 bits before adding, so all of them return
+//          exactly the same sums.
+// -----------------------------------------------------------------------------
+enum SumKernel {
+    SUM_KERNEL_SCALAR,  // Plain C++, available everywhere
+    SUM_KERNEL_SSE2,    // 128-bit, any x86-64 processor
+    SUM_KERNEL_AVX2     // 256-bit, chosen when the processor and OS support it
+};
+
+// Adds 'count' rows of every column to 'sums' in one pass. 'columns' holds
+// one pointer per FoodColumn.
+typedef void (*ColumnSumFunction)(const int32_t *const *columns, uint32_t count, int64_t *sums);
+
+// True if 'kernel' can run on this machine.
+bool sumKernelSupported(SumKernel kernel);
+// The fastest supported kernel, detected once.
+SumKernel bestSumKernel();
+// Function implementing 'kernel', or the scalar one if it is not supported.
+ColumnSumFunction columnSumFunction(SumKernel kernel);
+// Short name for logs and measurements ("scalar", "sse2", "avx2").
+const char *sumKernelName(SumKernel kernel);
+
+#endif // COLUMN_KERNELS_H
@@ -0,0 +1,189 @@
+#include "console_renderer.h"
+#include "constants.h"  // Console dimensions and default colors
+#include <cstdio>
+#include <algorithm>
+
+// -----------------------------------------------------------------------------
+// Constructor: ConsoleRenderer
+// Purpose: Start with a blank back buffer and an unknown front buffer, so the
+//          first present() paints the whole screen.
+// -----------------------------------------------------------------------------
+ConsoleRenderer::ConsoleRenderer(Terminal &t)
+    : terminal(t), back(CONSOLE_WIDTH * CONSOLE_HEIGHT), front(CONSOLE_WIDTH * CONSOLE_HEIGHT),
+      cursorX(0), cursorY(0), color(ConsoleColors::DEFAULT),
+      showFrameTime(false), lastFrameMs(0.0), lastChangedCells(0),
+      frameStart(std::chrono::steady_clock::now()) {
+    clear();
+    invalidate();
+}
+
+// -----------------------------------------------------------------------------
+// Method: clear
+// Purpose: Fills the back buffer with blanks in the default color.
+// -----------------------------------------------------------------------------
+void ConsoleRenderer::clear() {
+    for (TerminalCell &cell : back) {
+        cell.ch = ' ';
+        cell.attribute = ConsoleColors::DEFAULT;
+    }
+    cursorX = 0;
+    cursorY = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Method: setCursor
+// Purpose: Moves the write position.
+// -----------------------------------------------------------------------------
+void ConsoleRenderer::setCursor(int x, int y) {
+    cursorX = x;
+    cursorY = y;
+}
+
+// -----------------------------------------------------------------------------
+// Method: setColor
+// Purpose: Selects the attribute for subsequent writes.
+// -----------------------------------------------------------------------------
+void ConsoleRenderer::setColor(ColorAttribute attribute) {
+    color = attribute;
+}
+
+// -----------------------------------------------------------------------------
+// Method: write
+// Purpose: Stores characters in the back buffer the way the console would
+//          have printed them, but without touching the console.
+// -----------------------------------------------------------------------------
+void ConsoleRenderer::write(const char *text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '\n') {
+            cursorX = 0;
+            cursorY++;
+            continue;
+        }
+        if (cursorX >= CONSOLE_WIDTH) {
+            cursorX = 0;
+            cursorY++;
+        }
+        if (cursorX >= 0 && cursorY >= 0 && cursorY < CONSOLE_HEIGHT) {
+            TerminalCell &cell = back[cursorY * CONSOLE_WIDTH + cursorX];
+            cell.ch = text[i];
+            cell.attribute = color;
+        }
+        cursorX++;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Method: present
+// Purpose: Finds the rectangle enclosing every changed cell and hands it to
+//          the terminal as one region. Unchanged frames send only the cursor.
+// -----------------------------------------------------------------------------
+void ConsoleRenderer::present() {
+    if (showFrameTime)
+        drawFrameTime();
+
+    int left = CONSOLE_WIDTH, top = CONSOLE_HEIGHT, right = -1, bottom = -1;
+    size_t changed = 0;
+    for (int y = 0; y < CONSOLE_HEIGHT; y++) {
+        for (int x = 0; x < CONSOLE_WIDTH; x++) {
+            const TerminalCell &a = back[y * CONSOLE_WIDTH + x];
+            const TerminalCell &b = front[y * CONSOLE_WIDTH + x];
+            if (a.ch == b.ch && a.attribute == b.attribute)
+                continue;
+            changed++;
+            if (x < left) left = x;
+            if (x > right) right = x;
+            if (y < top) top = y;
+            if (y > bottom) bottom = y;
+        }
+    }
+
+    if (changed > 0) {
+        int width = right - left + 1;
+        int height = bottom - top + 1;
+        region.resize(static_cast<size_t>(width) * height);
+        for (int y = 0; y < height; y++) {
+            const TerminalCell *row = &back[(top + y) * CONSOLE_WIDTH + left];
+            std::copy(row, row + width, region.begin() + static_cast<size_t>(y) * width);
+        }
+        terminal.writeRegion(left, top, width, height, region.data());
+        front = back;
+    }
+
+    // Line input echoes at the console cursor, so keep it where drawing stopped.
+    int x = cursorX < CONSOLE_WIDTH ? cursorX : CONSOLE_WIDTH - 1;
+    int y = cursorY < CONSOLE_HEIGHT ? cursorY : CONSOLE_HEIGHT - 1;
+    terminal.moveCursor(x < 0 ? 0 : x, y < 0 ? 0 : y);
+    terminal.flush();
+
+    lastChangedCells = changed;
+    lastFrameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+}
+
+// -----------------------------------------------------------------------------
+// Method: invalidate
+// Purpose: Sets every front cell to a value no drawing produces.
+// -----------------------------------------------------------------------------
+void ConsoleRenderer::invalidate() {
+    for (TerminalCell &cell : front) {
+        cell.ch = '\0';
+        cell.attribute = 0xFFFF;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Method: beginFrame
+// Purpose: Records when work on the next frame started.
+// -----------------------------------------------------------------------------
+void ConsoleRenderer::beginFrame() {
+    frameStart = std::chrono::steady_clock::now();
+}
+
+// -----------------------------------------------------------------------------
+// Method: toggleFrameTime
+// Purpose: Turns the frame-time counter on or off.
+// -----------------------------------------------------------------------------
+void ConsoleRenderer::toggleFrameTime() {
+    showFrameTime = !showFrameTime;
+}
+
+// -----------------------------------------------------------------------------
+// Method: drawFrameTime
+// Purpose: Writes the previous frame's time and changed-cell count at the
+//          right end of the bottom row, leaving cursor and color untouched.
+// -----------------------------------------------------------------------------
+void ConsoleRenderer::drawFrameTime() {
+    char text[48];
+    int length = std::snprintf(text, sizeof(text), " frame %.2f ms, %zu cells ", lastFrameMs, lastChangedCells);
+    if (length <= 0 || length >= CONSOLE_WIDTH)
+        return;
+    int savedX = cursorX, savedY = cursorY;
+    ColorAttribute savedColor = color;
+    setCursor(CONSOLE_WIDTH - length, CONSOLE_HEIGHT - 1);
+    setColor(8);
+    write(text, static_cast<size_t>(length));
+    cursorX = savedX;
+    cursorY = savedY;
+    color = savedColor;
+}
+
+// -----------------------------------------------------------------------------
+// Constructor: RendererStreamBuf
+// Purpose: Bind the stream buffer to a renderer. No put area is set up, so
+//          every write reaches overflow() or xsputn() in order with color and
+//          cursor changes made directly on the renderer.
+// -----------------------------------------------------------------------------
+RendererStreamBuf::RendererStreamBuf(ConsoleRenderer &r) : renderer(r) {
+}
+
+RendererStreamBuf::int_type RendererStreamBuf::overflow(int_type c) {
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+        return traits_type::not_eof(c);
+    char ch = traits_type::to_char_type(c);
+    renderer.write(&ch, 1);
+    return c;
+}
+
+std::streamsize RendererStreamBuf::xsputn(const char *text, std::streamsize count) {
+    renderer.write(text, static_cast<size_t>(count));
+    return count;
+}
@@ -0,0 +1,88 @@
+#ifndef CONSOLE_RENDERER_H
+#define CONSOLE_RENDERER_H
+
+// -----------------------------------------------------------------------------
+// File: console_renderer.h
+// Purpose: Declare ConsoleRenderer, an off-screen cell buffer that is compared
+//          with the previous frame so only changed cells reach the console,
+//          and RendererStreamBuf, which routes std::cout into it.
+// -----------------------------------------------------------------------------
+
+#include <streambuf>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include "terminal.h"  // TerminalCell and the console backend
+
+// -----------------------------------------------------------------------------
+// Class: ConsoleRenderer
+// Purpose: Holds the frame being drawn (back) and the frame last sent to the
+//          console (front), both CONSOLE_WIDTH x CONSOLE_HEIGHT cells of
+//          character plus color attribute.
+//          - clear(), setCursor(), setColor() and write() only touch 'back'.
+//          - present() sends the bounding rectangle of the changed cells to
+//            the terminal as one region and one flush, then remembers it as
+//            'front'.
+//          - invalidate() forgets 'front' after something else wrote to the
+//            console (for example echoed line input), forcing a full redraw.
+// -----------------------------------------------------------------------------
+class ConsoleRenderer {
+public:
+    explicit ConsoleRenderer(Terminal &terminal);
+
+    // Blanks the back buffer and moves the cursor home, like "cls" did.
+    void clear();
+    // Moves the write cursor; the console cursor follows on present().
+    void setCursor(int x, int y);
+    // Sets the attribute used by later writes.
+    void setColor(ColorAttribute attribute);
+    // Writes text at the cursor. '\n' starts the next row; text past the last
+    // column wraps and text past the last row is dropped.
+    void write(const char *text, size_t length);
+
+    // Sends the changed cells to the console and places the console cursor.
+    void present();
+    // Marks every cell as unknown so the next present() redraws everything.
+    void invalidate();
+
+    // Starts timing a frame; called when the key that triggers it arrives.
+    void beginFrame();
+    // Shows or hides the frame-time counter on the bottom row.
+    void toggleFrameTime();
+
+private:
+    Terminal &terminal;               // Backend that receives presented frames
+    std::vector<TerminalCell> back;   // Frame being drawn
+    std::vector<TerminalCell> front;  // Frame currently on the console
+    std::vector<TerminalCell> region; // Staging area for the changed rectangle
+    int cursorX;
+    int cursorY;
+    ColorAttribute color;
+
+    bool showFrameTime;                                // Counter visible
+    double lastFrameMs;                                // Build plus present time of the last frame
+    size_t lastChangedCells;                           // Cells sent by the last present()
+    std::chrono::steady_clock::time_point frameStart;  // Set by beginFrame()
+
+    // Draws the frame-time counter into the back buffer.
+    void drawFrameTime();
+};
+
+// -----------------------------------------------------------------------------
+// Class: RendererStreamBuf
+// Purpose: Unbuffered stream buffer that forwards everything to a renderer,
+//          so existing "std::cout << ..." drawing code fills the cell buffer.
+// -----------------------------------------------------------------------------
+class RendererStreamBuf : public std::streambuf {
+public:
+    explicit RendererStreamBuf(ConsoleRenderer &renderer);
+
+protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char *text, std::streamsize count) override;
+
+private:
+    ConsoleRenderer &renderer;
+};
+
+#endif // CONSOLE_RENDERER_H
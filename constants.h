@@ -9,8 +9,9 @@
 //          application.
 // -----------------------------------------------------------------------------
 
-#include <windows.h>    // Windows-specific API functions (e.g., Beep, console control)
 #include <string>       // STL string class
+#include <cstdint>      // Fixed-width color attribute type
+#include "sound_player.h"  // Plays tones on a worker thread
 
 // -----------------------------------------------------------------------------
 // Application Settings
@@ -23,19 +24,66 @@ const int CONSOLE_HEIGHT = 24;
 // File path for persistent storage  the calorie data is saved and loaded from this file.
 const std::string DATA_FILE = "calorie_data.txt";
 
+// Binary store written by saveData. On first run it is converted from DATA_FILE,
+// which is then only used for imports and text exports.
+const std::string BINARY_DATA_FILE = "calorie_data.bin";
+
+// Food template library, stored separately from the daily data.
+const std::string TEMPLATE_FILE = "food_templates.txt";
+
+// Append-only journal holding changes made since the data file was last compacted.
+const std::string JOURNAL_FILE = "calorie_data.journal";
+
+// Number of journal records after which the journal is folded into the data file.
+const size_t JOURNAL_COMPACT_THRESHOLD = 1024;
+
+// Longest time, in milliseconds, a journaled change waits for a device sync
+// while further changes arrive; changes inside the window share one sync.
+// Every change reaches the OS immediately, so only a power loss can lose the
+// unsynced ones.
+const uint32_t JOURNAL_SYNC_INTERVAL_MS = 100;
+
+// Names of the profiles, one per line. The "default" profile uses the file
+// names above; other profiles insert their name before the extension.
+const std::string PROFILE_LIST_FILE = "profiles.txt";
+const std::string DEFAULT_PROFILE = "default";
+
+// Days of one profile kept in memory at once. Beyond this the least recently
+// used days that are unchanged since the last save are dropped; they are read
+// back from the binary data file when next needed.
+const size_t RESIDENT_DAY_LIMIT = 1024;
+
+// Profiles kept in memory at once; the least recently used one beyond this is
+// saved and unloaded.
+const size_t PROFILE_CACHE_SIZE = 4;
+
 // -----------------------------------------------------------------------------
 // Console Color Definitions
 // -----------------------------------------------------------------------------
 
+// A cell color: foreground in the low four bits, background in the next four.
+// The bits follow the Win32 console attribute layout, so the Windows terminal
+// backend passes them through unchanged and the ANSI backend translates them.
+typedef uint16_t ColorAttribute;
+
+const ColorAttribute FG_BLUE      = 0x0001;
+const ColorAttribute FG_GREEN     = 0x0002;
+const ColorAttribute FG_RED       = 0x0004;
+const ColorAttribute FG_INTENSITY = 0x0008;
+const ColorAttribute BG_BLUE      = 0x0010;
+const ColorAttribute BG_GREEN     = 0x0020;
+const ColorAttribute BG_RED       = 0x0040;
+const ColorAttribute BG_INTENSITY = 0x0080;
+
 // Namespace for simple color definitions for console output.
-// Uses WinAPI color codes to create various foreground and background color combinations.
+// Combines the attribute bits above into various foreground and background color combinations.
 namespace ConsoleColors {
     // Default text color: combination of red, green and blue for white/light gray text.
-    const WORD DEFAULT = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE;
+    const ColorAttribute DEFAULT = FG_RED | FG_GREEN | FG_BLUE;
     // Highlight background: blue background
-    const WORD HIGHLIGHT = BACKGROUND_BLUE;
+    const ColorAttribute HIGHLIGHT = BG_BLUE;
     // Button text color: intense green for buttons.
-    const WORD BUTTON = FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+    const ColorAttribute BUTTON = FG_GREEN | FG_INTENSITY;
 }
 
 // -----------------------------------------------------------------------------
@@ -43,14 +91,16 @@ namespace ConsoleColors {
 // -----------------------------------------------------------------------------
 
 // Namespace for inline sound functions to provide audio feedback for various actions.
-// Uses the Windows Beep API to play specific frequencies for sound effects.
+// Tones are queued on the SoundPlayer worker, so these return immediately.
 namespace Sounds {
     // Play a tone for page switching actions.
-    inline void PlayPageSwitchSound() { Beep(600, 150); }
+    inline void PlayPageSwitchSound() { SoundPlayer::instance().play(600, 150); }
     // Play a tone when navigating the menu.
-    inline void PlayNavigationSound() { Beep(700, 150); }
+    inline void PlayNavigationSound() { SoundPlayer::instance().play(700, 150); }
     // Play a tone when a selection is made.
-    inline void PlaySelectSound() { Beep(800, 150); }
+    inline void PlaySelectSound() { SoundPlayer::instance().play(800, 150); }
+    // Turn all sounds off or back on.
+    inline void ToggleMute() { SoundPlayer::instance().toggleMute(); }
 }
 
 #endif // CONSTANTS_H
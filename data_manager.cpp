@@ -1,29 +1,220 @@
 #include "data_manager.h"
 #include "constants.h"  // Provides DATA_FILE and other constant definitions
+#include "mapped_file.h" // Read-only file mapping for the zero-copy loader
+#include "binary_store.h" // Compact binary data file format
+#include "parallel_text_loader.h" // Multi-threaded parsing of the text data file
 #include <fstream>      // For file I/O operations
 #include <sstream>      // For string stream processing
 #include <iostream>     // For standard I/O (e.g., error output)
 #include <algorithm>    // For standard algorithms like std::replace
 #include <cstdio>       // For formatted input/output
+#include <cstdlib>      // For std::strtoul
+#include <cassert>      // For the debug totals invariant
+#include <utility>      // For std::move
+#include <filesystem>   // For keeping a copy of a journal that does not match
+
+// -----------------------------------------------------------------------------
+// Methods: DailyTotals::add / subtract
+// Purpose: Apply or remove one food's contribution to the running totals.
+// -----------------------------------------------------------------------------
+void DailyTotals::add(const Food &food) {
+    calories += food.calories;
+    carbs += food.carbs;
+    protein += food.protein;
+    fat += food.fat;
+}
+
+void DailyTotals::subtract(const Food &food) {
+    calories -= food.calories;
+    carbs -= food.carbs;
+    protein -= food.protein;
+    fat -= food.fat;
+}
+
+// -----------------------------------------------------------------------------
+// Methods: DailyRecord::addFood / replaceFood / removeFood
+// Purpose: Change the day's row list and adjust the totals by the difference.
+//          Rows are never rewritten: an edit appends the new values and
+//          releases the old row.
+// -----------------------------------------------------------------------------
+void DailyRecord::addFood(const Food &food) {
+    rows.push_back(columns->append(food));
+    totals.add(food);
+}
+
+void DailyRecord::replaceFood(size_t index, const Food &food) {
+    totals.subtract(columns->get(rows[index]));
+    totals.add(food);
+    columns->release(rows[index]);
+    rows[index] = columns->append(food);
+}
+
+void DailyRecord::removeFood(size_t index) {
+    totals.subtract(columns->get(rows[index]));
+    columns->release(rows[index]);
+    rows.erase(rows.begin() + index);
+}
+
+// -----------------------------------------------------------------------------
+// Method: DailyRecord::appendRows
+// Purpose: Takes rows the caller reserved in the store, with their sum, so
+//          the totals are right before the rows hold any values.
+// -----------------------------------------------------------------------------
+void DailyRecord::appendRows(uint32_t firstRow, uint32_t count, const DailyTotals &sum) {
+    rows.reserve(rows.size() + count);
+    for (uint32_t i = 0; i < count; i++)
+        rows.push_back(firstRow + i);
+    totals.calories += sum.calories;
+    totals.carbs += sum.carbs;
+    totals.protein += sum.protein;
+    totals.fat += sum.fat;
+}
+
+// -----------------------------------------------------------------------------
+// Method: DailyRecord::checkTotals
+// Purpose: Debug-only invariant: the running totals equal a fresh sum.
+// -----------------------------------------------------------------------------
+void DailyRecord::checkTotals() const {
+#ifndef NDEBUG
+    DailyTotals expected;
+    for (const Food &food : foods())
+        expected.add(food);
+    assert(expected.calories == totals.calories && expected.carbs == totals.carbs &&
+           expected.protein == totals.protein && expected.fat == totals.fat);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Helper: rangeValuesOf
+// Purpose: What one day contributes to the range aggregate.
+// -----------------------------------------------------------------------------
+static RangeValues rangeValuesOf(const DailyRecord &record) {
+    RangeValues values;
+    values.calories = record.totals.calories;
+    values.carbs = record.totals.carbs;
+    values.protein = record.totals.protein;
+    values.fat = record.totals.fat;
+    values.entries = static_cast<int64_t>(record.rows.size());
+    values.loggedDays = record.rows.empty() ? 0 : 1;
+    return values;
+}
+
+// The same for a day in the data file's index.
+static RangeValues rangeValuesOf(const BinaryDayEntry &entry) {
+    RangeValues values;
+    values.calories = entry.calories;
+    values.carbs = entry.carbs;
+    values.protein = entry.protein;
+    values.fat = entry.fat;
+    values.entries = entry.foodCount;
+    values.loggedDays = entry.foodCount == 0 ? 0 : 1;
+    return values;
+}
+
+// -----------------------------------------------------------------------------
+// Helpers: addToTotals
+// Purpose: Add one food, or one indexed day, to column sums; 'sign' -1
+//          takes the food away again.
+// -----------------------------------------------------------------------------
+static void addToTotals(ColumnTotals &totals, const Food &food, int64_t sign) {
+    totals.values[COLUMN_CALORIES] += sign * food.calories;
+    totals.values[COLUMN_CARBS] += sign * food.carbs;
+    totals.values[COLUMN_PROTEIN] += sign * food.protein;
+    totals.values[COLUMN_FAT] += sign * food.fat;
+    totals.values[COLUMN_GRAMS] += sign * food.grams;
+}
+
+static void addToTotals(ColumnTotals &totals, const BinaryDayEntry &entry) {
+    totals.values[COLUMN_CALORIES] += entry.calories;
+    totals.values[COLUMN_CARBS] += entry.carbs;
+    totals.values[COLUMN_PROTEIN] += entry.protein;
+    totals.values[COLUMN_FAT] += entry.fat;
+    totals.values[COLUMN_GRAMS] += entry.grams;
+}
 
 // -----------------------------------------------------------------------------
 // Constructor: DataManager
 // Purpose: Initialize default daily nutritional goals and set firstRun flag.
 // -----------------------------------------------------------------------------
-DataManager::DataManager() : firstRun(false) {
+DataManager::DataManager() : DataManager(DataFiles::defaults()) {
+}
+
+DataManager::DataManager(const DataFiles &dataFiles)
+    : files(dataFiles), firstRun(false), loader(LOADER_PARALLEL), loaderThreads(0), journal(dataFiles.journal), generation(0),
+      store(dataFiles.binary), persistence(journal, store), unsavedChanges(0),
+      seenFailures(0), aggregateCurrent(false), changeCount(0), useClock(0), evictAbove(RESIDENT_DAY_LIMIT), evictionSaved(0),
+      storeOutdated(false), emptyRecord(Date(), columns) {
+    journal.setSyncInterval(JOURNAL_SYNC_INTERVAL_MS);
+    journal.setHeader(journalHeader());
     // Set default nutritional goals in case no data exists from a previous run.
     dailyGoals.calories = 2000;
     dailyGoals.carbs = 250;
     dailyGoals.protein = 150;
     dailyGoals.fat = 70;
+    publishGoals();
 }
 
 // -----------------------------------------------------------------------------
 // Destructor: DataManager
-// Purpose: Clean up any allocated resources (none needed here).
+// Purpose: Compact any journaled changes into the data file on exit. The
+//          persistence worker is destroyed next and finishes its queue first.
 // -----------------------------------------------------------------------------
 DataManager::~DataManager() {
-    // No dynamic memory to cleanup.
+    if (unsavedChanges > 0)
+        saveData();
+}
+
+// -----------------------------------------------------------------------------
+// Helper: parseFood
+// Purpose: Parses the '|' delimited layout produced by formatFood.
+// -----------------------------------------------------------------------------
+static Food parseFood(const std::string &foodStr) {
+    std::istringstream iss(foodStr);
+    std::string token;
+    Food food;
+    // Tokenize the food data using the '|' delimiter.
+    if (std::getline(iss, token, '|'))
+        food.setName(token);
+    if (std::getline(iss, token, '|'))
+        food.calories = std::stoi(token);
+    if (std::getline(iss, token, '|'))
+        food.carbs = std::stoi(token);
+    if (std::getline(iss, token, '|'))
+        food.protein = std::stoi(token);
+    if (std::getline(iss, token, '|'))
+        food.fat = std::stoi(token);
+    if (std::getline(iss, token, '|'))
+        food.grams = std::stoi(token);
+    return food;
+}
+
+// -----------------------------------------------------------------------------
+// Functions: DataFiles::defaults / DataFiles::forProfile
+// Purpose: File names for the default data set and for a named profile.
+// -----------------------------------------------------------------------------
+DataFiles DataFiles::defaults() {
+    return DataFiles{ DATA_FILE, BINARY_DATA_FILE, JOURNAL_FILE };
+}
+
+// Inserts ".<profile>" before the extension of 'path'.
+static std::string profilePath(const std::string &path, const std::string &profile) {
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos)
+        return path + "." + profile;
+    return path.substr(0, dot) + "." + profile + path.substr(dot);
+}
+
+DataFiles DataFiles::forProfile(const std::string &profile) {
+    return DataFiles{ profilePath(DATA_FILE, profile), profilePath(BINARY_DATA_FILE, profile),
+                      profilePath(JOURNAL_FILE, profile) };
+}
+
+// -----------------------------------------------------------------------------
+// Method: dataFiles
+// Purpose: Returns the paths given to the constructor.
+// -----------------------------------------------------------------------------
+const DataFiles &DataManager::dataFiles() const {
+    return files;
 }
 
 // -----------------------------------------------------------------------------
@@ -48,47 +239,499 @@ DailyGoals DataManager::getDailyGoals() const {
 // -----------------------------------------------------------------------------
 void DataManager::setDailyGoals(const DailyGoals &goals) {
     dailyGoals = goals;
+    publishGoals();
+    std::ostringstream oss;
+    oss << "DAILY_GOALS: " << goals.calories << "," << goals.carbs << ","
+        << goals.protein << "," << goals.fat;
+    logChange(oss.str());
+}
+
+// -----------------------------------------------------------------------------
+// Method: addFood
+// Purpose: Appends a food entry to the given day and journals the change.
+// -----------------------------------------------------------------------------
+void DataManager::addFood(Date date, const Food &food) {
+    DailyRecord &record = getRecord(date);
+    RangeValues before = rangeValuesOf(record);
+    record.addFood(food);
+    record.checkTotals();
+    ColumnTotals change;
+    addToTotals(change, food, 1);
+    updateAggregate(date, before, record, change);
+    publishDay(record);
+    logChange("ADD: " + date.toString() + "|" + formatFood(food));
+}
+
+// -----------------------------------------------------------------------------
+// Method: updateFood
+// Purpose: Replaces the food entry at 'index' for the given day and journals it.
+// -----------------------------------------------------------------------------
+void DataManager::updateFood(Date date, size_t index, const Food &food) {
+    DailyRecord *existing = existingRecord(date);
+    if (!existing || index >= existing->foodCount())
+        return;
+    DailyRecord &record = *existing;
+    RangeValues before = rangeValuesOf(record);
+    ColumnTotals change;
+    addToTotals(change, record.foods()[index], -1);
+    addToTotals(change, food, 1);
+    record.replaceFood(index, food);
+    record.checkTotals();
+    updateAggregate(date, before, record, change);
+    publishDay(record);
+    repackColumnsIfSparse();
+    logChange("EDIT: " + date.toString() + "|" + std::to_string(index) + "|" + formatFood(food));
+}
+
+// -----------------------------------------------------------------------------
+// Method: removeFood
+// Purpose: Deletes the food entry at 'index' for the given day and journals it.
+// -----------------------------------------------------------------------------
+void DataManager::removeFood(Date date, size_t index) {
+    DailyRecord *existing = existingRecord(date);
+    if (!existing || index >= existing->foodCount())
+        return;
+    DailyRecord &record = *existing;
+    RangeValues before = rangeValuesOf(record);
+    ColumnTotals change;
+    addToTotals(change, record.foods()[index], -1);
+    record.removeFood(index);
+    record.checkTotals();
+    updateAggregate(date, before, record, change);
+    publishDay(record);
+    repackColumnsIfSparse();
+    logChange("DEL: " + date.toString() + "|" + std::to_string(index));
+}
+
+// -----------------------------------------------------------------------------
+// Method: logChange
+// Purpose: Queues one change for the journal. Once enough records pile up the
+//          journal is compacted into the data file so replay stays short.
+//          Days changed before the last completed compaction may then be
+//          evicted.
+// -----------------------------------------------------------------------------
+void DataManager::logChange(const std::string &payload) {
+    persistence.appendChange(payload);
+    unsavedChanges++;
+    uint32_t failures = persistence.failureCount();
+    if (failures != seenFailures) {
+        // A background write failed; a full snapshot saves what it lost.
+        seenFailures = failures;
+        queueSnapshot();
+    } else if (unsavedChanges >= JOURNAL_COMPACT_THRESHOLD) {
+        queueSnapshot();
+    }
+    evictColdDays();
 }
 
 // -----------------------------------------------------------------------------
 // Method: getRecord
 // Purpose: Retrieves or creates a DailyRecord for the specified date.
 // -----------------------------------------------------------------------------
-DailyRecord &DataManager::getRecord(const std::string &date) {
-    // Loop through existing records to find one matching the date.
-    for (auto &record : records) {
-        if (record.date == date) {
-            return record;
+DailyRecord &DataManager::getRecord(Date date) {
+    DailyRecord *record = residentRecord(date);
+    if (!record) {
+        // unordered_map never relocates its elements, so references handed
+        // out earlier stay valid.
+        record = &records.emplace(date, DailyRecord(date, columns)).first->second;
+        record->lastUse = ++useClock;
+    }
+    record->changedAt = ++changeCount;
+    return *record;
+}
+
+// -----------------------------------------------------------------------------
+// Method: existingRecord
+// Purpose: Lookup that never creates a record.
+// -----------------------------------------------------------------------------
+DailyRecord *DataManager::existingRecord(Date date) {
+    DailyRecord *record = residentRecord(date);
+    if (record)
+        record->changedAt = ++changeCount;
+    return record;
+}
+
+// -----------------------------------------------------------------------------
+// Method: residentRecord
+// Purpose: A hash lookup for a day in memory. Any other day is looked up in
+//          the data file's index and, if it is there, decoded into a new
+//          record that counts as unchanged; its sums move from storedTotals
+//          to the column store.
+// -----------------------------------------------------------------------------
+DailyRecord *DataManager::residentRecord(Date date) {
+    auto it = records.find(date);
+    if (it != records.end()) {
+        it->second.lastUse = ++useClock;
+        return &it->second;
+    }
+    std::vector<Food> foods;
+    std::shared_ptr<const StoredFile> file = store.file();
+    if (!file || !file->loadDay(date, foods))
+        return nullptr;
+    DailyRecord &record = records.emplace(date, DailyRecord(date, columns)).first->second;
+    record.lastUse = ++useClock;
+    record.rows.reserve(foods.size());
+    for (const Food &food : foods) {
+        record.addFood(food);
+        addToTotals(storedTotals, food, -1);
+    }
+    evictColdDays();
+    return &record;
+}
+
+// -----------------------------------------------------------------------------
+// Method: evictColdDays
+// Purpose: Only days whose last change is in the saved data file can be
+//          dropped, since they are read back from it. Evicting works down to
+//          three quarters of the limit so it does not run on every lookup;
+//          if too few days are unchanged, the next attempt waits until the
+//          resident count doubles or a save completes.
+// -----------------------------------------------------------------------------
+void DataManager::evictColdDays() {
+    uint64_t saved = store.savedChangeCount();
+    // Loaded after the count, so it holds at least the changes counted.
+    std::shared_ptr<const StoredFile> file = store.file();
+    if (saved != evictionSaved) {
+        evictionSaved = saved;
+        evictAbove = RESIDENT_DAY_LIMIT;
+    }
+    if (records.size() <= evictAbove)
+        return;
+    std::vector<DailyRecord *> cold;
+    for (auto &entry : records) {
+        if (entry.second.changedAt <= saved && entry.second.lastUse != useClock)
+            cold.push_back(&entry.second);
+    }
+    size_t excess = records.size() - RESIDENT_DAY_LIMIT * 3 / 4;
+    if (cold.size() > excess) {
+        std::nth_element(cold.begin(), cold.begin() + excess, cold.end(),
+                         [](const DailyRecord *a, const DailyRecord *b) { return a->lastUse < b->lastUse; });
+        cold.resize(excess);
+    }
+
+    // A few days are published one path copy each; after an import, when
+    // nearly every day goes, one rebuild is cheaper.
+    std::shared_ptr<const DataSnapshot> current = snapshot();
+    bool rebuild = cold.size() > current->dayCount() / 16;
+    for (DailyRecord *record : cold) {
+        Date date = record->date;
+        for (const Food &food : record->foods())
+            addToTotals(storedTotals, food, 1);
+        for (uint32_t row : record->rows)
+            columns.release(row);
+        if (!rebuild && !record->rows.empty()) {
+            const DaySnapshot *day = current->find(date);
+            if (!day || !day->stored)
+                current = current->withStoredDay(date, file);
         }
+        records.erase(date);
     }
-    // If not found, create a new record and add it to the records vector.
-    records.push_back(DailyRecord(date));
-    return records.back();
+    if (rebuild)
+        publishAll();
+    else
+        std::atomic_store(&published, current);
+    repackColumnsIfSparse();
+    evictAbove = records.size() > RESIDENT_DAY_LIMIT ? records.size() * 2 : RESIDENT_DAY_LIMIT;
+}
+
+// -----------------------------------------------------------------------------
+// Method: findRecord
+// Purpose: Read-only lookup; days without a record share one empty record.
+// -----------------------------------------------------------------------------
+const DailyRecord &DataManager::findRecord(Date date) {
+    DailyRecord *record = residentRecord(date);
+    return record ? *record : emptyRecord;
 }
 
 // -----------------------------------------------------------------------------
 // Method: getAllRecords
-// Purpose: Provides a constant reference to the entire set of daily records.
+// Purpose: Provides a constant reference to the records in memory.
 // -----------------------------------------------------------------------------
-const std::vector<DailyRecord> &DataManager::getAllRecords() const {
+const std::unordered_map<Date, DailyRecord> &DataManager::getAllRecords() const {
     return records;
 }
 
+// -----------------------------------------------------------------------------
+// Method: summarizeHistory
+// Purpose: Returns the running totals; rebuildAggregate computes them and
+//          updateAggregate applies each change.
+// -----------------------------------------------------------------------------
+ColumnTotals DataManager::summarizeHistory() {
+    ensureAggregate();
+    return historyTotals;
+}
+
+// -----------------------------------------------------------------------------
+// Method: repackColumnsIfSparse
+// Purpose: Copies the rows still referenced into a fresh store, record by
+//          record, so each day's entries end up next to each other again.
+//          Records keep pointing at 'columns', which is replaced in place.
+// -----------------------------------------------------------------------------
+void DataManager::repackColumnsIfSparse() {
+    size_t dead = columns.deadRowCount();
+    if (dead < FOOD_BLOCK_ROWS || dead * 2 < columns.rowCount())
+        return;
+    FoodColumns packed;
+    for (auto &entry : records) {
+        for (auto &row : entry.second.rows)
+            row = packed.appendFrom(columns, row);
+    }
+    columns = std::move(packed);
+}
+
+// -----------------------------------------------------------------------------
+// Method: setLoader
+// Purpose: Selects the parser used by subsequent loadData calls.
+// -----------------------------------------------------------------------------
+void DataManager::setLoader(LoaderType type) {
+    loader = type;
+}
+
+// -----------------------------------------------------------------------------
+// Method: setLoaderThreads
+// Purpose: Caps the threads LOADER_PARALLEL parses with.
+// -----------------------------------------------------------------------------
+void DataManager::setLoaderThreads(size_t threads) {
+    loaderThreads = threads;
+}
+
+// -----------------------------------------------------------------------------
+// Method: setSyncInterval
+// Purpose: Passes the sync batching window to the journal.
+// -----------------------------------------------------------------------------
+void DataManager::setSyncInterval(uint32_t milliseconds) {
+    journal.setSyncInterval(milliseconds);
+}
+
+// -----------------------------------------------------------------------------
+// Method: journalHeader
+// Purpose: Tags a journal with the generation its changes apply on top of.
+// -----------------------------------------------------------------------------
+std::string DataManager::journalHeader() const {
+    return "GEN: " + std::to_string(generation);
+}
+
 // -----------------------------------------------------------------------------
 // Method: loadData
 // Purpose: Reads stored data (goals and food entries) from the designated file.
 // -----------------------------------------------------------------------------
 bool DataManager::loadData() {
-    std::ifstream inFile(DATA_FILE);
-    if (!inFile.is_open()) {
-        // File not found implies the application is being run for the first time.
+    bool loaded = loadBinary();
+    bool converted = false;
+    if (!loaded) {
+        // No binary store yet: import the text file so it can be converted below.
+        if (loader == LOADER_PARALLEL)
+            loaded = loadTextParallel();
+        else
+            loaded = (loader == LOADER_MAPPED) ? loadTextMapped() : loadTextStream();
+        converted = loaded;
+    }
+    // Apply changes made after the data file was last written. Changes may
+    // also have been journaled before the data file was ever written.
+    bool damaged = false;
+    bool replayed = replayJournal(damaged);
+    if (!loaded && !replayed) {
+        // Neither file found implies the application is being run for the first time.
         firstRun = true;
         return false;
     }
+    repackColumnsIfSparse();
+    aggregateCurrent = false;  // Built when first asked for; see ensureAggregate
+    publishAll();
+    // First start after upgrading from the text format or an older binary
+    // layout: write the current binary store. A damaged journal tail is
+    // dropped by compacting immediately, so later appends are not hidden
+    // behind it on the next replay.
+    if (converted || damaged || storeOutdated)
+        saveData();
+    storeOutdated = false;
+    // Days read or changed by the replay stay in memory up to the limit.
+    evictColdDays();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: summarizeRange
+// Purpose: Asks the Fenwick tree, which is indexed by day number.
+// -----------------------------------------------------------------------------
+RangeSummary DataManager::summarizeRange(Date from, Date to) {
+    ensureAggregate();
+    return aggregate.query(from.days(), to.days());
+}
+
+// -----------------------------------------------------------------------------
+// Method: summarizeDays
+// Purpose: Reads the aggregate's per-day values; no record is looked up and
+//          no food is summed.
+// -----------------------------------------------------------------------------
+void DataManager::summarizeDays(Date first, size_t count, RangeValues *out) {
+    ensureAggregate();
+    aggregate.perDay(first.days(), count, out);
+}
+
+// -----------------------------------------------------------------------------
+// Method: rebuildAggregate
+// Purpose: Bulk-loads one value per day and builds the tree in O(n). Days
+//          in the data file that are not in memory count with the sums from
+//          the index, so none of their entries is read. The history totals
+//          are one pass over the column store plus those sums.
+// -----------------------------------------------------------------------------
+void DataManager::rebuildAggregate() {
+    aggregate.clear();
+    std::shared_ptr<const StoredFile> file = store.file();
+    aggregate.beginBulk(file ? file->dayCount() : 0);
+    storedTotals = ColumnTotals();
+    if (file) {
+        // The index is in date order, so the aggregate needs no sort.
+        file->forEachDay([this](Date date, const BinaryDayEntry &entry) {
+            if (!records.empty() && records.count(date))
+                return;
+            aggregate.add(date.days(), rangeValuesOf(entry));
+            addToTotals(storedTotals, entry);
+        });
+    }
+    for (const auto &entry : records)
+        aggregate.add(entry.first.days(), rangeValuesOf(entry.second));
+    aggregate.build();
+    historyTotals = columns.sumLive();
+    for (int i = 0; i < FOOD_COLUMN_COUNT; i++)
+        historyTotals.values[i] += storedTotals.values[i];
+}
+
+// -----------------------------------------------------------------------------
+// Method: ensureAggregate
+// Purpose: The aggregate costs a pass over every day in the data file, so
+//          loadData leaves it to the first summary. Changes made before then
+//          skip updateAggregate; the build sees them in the records.
+// -----------------------------------------------------------------------------
+void DataManager::ensureAggregate() {
+    if (aggregateCurrent)
+        return;
+    rebuildAggregate();
+    aggregateCurrent = true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: snapshot
+// Purpose: Readers on any thread load the pointer atomically, so they see
+//          either the old snapshot or the new one.
+// -----------------------------------------------------------------------------
+std::shared_ptr<const DataSnapshot> DataManager::snapshot() const {
+    return std::atomic_load(&published);
+}
+
+// -----------------------------------------------------------------------------
+// Method: publishAll
+// Purpose: Copies every non-empty record into a new snapshot in one pass;
+//          every day of the data file that is not in memory goes in as a
+//          stored day. A day in memory is never older than the file, so it
+//          takes precedence.
+// -----------------------------------------------------------------------------
+void DataManager::publishAll() {
+    int goals[4] = { dailyGoals.calories, dailyGoals.carbs, dailyGoals.protein, dailyGoals.fat };
+    std::vector<DaySnapshot> days;
+    std::shared_ptr<const StoredFile> file = store.file();
+    if (file) {
+        days.reserve(file->dayCount() + records.size());
+        file->forEachDay([this, &days](Date date, const BinaryDayEntry &) {
+            if (records.empty() || !records.count(date))
+                days.push_back(DaySnapshot{ date, std::vector<Food>(), true });
+        });
+    }
+    days.reserve(days.size() + records.size());
+    for (const auto &entry : records) {
+        const DailyRecord &record = entry.second;
+        if (record.rows.empty())
+            continue;
+        FoodListView view = record.foods();
+        days.push_back(DaySnapshot{ record.date, std::vector<Food>(view.begin(), view.end()) });
+    }
+    std::atomic_store(&published, DataSnapshot::build(goals, std::move(days), std::move(file)));
+}
+
+// -----------------------------------------------------------------------------
+// Method: publishDay
+// Purpose: Copies one changed day (O(entries of that day)); every other day
+//          is shared with the previous snapshot.
+// -----------------------------------------------------------------------------
+void DataManager::publishDay(const DailyRecord &record) {
+    FoodListView view = record.foods();
+    std::vector<Food> foods(view.begin(), view.end());
+    std::atomic_store(&published, snapshot()->withDay(record.date, std::move(foods)));
+}
+
+// -----------------------------------------------------------------------------
+// Method: publishGoals
+// Purpose: New goals share every day with the previous snapshot. The
+//          constructor publishes the first, empty snapshot this way.
+// -----------------------------------------------------------------------------
+void DataManager::publishGoals() {
+    int goals[4] = { dailyGoals.calories, dailyGoals.carbs, dailyGoals.protein, dailyGoals.fat };
+    std::shared_ptr<const DataSnapshot> current = snapshot();
+    if (current)
+        std::atomic_store(&published, current->withGoals(goals));
+    else
+        std::atomic_store(&published, std::shared_ptr<const DataSnapshot>(std::make_shared<DataSnapshot>(goals, store.file())));
+}
+
+// -----------------------------------------------------------------------------
+// Method: updateAggregate
+// Purpose: Adds the difference between the day's old and new values, and the
+//          column sums of the entries added less those removed to the
+//          history totals, once the aggregate is built.
+// -----------------------------------------------------------------------------
+void DataManager::updateAggregate(Date date, const RangeValues &before, const DailyRecord &record,
+                                  const ColumnTotals &change) {
+    if (!aggregateCurrent)
+        return;
+    RangeValues delta = rangeValuesOf(record);
+    delta -= before;
+    aggregate.add(date.days(), delta);
+    for (int i = 0; i < FOOD_COLUMN_COUNT; i++)
+        historyTotals.values[i] += change.values[i];
+}
+
+// -----------------------------------------------------------------------------
+// Method: loadBinary
+// Purpose: Reads the goals and generation from the binary store's header.
+//          The days stay in the file: loadData takes their sums from the
+//          index and residentRecord reads one when it is first looked up, so
+//          startup reads no food entries.
+// -----------------------------------------------------------------------------
+bool DataManager::loadBinary() {
+    if (!store.open())
+        return false;
+    std::shared_ptr<const StoredFile> file = store.file();
+    dailyGoals.calories = file->goal(0);
+    dailyGoals.carbs = file->goal(1);
+    dailyGoals.protein = file->goal(2);
+    dailyGoals.fat = file->goal(3);
+    generation = file->generation();
+    journal.setHeader(journalHeader());
+    // A version 1 index has no sums, so every start would read every entry.
+    storeOutdated = !file->hasDayTotals();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: loadTextStream
+// Purpose: Line-by-line parser built on std::getline and string streams.
+// -----------------------------------------------------------------------------
+bool DataManager::loadTextStream() {
+    std::ifstream inFile(files.text);
+    if (!inFile.is_open())
+        return false;
     std::string line;
+    // The record for the current DATE: line is created by its first FOOD:
+    // line, so dates without foods do not become records.
+    Date currentDate;
+    bool dateValid = false;
     DailyRecord *currentRecord = nullptr;
     // Read file line by line and parse different types of data entries.
     while (std::getline(inFile, line)) {
+        // Files edited on Windows end their lines in "\r\n".
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
         if (line.find("DAILY_GOALS:") == 0) {
             // Format: DAILY_GOALS: calories,carbs,protein,fat
             std::string goalsStr = line.substr(12);  // Extract substring after label
@@ -101,31 +744,21 @@ bool DataManager::loadData() {
             // Each new date starts a new daily record.
             std::string dateStr = line.substr(5); // Extract date after "DATE:"
             dateStr.erase(0, dateStr.find_first_not_of(" \t"));  // Trim leading whitespace
-            // Get (or create) the record corresponding to this date.
-            currentRecord = &getRecord(dateStr);
+            // Foods under an unreadable date are skipped.
+            dateValid = Date::parse(dateStr, currentDate);
+            currentRecord = nullptr;
         }
         else if (line.find("FOOD:") == 0) {
-            // Food entry lines, only processed if a valid DailyRecord is active.
-            if (currentRecord) {
+            // Food entry lines, only processed under a valid date.
+            if (dateValid) {
+                if (!currentRecord)
+                    currentRecord = &getRecord(currentDate);
                 std::string foodStr = line.substr(5); // Remove "FOOD:" label
-                std::istringstream iss(foodStr);
-                std::string token;
-                Food food;
-                // Tokenize the food data using the '|' delimiter.
-                if (std::getline(iss, token, '|'))
-                    food.name = token;
-                if (std::getline(iss, token, '|'))
-                    food.calories = std::stoi(token);
-                if (std::getline(iss, token, '|'))
-                    food.carbs = std::stoi(token);
-                if (std::getline(iss, token, '|'))
-                    food.protein = std::stoi(token);
-                if (std::getline(iss, token, '|'))
-                    food.fat = std::stoi(token);
-                if (std::getline(iss, token, '|'))
-                    food.grams = std::stoi(token);
+                // Skip the single space written after the label.
+                if (!foodStr.empty() && foodStr[0] == ' ')
+                    foodStr.erase(0, 1);
                 // Add the food item to the current day's record.
-                currentRecord->foods.push_back(food);
+                currentRecord->addFood(parseFood(foodStr));
             }
         }
     }
@@ -133,30 +766,309 @@ bool DataManager::loadData() {
     return true;
 }
 
+// -----------------------------------------------------------------------------
+// Helper: parseGoalFields
+// Purpose: Reads "calories,carbs,protein,fat"; missing values keep their
+//          previous setting.
+// -----------------------------------------------------------------------------
+static void parseGoalFields(std::string_view fields, DailyGoals &goals) {
+    parseIntField(fields, ',', goals.calories);
+    parseIntField(fields, ',', goals.carbs);
+    parseIntField(fields, ',', goals.protein);
+    parseIntField(fields, ',', goals.fat);
+}
+
+// -----------------------------------------------------------------------------
+// Method: loadTextMapped
+// Purpose: Zero-copy parser. The file is mapped into memory and every line is
+//          handled as a string_view; numbers are read with std::from_chars and
+//          the only allocations are the Food names and new record dates that
+//          the data structures keep.
+// -----------------------------------------------------------------------------
+bool DataManager::loadTextMapped() {
+    MappedFile file;
+    if (!file.open(files.text))
+        return false;
+    std::string_view remaining = file.view();
+    // As in loadTextStream, a date's record is created by its first food.
+    Date currentDate;
+    bool dateValid = false;
+    DailyRecord *currentRecord = nullptr;
+    while (!remaining.empty()) {
+        size_t lineEnd = remaining.find('\n');
+        std::string_view line = remaining.substr(0, lineEnd);
+        remaining.remove_prefix(lineEnd == std::string_view::npos ? remaining.size() : lineEnd + 1);
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+
+        if (line.compare(0, 12, "DAILY_GOALS:") == 0) {
+            // Format: DAILY_GOALS: calories,carbs,protein,fat
+            parseGoalFields(line.substr(12), dailyGoals);
+        }
+        else if (line.compare(0, 5, "DATE:") == 0) {
+            std::string_view dateStr = line.substr(5);
+            size_t start = dateStr.find_first_not_of(" \t");
+            dateStr.remove_prefix(start == std::string_view::npos ? dateStr.size() : start);
+            dateValid = Date::parse(dateStr, currentDate);
+            currentRecord = nullptr;
+        }
+        else if (line.compare(0, 5, "FOOD:") == 0 && dateValid) {
+            if (!currentRecord)
+                currentRecord = &getRecord(currentDate);
+            std::string_view fields = line.substr(5);
+            if (!fields.empty() && fields.front() == ' ')
+                fields.remove_prefix(1);
+            // The name is interned, so it is only copied the first time it is seen.
+            Food food;
+            parseFoodFields(fields, food);
+            currentRecord->addFood(food);
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: totalsOf
+// Purpose: The sums the parser collected for one block.
+// -----------------------------------------------------------------------------
+static DailyTotals totalsOf(const TextChunkDay &day) {
+    DailyTotals totals;
+    totals.calories = day.calories;
+    totals.carbs = day.carbs;
+    totals.protein = day.protein;
+    totals.fat = day.fat;
+    return totals;
+}
+
+// -----------------------------------------------------------------------------
+// Method: loadTextParallel
+// Purpose: Builds exactly what loadTextMapped builds, in four steps:
+//          1. The pieces of the mapped file are parsed concurrently.
+//          2. This thread goes through them in file order: it interns each
+//             piece's distinct names, reserves the piece's rows in the column
+//             store and finds or creates the record of every day. Nothing
+//             here is done per entry.
+//          3. Each piece's thread writes its entries to their rows and fills
+//             the records the piece created, which no other thread touches.
+//          4. Days that were already present when their block was reached
+//             get their rows on this thread, in file order.
+// -----------------------------------------------------------------------------
+bool DataManager::loadTextParallel() {
+    MappedFile file;
+    if (!file.open(files.text))
+        return false;
+    std::vector<TextChunk> chunks;
+    parseTextParallel(file.view(), chunks, loaderThreads);
+    // Sizing the record map once saves most of the cost of creating records.
+    size_t blocks = 0;
+    for (const TextChunk &chunk : chunks)
+        blocks += chunk.days.size();
+    records.reserve(records.size() + blocks);
+
+    NamePool &pool = NamePool::instance();
+    // The record each block created, or nullptr for a day that already existed.
+    std::vector<std::vector<DailyRecord *>> created(chunks.size());
+    for (size_t c = 0; c < chunks.size(); c++) {
+        TextChunk &chunk = chunks[c];
+        for (std::string_view goals : chunk.goalLines)
+            parseGoalFields(goals, dailyGoals);
+        chunk.nameIds.resize(chunk.names.size());
+        for (size_t i = 0; i < chunk.names.size(); i++)
+            chunk.nameIds[i] = pool.intern(chunk.names[i]);
+        chunk.firstRow = columns.appendRows(chunk.foods.size());
+        created[c].resize(chunk.days.size(), nullptr);
+        for (size_t d = 0; d < chunk.days.size(); d++) {
+            size_t known = records.size();
+            DailyRecord &record = getRecord(chunk.days[d].date);
+            if (records.size() > known)
+                created[c][d] = &record;
+        }
+    }
+
+    runPerChunk(chunks.size(), [&chunks, &created, this](size_t c) {
+        const TextChunk &chunk = chunks[c];
+        writeTextChunk(chunk, columns);
+        for (size_t d = 0; d < chunk.days.size(); d++) {
+            if (created[c][d])
+                created[c][d]->appendRows(chunk.firstRow + chunk.days[d].firstFood, chunk.days[d].foodCount,
+                                          totalsOf(chunk.days[d]));
+        }
+    });
+
+    for (size_t c = 0; c < chunks.size(); c++) {
+        const TextChunk &chunk = chunks[c];
+        for (size_t d = 0; d < chunk.days.size(); d++) {
+            if (!created[c][d])
+                getRecord(chunk.days[d].date).appendRows(chunk.firstRow + chunk.days[d].firstFood,
+                                                         chunk.days[d].foodCount, totalsOf(chunk.days[d]));
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: replayJournal
+// Purpose: Applies every intact journal record in order. A journal tagged
+//          with an older generation than the loaded data file was already
+//          folded into it (the save's rename happened, the journal removal
+//          did not) and is discarded. Generations wrap, so "older" means
+//          less than half the counter's range behind.
+//          A journal tagged with any other generation was written on top of
+//          a data file that is not the one loaded: the data file is missing
+//          and the text file was imported, or an older copy was put back.
+//          Its changes are in neither, so they are replayed with a warning
+//          and a copy of the journal is kept, since edits and deletes name
+//          entries by position in a day that may differ here. The data is
+//          then saved at once, which starts a journal that matches.
+// -----------------------------------------------------------------------------
+bool DataManager::replayJournal(bool &damaged) {
+    std::vector<std::string> payloads;
+    if (!journal.replay(payloads, damaged))
+        return false;
+    size_t first = 0;
+    if (!payloads.empty() && payloads[0].compare(0, 5, "GEN: ") == 0) {
+        if (payloads[0] != journalHeader()) {
+            uint16_t tagged = static_cast<uint16_t>(std::strtoul(payloads[0].c_str() + 5, nullptr, 10));
+            uint16_t behind = static_cast<uint16_t>(generation - tagged);
+            if (store.file() && behind != 0 && behind < 0x8000) {
+                journal.reset();
+                damaged = false;
+                return true;
+            }
+            std::string copy = files.journal + ".unmatched";
+            std::error_code error;
+            std::filesystem::copy_file(files.journal, copy, std::filesystem::copy_options::overwrite_existing, error);
+            std::cerr << "Warning: " << files.journal << " was written for another version of the data file. "
+                      << "Its changes were applied" << (error ? "" : "; a copy is in " + copy) << '.' << std::endl;
+            damaged = true;  // Compacts right after loading
+        }
+        first = 1;
+    }
+    for (size_t i = first; i < payloads.size(); i++)
+        applyJournalRecord(payloads[i]);
+    unsavedChanges = payloads.size() - first;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: applyJournalRecord
+// Purpose: Re-executes one journaled change without logging it again.
+//          Formats: "ADD: date|food", "EDIT: date|index|food", "DEL: date|index"
+//          and "DAILY_GOALS: calories,carbs,protein,fat".
+// -----------------------------------------------------------------------------
+void DataManager::applyJournalRecord(const std::string &payload) {
+    try {
+        if (payload.find("DAILY_GOALS:") == 0) {
+            std::string goalsStr = payload.substr(12);
+            std::replace(goalsStr.begin(), goalsStr.end(), ',', ' ');
+            std::istringstream iss(goalsStr);
+            iss >> dailyGoals.calories >> dailyGoals.carbs >> dailyGoals.protein >> dailyGoals.fat;
+            return;
+        }
+        size_t labelEnd = payload.find(": ");
+        if (labelEnd == std::string::npos)
+            return;
+        std::string label = payload.substr(0, labelEnd);
+        std::string body = payload.substr(labelEnd + 2);
+        size_t dateEnd = body.find('|');
+        if (dateEnd == std::string::npos)
+            return;
+        Date date;
+        if (!Date::parse(std::string_view(body).substr(0, dateEnd), date))
+            return;
+        std::string rest = body.substr(dateEnd + 1);
+        if (label == "ADD") {
+            getRecord(date).addFood(parseFood(rest));
+            return;
+        }
+        // Edits and deletes only apply to days that already have entries.
+        DailyRecord *record = existingRecord(date);
+        size_t indexEnd = rest.find('|');
+        size_t index = static_cast<size_t>(std::stoul(rest.substr(0, indexEnd)));
+        if (!record || index >= record->foodCount())
+            return;
+        if (label == "EDIT" && indexEnd != std::string::npos)
+            record->replaceFood(index, parseFood(rest.substr(indexEnd + 1)));
+        else if (label == "DEL")
+            record->removeFood(index);
+    } catch (...) {
+        // A record that passed its checksum but cannot be parsed is skipped.
+    }
+}
+
 // -----------------------------------------------------------------------------
 // Method: saveData
-// Purpose: Writes current daily goals and all daily records to the persistent file.
+// Purpose: Queues a snapshot and waits until the worker has written it.
+//          The published snapshot then reads its stored days from the new
+//          file, so only older snapshots still hold the previous version.
 // -----------------------------------------------------------------------------
 bool DataManager::saveData() {
-    std::ofstream outFile(DATA_FILE);
+    uint32_t failuresBefore = persistence.failureCount();
+    queueSnapshot();
+    persistence.flush();
+    std::atomic_store(&published, snapshot()->withFile(store.file()));
+    seenFailures = persistence.failureCount();
+    return seenFailures == failuresBefore;
+}
+
+// -----------------------------------------------------------------------------
+// Methods: saveInBackground / saving
+// Purpose: A save the caller does not wait for. Nothing is queued without
+//          unsaved changes, as in the destructor.
+// -----------------------------------------------------------------------------
+void DataManager::saveInBackground() {
+    if (unsavedChanges > 0)
+        queueSnapshot();
+}
+
+bool DataManager::saving() const {
+    return !persistence.idle();
+}
+
+// -----------------------------------------------------------------------------
+// Method: queueSnapshot
+// Purpose: The snapshot already holds current daily goals and all daily
+//          records, so handing it over is O(1); the worker encodes it,
+//          replaces the store and then restarts the journal under the new
+//          generation.
+// -----------------------------------------------------------------------------
+void DataManager::queueSnapshot() {
+    // A failed write leaves the old store and journal in place; the journal's
+    // header still matches the old store, so skipping a generation is harmless.
+    generation = static_cast<uint16_t>(generation + 1);
+    persistence.writeSnapshot(snapshot(), generation, changeCount, journalHeader());
+    unsavedChanges = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Method: exportText
+// Purpose: Writes goals and all daily records in the original text format.
+// -----------------------------------------------------------------------------
+bool DataManager::exportText(const std::string &path) const {
+    std::shared_ptr<const DataSnapshot> data = snapshot();
+    std::ofstream outFile(path);
     if (!outFile.is_open()) {
-        std::cerr << "Error saving data!" << std::endl;
+        std::cerr << "Error exporting data!" << std::endl;
         return false;
     }
     // Write the nutritional goals first.
-    outFile << "DAILY_GOALS: " << dailyGoals.calories << "," 
-            << dailyGoals.carbs << "," << dailyGoals.protein << "," 
-            << dailyGoals.fat << std::endl;
-    // Iterate through each days record.
-    for (const auto &record : records) {
-        outFile << "DATE: " << record.date << std::endl;
+    const int *goals = data->goals();
+    outFile << "DAILY_GOALS: " << goals[0] << "," << goals[1] << "," << goals[2] << "," << goals[3] << '\n';
+    // Then every logged day, oldest first.
+    std::vector<const DaySnapshot *> days;
+    data->collectDays(days);
+    bool complete = true;
+    for (const DaySnapshot *day : days) {
+        outFile << "DATE: " << day->date.toString() << '\n';
         // For every food item in the daily record, write the details in a delimited format.
-        for (const auto &food : record.foods) {
-            outFile << "FOOD: " << food.name << "|" << food.calories << "|"
-                    << food.carbs << "|" << food.protein << "|" 
-                    << food.fat << "|" << food.grams << std::endl;
-        }
+        bool read = data->visitFoods(*day, [&outFile](const Food &food, std::string_view name) {
+            outFile << "FOOD: " << formatFood(name, food) << '\n';
+        });
+        if (!read)
+            complete = false;
     }
     outFile.close();
-    return true;
+    if (!complete)
+        std::cerr << "Error exporting data!" << std::endl;
+    return complete && !outFile.fail();
 }
\ No newline at end of file
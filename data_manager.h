@@ -9,7 +9,17 @@
 
 #include <string>
 #include <vector>
-#include "food.h"  // Include definition for the Food structure
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include "food.h"     // Include definition for the Food structure
+#include "food_columns.h"  // Column store behind every DailyRecord
+#include "journal.h"  // Append-only change log used between full saves
+#include "persistence_worker.h"  // Writes the journal and data file off the UI thread
+#include "range_aggregator.h"  // Fenwick tree for multi-day totals
+#include "date.h"     // Day-number date values
+#include "data_snapshot.h"  // Immutable copies of the data for other threads
+#include "day_store.h"  // Data file days are read from on demand
 
 // -----------------------------------------------------------------------------
 // Structure: DailyGoals
@@ -22,16 +32,79 @@ struct DailyGoals {
     int fat;        // Total daily fat (in grams)
 };
 
+// -----------------------------------------------------------------------------
+// Structure: DailyTotals
+// Purpose: Running nutritional totals for one day.
+// -----------------------------------------------------------------------------
+struct DailyTotals {
+    int calories = 0;
+    int carbs = 0;
+    int protein = 0;
+    int fat = 0;
+
+    void add(const Food &food);
+    void subtract(const Food &food);
+};
+
 // -----------------------------------------------------------------------------
 // Structure: DailyRecord
 // Purpose: Represent a single days record including date and all food entries.
+//          The entries themselves live in the shared FoodColumns store; the
+//          record keeps their row ids in order.
 // -----------------------------------------------------------------------------
 struct DailyRecord {
-    std::string date;            // Date string in "DD/MM/YYYY" format
-    std::vector<Food> foods;     // List to store multiple food entries for the day
+    Date date;                   // Day the record belongs to
+    FoodColumns *columns;        // Store holding the rows below
+    std::vector<uint32_t> rows;  // Row ids of the day's entries; change only through the methods below
+    DailyTotals totals;          // Sum of the entries, kept current by the methods below
+    uint64_t lastUse = 0;        // DataManager use clock at the last lookup; the oldest are evicted first
+    uint64_t changedAt = 0;      // DataManager change count when last written to; 0 = as in the data file
 
     // Constructor initializes a new record with the specified date.
-    DailyRecord(const std::string &d) : date(d) {}
+    DailyRecord(Date d, FoodColumns &c) : date(d), columns(&c) {}
+
+    // Read-only list of the day's entries, indexed like a std::vector<Food>.
+    FoodListView foods() const { return FoodListView(*columns, rows); }
+    size_t foodCount() const { return rows.size(); }
+
+    // Each of these updates 'totals' in O(1) along with the entries. Replaced
+    // and removed entries are released in the store.
+    void addFood(const Food &food);
+    void replaceFood(size_t index, const Food &food);
+    void removeFood(size_t index);
+    // Adds 'count' consecutive rows already in the store, whose entries sum
+    // to 'sum'. Used by the parallel loader, which fills the rows afterwards.
+    void appendRows(uint32_t firstRow, uint32_t count, const DailyTotals &sum);
+
+    // Debug builds recompute the totals from the entries and assert they
+    // match. Compiled out when NDEBUG is defined.
+    void checkTotals() const;
+};
+
+// -----------------------------------------------------------------------------
+// Structure: DataFiles
+// Purpose: The files one DataManager reads and writes.
+// -----------------------------------------------------------------------------
+struct DataFiles {
+    std::string text;     // Text import/export file
+    std::string binary;   // Binary store written by saveData
+    std::string journal;  // Changes since the binary store was last written
+
+    // DATA_FILE, BINARY_DATA_FILE and JOURNAL_FILE.
+    static DataFiles defaults();
+    // The default names with ".<profile>" before the extension,
+    // e.g. "calorie_data.alice.bin".
+    static DataFiles forProfile(const std::string &profile);
+};
+
+// -----------------------------------------------------------------------------
+// Enum: LoaderType
+// Purpose: Select the parser loadData uses for the text data file.
+// -----------------------------------------------------------------------------
+enum LoaderType {
+    LOADER_STREAM,  // Line-by-line std::getline / istringstream parser
+    LOADER_MAPPED,  // Memory-mapped parser using std::from_chars over string_views
+    LOADER_PARALLEL // The mapped parser run on pieces of the file split at DATE: lines, one thread each
 };
 
 // -----------------------------------------------------------------------------
@@ -41,17 +114,54 @@ struct DailyRecord {
 // -----------------------------------------------------------------------------
 class DataManager {
 public:
+    // Uses DataFiles::defaults().
     DataManager();
+    explicit DataManager(const DataFiles &files);
     ~DataManager();
 
+    // The files this instance reads and writes.
+    const DataFiles &dataFiles() const;
+
     // Attempts to load data from the persistent file.
     // Returns true if data is successfully loaded.
     bool loadData();
 
-    // Saves all current data (goals and records) to the persistent file.
+    // Chooses the parser used by loadData (defaults to LOADER_PARALLEL).
+    void setLoader(LoaderType type);
+
+    // Most threads LOADER_PARALLEL uses; 0 (the default) is one per
+    // hardware thread.
+    void setLoaderThreads(size_t threads);
+
+    // How long a journaled change may wait for a device sync while more
+    // changes arrive (see Journal::setSyncInterval). Defaults to
+    // JOURNAL_SYNC_INTERVAL_MS; 0 syncs every change. Call before the first
+    // change, after which the journal belongs to the persistence worker.
+    void setSyncInterval(uint32_t milliseconds);
+
+    // Saves all current data (goals and records) to the binary store and
+    // clears the journal, since its changes are now part of the file. The
+    // store is replaced atomically and synced, so a crash at any point leaves
+    // either the old file plus the journal or the new file. Waits for the
+    // persistence worker to finish every earlier write as well.
     // Returns true if saving was successful.
     bool saveData();
 
+    // Queues the same save as saveData but returns at once. saving() tells
+    // when it and every change before it are written; the destructor waits
+    // for them either way. Used to unload a profile without waiting.
+    void saveInBackground();
+    bool saving() const;
+
+    // Writes all data in the text format (DAILY_GOALS:/DATE:/FOOD: lines) to
+    // 'path'. Reads a snapshot, so it may run on any thread.
+    bool exportText(const std::string &path) const;
+
+    // The goals and days as of the last change, in O(1). The snapshot never
+    // changes, so it can be read on any thread, without locks, while this
+    // DataManager goes on changing. May be called from any thread.
+    std::shared_ptr<const DataSnapshot> snapshot() const;
+
     // Determines whether this is the first run of the application by checking file existence.
     bool isFirstRun() const;
 
@@ -59,19 +169,128 @@ public:
     DailyGoals getDailyGoals() const;
     void setDailyGoals(const DailyGoals &goals);
 
-    // Retrieves the record for the given date. If it does not exist, creates a new record.
-    DailyRecord &getRecord(const std::string &date);
+    // Food entry changes. Each one updates memory and queues a single journal
+    // record for the persistence worker instead of rewriting the whole data
+    // file, so none of them waits for the disk.
+    void addFood(Date date, const Food &food);
+    void updateFood(Date date, size_t index, const Food &food);
+    void removeFood(Date date, size_t index);
+
+    // Read-only lookup of the record for the given date, O(1) for a day in
+    // memory; a day left in the data file is read in first. A day with no
+    // record yields a shared empty record instead; nothing is created, so
+    // browsing dates leaves the data untouched. The reference stays valid
+    // until a day that is not in memory is looked up or changed, which may
+    // evict the least recently used days.
+    const DailyRecord &findRecord(Date date);
+
+    // The records currently in memory: the most recently used days and every
+    // day changed since the last save. The rest are in the data file, and
+    // snapshot() lists both.
+    const std::unordered_map<Date, DailyRecord> &getAllRecords() const;
+
+    // The summaries below are served by per-day totals of every logged day,
+    // built by the first of them called after loadData, so loading (and
+    // switching to a profile) does not wait for them, and kept current from
+    // then on by the food entry changes above.
 
-    // Provides a constant reference to all stored daily records.
-    const std::vector<DailyRecord> &getAllRecords() const;
+    // Totals of every food entry ever logged, shown under the calendar, in
+    // O(1): kept as running sums next to the per-day totals.
+    ColumnTotals summarizeHistory();
+
+    // Totals over every day from 'from' to 'to' inclusive, answered in
+    // O(log n).
+    RangeSummary summarizeRange(Date from, Date to);
+
+    // Totals and entry count of each of 'count' days starting at 'first',
+    // written to out[0..count). Serves a calendar month in one call.
+    void summarizeDays(Date first, size_t count, RangeValues *out);
 
 private:
+    DataFiles files;                    // Where this instance's data lives
     DailyGoals dailyGoals;              // User's nutritional goals to be achieved in a day
-    std::vector<DailyRecord> records;   // Container holding records for multiple days
+    std::unordered_map<Date, DailyRecord> records;  // Days in memory; node-based, so references survive growth
     bool firstRun;                      // Flag: true if data file not found, i.e., first run
+    LoaderType loader;                  // Parser selected for loadData
+    size_t loaderThreads;               // Thread limit of LOADER_PARALLEL, 0 for one per hardware thread
+    Journal journal;                    // Write-ahead log of changes since the last full save
+    uint16_t generation;                // Save count stored in the binary store and the journal header
+    DayStore store;                     // files.binary; replaced by 'persistence', versions held by snapshots
+    PersistenceWorker persistence;      // Writes 'journal' and files.binary in the background
+    size_t unsavedChanges;              // Changes journaled since the last snapshot was queued
+    uint32_t seenFailures;              // persistence.failureCount() when last checked
+    RangeAggregator aggregate;          // Per-day totals indexed by day number
+    bool aggregateCurrent;              // 'aggregate', 'storedTotals' and 'historyTotals' are built and kept up to date
+    FoodColumns columns;                // Food entries of every record, column by column
+    uint64_t changeCount;               // Record changes so far; see DailyRecord::changedAt
+    uint64_t useClock;                  // Record lookups so far; see DailyRecord::lastUse
+    ColumnTotals storedTotals;          // Sums of the data file's days that are not in memory
+    ColumnTotals historyTotals;         // Sums of every food entry, served by summarizeHistory
+    size_t evictAbove;                  // Resident day count that triggers the next eviction
+    uint64_t evictionSaved;             // store->savedChangeCount() at the last eviction
+    bool storeOutdated;                 // files.binary has an older layout and is rewritten after loading
+    DailyRecord emptyRecord;            // Returned by findRecord for days without a record
+    std::shared_ptr<const DataSnapshot> published;  // Latest snapshot; only accessed through std::atomic_load/store
+
+    // Retrieves the record for the given date, creating it if it does not
+    // exist. Only used on the way to writing an entry, so days exist only
+    // once something has been logged on them. Marks the record changed.
+    DailyRecord &getRecord(Date date);
+    // The record for 'date', marked changed, or nullptr if it has none.
+    DailyRecord *existingRecord(Date date);
+    // The record for 'date', read from the data file if it is not in memory,
+    // or nullptr if the day has none. Stamps it as the most recently used.
+    DailyRecord *residentRecord(Date date);
+    // Once more than RESIDENT_DAY_LIMIT days are in memory, drops the least
+    // recently used ones that are unchanged since the last save, keeping
+    // the one looked up last, and publishes them as stored days.
+    void evictColdDays();
 
     // Helper function to parse a single line from the data file and update internal structures.
     void parseDataLine(const std::string &line);
+
+    // Rewrites the column store with only the rows the records still use,
+    // once released rows outnumber live ones.
+    void repackColumnsIfSparse();
+
+    // Refills the aggregate, storedTotals and historyTotals from the data
+    // file's index and every record, after loading.
+    void rebuildAggregate();
+    // Builds them if loadData left them out of date.
+    void ensureAggregate();
+    // Replaces the published snapshot: from every record and stored day
+    // after loading, or with one changed day or new goals after an edit.
+    void publishAll();
+    void publishDay(const DailyRecord &record);
+    void publishGoals();
+    // Applies the change to one day's totals, given its values before the
+    // change, and 'change', the column sums of the entries added less those
+    // removed, to historyTotals.
+    void updateAggregate(Date date, const RangeValues &before, const DailyRecord &record,
+                         const ColumnTotals &change);
+
+    // Opens files.binary and reads its header; days are read on demand.
+    // Returns false if it is missing or invalid.
+    bool loadBinary();
+
+    // Parse files.text with the selected loader. Return false if the file cannot be opened.
+    bool loadTextStream();
+    bool loadTextMapped();
+    bool loadTextParallel();
+
+    // First record of a journal that applies on top of the current generation.
+    std::string journalHeader() const;
+    // Queues a change for the journal, and a snapshot once the journal grows
+    // too large or a background write has failed.
+    void logChange(const std::string &payload);
+    // Hands the current snapshot to the persistence worker, which encodes and
+    // writes it under the next generation.
+    void queueSnapshot();
+    // Replays journaled changes on top of the loaded data. Sets 'damaged' if
+    // the journal ends in a damaged record. Returns false if no journal exists.
+    bool replayJournal(bool &damaged);
+    // Applies one replayed journal record to the in-memory data.
+    void applyJournalRecord(const std::string &payload);
 };
 
 #endif // DATA_MANAGER_H
@@ -0,0 +1,220 @@
+#include "data_snapshot.h"
+#include "day_store.h"  // StoredFile, which reads stored days
+#include <utility>
+
+// -----------------------------------------------------------------------------
+// Structure: TrieNode
+// Purpose: 64 slots of one trie level. Levels are distinct types, so a slot
+//          always holds the right kind of child.
+// -----------------------------------------------------------------------------
+template <class Child>
+struct TrieNode {
+    std::shared_ptr<const Child> slots[64];
+};
+
+typedef TrieNode<DaySnapshot> SnapshotPage;  // 64 consecutive days
+typedef TrieNode<SnapshotPage> SnapshotLevel2;
+typedef TrieNode<SnapshotLevel2> SnapshotLevel1;
+struct SnapshotRoot : TrieNode<SnapshotLevel1> {};
+
+// Trie key of the first valid Date; keys of valid dates fit in 22 bits.
+static const int32_t FIRST_KEY_DAY = Date::fromCivil(1, 1, 1).days();
+
+static uint32_t keyOf(Date date) {
+    return static_cast<uint32_t>(date.days() - FIRST_KEY_DAY);
+}
+
+// Slot of 'key' in the node at a level: 3 for the root, 0 for a page.
+static size_t slotOf(uint32_t key, int level) {
+    return (key >> (6 * level)) & 63;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: copyOf
+// Purpose: A private, writable copy of a node, or a new empty node. Copying
+//          the slots shares every child with the original.
+// -----------------------------------------------------------------------------
+template <class Node>
+static std::shared_ptr<Node> copyOf(const std::shared_ptr<const Node> &node) {
+    return node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+}
+
+// -----------------------------------------------------------------------------
+// Constructor: DataSnapshot
+// Purpose: An empty day map with the given goals.
+// -----------------------------------------------------------------------------
+DataSnapshot::DataSnapshot(const int goals[4], std::shared_ptr<const StoredFile> storedFile)
+    : days(0), file(std::move(storedFile)) {
+    for (int i = 0; i < 4; i++)
+        goalValues[i] = goals[i];
+}
+
+// -----------------------------------------------------------------------------
+// Method: find
+// Purpose: Walks the four levels; a missing node means no day below it.
+// -----------------------------------------------------------------------------
+const DaySnapshot *DataSnapshot::find(Date date) const {
+    if (!root)
+        return nullptr;
+    uint32_t key = keyOf(date);
+    const SnapshotLevel1 *level1 = root->slots[slotOf(key, 3)].get();
+    if (!level1)
+        return nullptr;
+    const SnapshotLevel2 *level2 = level1->slots[slotOf(key, 2)].get();
+    if (!level2)
+        return nullptr;
+    const SnapshotPage *page = level2->slots[slotOf(key, 1)].get();
+    if (!page)
+        return nullptr;
+    return page->slots[slotOf(key, 0)].get();
+}
+
+// -----------------------------------------------------------------------------
+// Method: collectDays
+// Purpose: Slots are in key order, so a depth-first walk yields date order.
+// -----------------------------------------------------------------------------
+void DataSnapshot::collectDays(std::vector<const DaySnapshot *> &out) const {
+    if (!root)
+        return;
+    out.reserve(out.size() + days);
+    for (const auto &level1 : root->slots) {
+        if (!level1)
+            continue;
+        for (const auto &level2 : level1->slots) {
+            if (!level2)
+                continue;
+            for (const auto &page : level2->slots) {
+                if (!page)
+                    continue;
+                for (const auto &day : page->slots) {
+                    if (day)
+                        out.push_back(day.get());
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Method: visitFoods
+// Purpose: Entries in memory are visited with their pooled names; a stored
+//          day is read from the file version the snapshot holds.
+// -----------------------------------------------------------------------------
+bool DataSnapshot::visitFoods(const DaySnapshot &day, const FoodVisitor &visitor) const {
+    if (day.stored)
+        return file && file->visitDay(day.date, visitor);
+    const NamePool &pool = NamePool::instance();
+    for (const Food &food : day.foods)
+        visitor(food, pool.text(food.nameId));
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Methods: withDay / withStoredDay
+// Purpose: Wrap the day's new contents for withDaySnapshot.
+// -----------------------------------------------------------------------------
+std::shared_ptr<const DataSnapshot> DataSnapshot::withDay(Date date, std::vector<Food> foods) const {
+    std::shared_ptr<const DaySnapshot> day;
+    if (!foods.empty())
+        day = std::make_shared<DaySnapshot>(DaySnapshot{ date, std::move(foods) });
+    return withDaySnapshot(date, std::move(day));
+}
+
+std::shared_ptr<const DataSnapshot> DataSnapshot::withStoredDay(Date date, std::shared_ptr<const StoredFile> storedFile) const {
+    std::shared_ptr<DataSnapshot> result =
+        withDaySnapshot(date, std::make_shared<DaySnapshot>(DaySnapshot{ date, std::vector<Food>(), true }));
+    result->file = std::move(storedFile);
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// Method: withFile
+// Purpose: Shares the whole trie; only the file version differs.
+// -----------------------------------------------------------------------------
+std::shared_ptr<const DataSnapshot> DataSnapshot::withFile(std::shared_ptr<const StoredFile> storedFile) const {
+    std::shared_ptr<DataSnapshot> result = std::make_shared<DataSnapshot>(*this);
+    result->file = std::move(storedFile);
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// Method: withDaySnapshot
+// Purpose: Path copy: the root, the two inner nodes and the page above the
+//          day are copied and relinked; everything else is shared.
+// -----------------------------------------------------------------------------
+std::shared_ptr<DataSnapshot> DataSnapshot::withDaySnapshot(Date date, std::shared_ptr<const DaySnapshot> day) const {
+    uint32_t key = keyOf(date);
+    std::shared_ptr<SnapshotRoot> newRoot = copyOf(root);
+    std::shared_ptr<SnapshotLevel1> level1 = copyOf(newRoot->slots[slotOf(key, 3)]);
+    std::shared_ptr<SnapshotLevel2> level2 = copyOf(level1->slots[slotOf(key, 2)]);
+    std::shared_ptr<SnapshotPage> page = copyOf(level2->slots[slotOf(key, 1)]);
+
+    std::shared_ptr<DataSnapshot> result = std::make_shared<DataSnapshot>(*this);
+    std::shared_ptr<const DaySnapshot> &slot = page->slots[slotOf(key, 0)];
+    result->days = days - (slot ? 1 : 0) + (day ? 1 : 0);
+    slot = std::move(day);
+    level2->slots[slotOf(key, 1)] = std::move(page);
+    level1->slots[slotOf(key, 2)] = std::move(level2);
+    newRoot->slots[slotOf(key, 3)] = std::move(level1);
+    result->root = std::move(newRoot);
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// Method: withGoals
+// Purpose: Shares the whole trie; only the goals differ.
+// -----------------------------------------------------------------------------
+std::shared_ptr<const DataSnapshot> DataSnapshot::withGoals(const int goals[4]) const {
+    std::shared_ptr<DataSnapshot> result = std::make_shared<DataSnapshot>(*this);
+    for (int i = 0; i < 4; i++)
+        result->goalValues[i] = goals[i];
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// Method: build
+// Purpose: Inserts every day into nodes that nothing else references yet, so
+//          they are filled in place instead of copied per day. Stored days
+//          hold no entries and are never changed in place, so they share one
+//          allocation instead of one each; a large data file has one per
+//          logged day.
+// -----------------------------------------------------------------------------
+std::shared_ptr<const DataSnapshot> DataSnapshot::build(const int goals[4], std::vector<DaySnapshot> daysInput,
+                                                        std::shared_ptr<const StoredFile> file) {
+    std::shared_ptr<DataSnapshot> result = std::make_shared<DataSnapshot>(goals, std::move(file));
+    std::shared_ptr<SnapshotRoot> newRoot = std::make_shared<SnapshotRoot>();
+    // Stored days stay where they are in the input vector, which their slots
+    // keep alive; days in memory are moved out to their own allocations.
+    std::shared_ptr<std::vector<DaySnapshot>> storedDays =
+        std::make_shared<std::vector<DaySnapshot>>(std::move(daysInput));
+    for (DaySnapshot &input : *storedDays) {
+        if (input.foods.empty() && !input.stored)
+            continue;
+        uint32_t key = keyOf(input.date);
+        // The nodes are still private to this call, so dropping const to fill
+        // them is safe.
+        std::shared_ptr<const SnapshotLevel1> &level1Slot = newRoot->slots[slotOf(key, 3)];
+        if (!level1Slot)
+            level1Slot = std::make_shared<SnapshotLevel1>();
+        SnapshotLevel1 &level1 = const_cast<SnapshotLevel1 &>(*level1Slot);
+        std::shared_ptr<const SnapshotLevel2> &level2Slot = level1.slots[slotOf(key, 2)];
+        if (!level2Slot)
+            level2Slot = std::make_shared<SnapshotLevel2>();
+        SnapshotLevel2 &level2 = const_cast<SnapshotLevel2 &>(*level2Slot);
+        std::shared_ptr<const SnapshotPage> &pageSlot = level2.slots[slotOf(key, 1)];
+        if (!pageSlot)
+            pageSlot = std::make_shared<SnapshotPage>();
+        SnapshotPage &page = const_cast<SnapshotPage &>(*pageSlot);
+        std::shared_ptr<const DaySnapshot> &slot = page.slots[slotOf(key, 0)];
+        if (!slot)
+            result->days++;
+        if (input.stored) {
+            slot = std::shared_ptr<const DaySnapshot>(storedDays, &input);
+        } else {
+            slot = std::make_shared<DaySnapshot>(std::move(input));
+        }
+    }
+    if (result->days > 0)
+        result->root = std::move(newRoot);
+    return result;
+}
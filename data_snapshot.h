@@ -0,0 +1,107 @@
+#ifndef DATA_SNAPSHOT_H
+#define DATA_SNAPSHOT_H
+
+// -----------------------------------------------------------------------------
+// File: data_snapshot.h
+// Purpose: Declare DataSnapshot, an immutable view of a DataManager's goals
+//          and days that other threads can read while the data changes.
+// -----------------------------------------------------------------------------
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include "food.h"
+#include "date.h"
+
+// -----------------------------------------------------------------------------
+// Structure: DaySnapshot
+// Purpose: The food entries of one logged day, frozen at the time it was
+//          published. Shared by every snapshot in which the day is unchanged.
+//          A stored day was not in memory when it was published: 'foods' is
+//          empty and the entries are read from the data file on demand (see
+//          DataSnapshot::visitFoods).
+// -----------------------------------------------------------------------------
+struct DaySnapshot {
+    Date date;
+    std::vector<Food> foods;  // Never empty unless 'stored'; days without entries are left out
+    bool stored = false;      // Entries are in the data file, not in 'foods'
+};
+
+// Called for each entry of a day, with the entry's name text.
+typedef std::function<void(const Food &food, std::string_view name)> FoodVisitor;
+
+struct SnapshotRoot;  // Top node of the day trie, defined in data_snapshot.cpp
+class StoredFile;     // Data file version holding the stored days, see day_store.h
+
+// -----------------------------------------------------------------------------
+// Class: DataSnapshot
+// Purpose: Goals plus a persistent map from date to DaySnapshot. The map is a
+//          four-level trie, 64 slots a node, over the day number counted
+//          from 01/01/0001, so it covers every valid Date.
+//          - Nothing in a snapshot changes after it is built, so any number of
+//            threads may read it without locks.
+//          - Changing a day builds a new snapshot that copies only the four
+//            nodes on the path to that day and shares every other node and
+//            day with the old one. Holding on to an old snapshot is O(1).
+//          Food names are read through NamePool::text, which is safe from any
+//          thread for the ids a snapshot holds.
+//          Stored days are read from the StoredFile the snapshot holds, the
+//          version of the data file it was published against. Saving writes
+//          a new version and leaves that one open, so a snapshot reads the
+//          same entries however long it is kept. A stored day is only
+//          published while it matches the current file, and every later save
+//          keeps it unchanged, so any version saved since holds it too.
+// -----------------------------------------------------------------------------
+class DataSnapshot {
+public:
+    // No days; goals as given. Stored days are read from 'file'.
+    explicit DataSnapshot(const int goals[4], std::shared_ptr<const StoredFile> file = nullptr);
+
+    // Goals in the order calories, carbs, protein, fat.
+    const int *goals() const { return goalValues; }
+
+    // The day's entries, or nullptr if nothing is logged on it.
+    const DaySnapshot *find(Date date) const;
+
+    // Number of logged days.
+    size_t dayCount() const { return days; }
+
+    // Appends every logged day to 'out' in date order. The pointers stay
+    // valid as long as this snapshot is alive.
+    void collectDays(std::vector<const DaySnapshot *> &out) const;
+
+    // Calls 'visitor' for each of the day's entries in order, reading a
+    // stored day from the snapshot's data file version. Returns false if a
+    // stored day is not in that file.
+    bool visitFoods(const DaySnapshot &day, const FoodVisitor &visitor) const;
+
+    // A snapshot with 'date' holding 'foods' (an empty list removes the day).
+    std::shared_ptr<const DataSnapshot> withDay(Date date, std::vector<Food> foods) const;
+    // A snapshot with 'date' as a stored day, reading every stored day from
+    // 'file', which must hold them all unchanged (see above).
+    std::shared_ptr<const DataSnapshot> withStoredDay(Date date, std::shared_ptr<const StoredFile> file) const;
+    // The same goals and days, with stored days read from 'file' instead.
+    std::shared_ptr<const DataSnapshot> withFile(std::shared_ptr<const StoredFile> file) const;
+    // A snapshot with other goals and the same days.
+    std::shared_ptr<const DataSnapshot> withGoals(const int goals[4]) const;
+
+    // Builds a snapshot from 'daysInput' in one pass, without the per-day
+    // path copies of withDay. Days with no entries that are not stored are
+    // skipped.
+    static std::shared_ptr<const DataSnapshot> build(const int goals[4], std::vector<DaySnapshot> daysInput,
+                                                     std::shared_ptr<const StoredFile> file);
+
+private:
+    int goalValues[4];
+    size_t days;                               // Logged days in the trie
+    std::shared_ptr<const SnapshotRoot> root;  // nullptr while no day is logged
+    std::shared_ptr<const StoredFile> file;    // Source of stored days; may be nullptr
+
+    // withDay and withStoredDay: 'day' (nullptr to remove) replaces the slot.
+    std::shared_ptr<DataSnapshot> withDaySnapshot(Date date, std::shared_ptr<const DaySnapshot> day) const;
+};
+
+#endif // DATA_SNAPSHOT_H
@@ -0,0 +1,83 @@
+#include "date.h"
+#include "platform.h"  // Portable localtime
+#include <cstdio>
+#include <ctime>
+
+// The civil conversions are checked at compile time against known dates.
+static_assert(Date::fromCivil(1970, 1, 1).days() == 0, "epoch");
+static_assert(Date::fromCivil(2000, 3, 1).days() == 11017, "leap century");
+static_assert(Date::fromCivil(1969, 12, 31).days() == -1, "before epoch");
+static_assert(Date::fromCivil(2024, 2, 29).civil().day == 29, "leap day round trip");
+static_assert(Date::fromCivil(1, 1, 1).civil().year == 1, "first year round trip");
+static_assert(Date::fromCivil(2025, 4, 15).weekday() == 2, "a Tuesday");
+static_assert(Date::fromCivil(1900, 1, 1).weekday() == 1, "a Monday before the epoch");
+
+// -----------------------------------------------------------------------------
+// Method: parse
+// Purpose: Splits the text at '/' into day, month and year and validates them.
+// -----------------------------------------------------------------------------
+bool Date::parse(std::string_view text, Date &out) {
+    int parts[3] = { 0, 0, 0 };
+    int part = 0;
+    bool digits = false;
+    for (char ch : text) {
+        if (ch == '/') {
+            if (!digits || ++part > 2)
+                return false;
+            digits = false;
+        } else if (ch >= '0' && ch <= '9') {
+            if (parts[part] > 9999)
+                return false;
+            parts[part] = parts[part] * 10 + (ch - '0');
+            digits = true;
+        } else {
+            return false;
+        }
+    }
+    if (part != 2 || !digits || !isValid(parts[2], parts[1], parts[0]))
+        return false;
+    out = fromCivil(parts[2], parts[1], parts[0]);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: toString
+// Purpose: Formats the date the way the data files and the screen show it.
+// -----------------------------------------------------------------------------
+std::string Date::toString() const {
+    CivilDate c = civil();
+    // Sized for any day number, not just valid dates, so nothing is truncated.
+    char buffer[40];
+    std::snprintf(buffer, sizeof(buffer), "%02d/%02d/%04d", c.day, c.month, c.year);
+    return buffer;
+}
+
+// -----------------------------------------------------------------------------
+// Method: today
+// Purpose: Reads the clock once and converts it to a local calendar date.
+// -----------------------------------------------------------------------------
+Date Date::today() {
+    std::tm local = {};
+    if (!toLocalTime(std::time(nullptr), local))
+        return Date();
+    return fromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+}
+
+// -----------------------------------------------------------------------------
+// Methods: packedKey / fromPackedKey
+// Purpose: Convert to and from the binary file's date key.
+// -----------------------------------------------------------------------------
+uint32_t Date::packedKey() const {
+    CivilDate c = civil();
+    return (static_cast<uint32_t>(c.year) << 9) | (static_cast<uint32_t>(c.month) << 5) | static_cast<uint32_t>(c.day);
+}
+
+bool Date::fromPackedKey(uint32_t key, Date &out) {
+    int year = static_cast<int>(key >> 9);
+    int month = static_cast<int>((key >> 5) & 0xF);
+    int day = static_cast<int>(key & 0x1F);
+    if (!isValid(year, month, day))
+        return false;
+    out = fromCivil(year, month, day);
+    return true;
+}
@@ -0,0 +1,131 @@
+#ifndef DATE_H
+#define DATE_H
+
+// -----------------------------------------------------------------------------
+// File: date.h
+// Purpose: Declare Date, the calendar date value used by DataManager and
+//          UIManager. Dates are plain day numbers; text only appears where a
+//          date is read from or written to a file or the screen.
+// -----------------------------------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// Structure: CivilDate
+// Purpose: A date split into its calendar fields.
+// -----------------------------------------------------------------------------
+struct CivilDate {
+    int year;   // e.g. 2025
+    int month;  // 1-12
+    int day;    // 1-31
+};
+
+// -----------------------------------------------------------------------------
+// Class: Date
+// Purpose: A day in the proleptic Gregorian calendar, stored as the number of
+//          days since 01/01/1970. Adding days, comparing dates and finding
+//          the weekday are integer arithmetic; conversion to and from
+//          year/month/day uses H. Hinnant's civil algorithms, which need no
+//          time zone, mktime or tables and are usable in constant expressions.
+// -----------------------------------------------------------------------------
+class Date {
+public:
+    // 01/01/1970.
+    constexpr Date() : dayNumber(0) {}
+
+    static constexpr Date fromDayNumber(int32_t days) {
+        Date date;
+        date.dayNumber = days;
+        return date;
+    }
+
+    // Builds a date from calendar fields, which must be valid (see isValid).
+    // The year is shifted to start in March so the leap day falls last.
+    static constexpr Date fromCivil(int year, int month, int day) {
+        year -= month <= 2 ? 1 : 0;
+        int era = (year >= 0 ? year : year - 399) / 400;
+        int yearOfEra = year - era * 400;
+        int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return fromDayNumber(era * 146097 + dayOfEra - 719468);
+    }
+
+    static constexpr bool isLeapYear(int year) {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    static constexpr int daysInMonth(int year, int month) {
+        return MONTH_DAYS[month - 1] + (month == 2 && isLeapYear(year) ? 1 : 0);
+    }
+
+    // True for years 1-9999, the range the "DD/MM/YYYY" text can hold.
+    static constexpr bool isValid(int year, int month, int day) {
+        return year >= 1 && year <= 9999 && month >= 1 && month <= 12 &&
+               day >= 1 && day <= daysInMonth(year, month);
+    }
+
+    constexpr int32_t days() const { return dayNumber; }
+
+    // Inverse of fromCivil.
+    constexpr CivilDate civil() const {
+        int32_t z = dayNumber + 719468;
+        int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+        int32_t dayOfEra = z - era * 146097;
+        int32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        int32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        int32_t monthIndex = (5 * dayOfYear + 2) / 153;  // 0 = March
+        int day = static_cast<int>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+        int month = static_cast<int>(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+        int year = static_cast<int>(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+        return CivilDate{ year, month, day };
+    }
+
+    // 0 = Sunday ... 6 = Saturday. Day 0 was a Thursday.
+    constexpr int weekday() const {
+        return dayNumber >= -4 ? static_cast<int>((dayNumber + 4) % 7)
+                               : static_cast<int>((dayNumber + 5) % 7 + 6);
+    }
+
+    constexpr Date operator+(int32_t offset) const { return fromDayNumber(dayNumber + offset); }
+    constexpr Date operator-(int32_t offset) const { return fromDayNumber(dayNumber - offset); }
+    constexpr int32_t operator-(Date other) const { return dayNumber - other.dayNumber; }
+
+    constexpr bool operator==(Date other) const { return dayNumber == other.dayNumber; }
+    constexpr bool operator!=(Date other) const { return dayNumber != other.dayNumber; }
+    constexpr bool operator<(Date other) const { return dayNumber < other.dayNumber; }
+    constexpr bool operator<=(Date other) const { return dayNumber <= other.dayNumber; }
+    constexpr bool operator>(Date other) const { return dayNumber > other.dayNumber; }
+    constexpr bool operator>=(Date other) const { return dayNumber >= other.dayNumber; }
+
+    // Reads "DD/MM/YYYY" (one or more digits per field). Returns false and
+    // leaves 'out' unchanged if the text is not a valid date.
+    static bool parse(std::string_view text, Date &out);
+    // Formats as "DD/MM/YYYY".
+    std::string toString() const;
+    // Today's date in the local time zone.
+    static Date today();
+
+    // Packed key (year << 9 | month << 5 | day) used by the binary data file,
+    // which keeps it so the day index sorts by date.
+    uint32_t packedKey() const;
+    static bool fromPackedKey(uint32_t key, Date &out);
+
+private:
+    // Month lengths in a common year, January first.
+    static constexpr uint8_t MONTH_DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    int32_t dayNumber;  // Days since 01/01/1970; negative before it
+};
+
+// Lets Date key unordered containers.
+namespace std {
+template <>
+struct hash<Date> {
+    size_t operator()(Date date) const { return std::hash<int32_t>()(date.days()); }
+};
+}
+
+#endif // DATE_H
@@ -0,0 +1,119 @@
+#include "day_store.h"
+#include "durable_file.h"  // Temporary file and rename
+
+// -----------------------------------------------------------------------------
+// Method: StoredFile::open
+// Purpose: Maps and validates the file; see BinaryStoreReader::open.
+// -----------------------------------------------------------------------------
+bool StoredFile::open(const std::string &path) {
+    return reader.open(path);
+}
+
+// -----------------------------------------------------------------------------
+// Method: StoredFile::forEachDay
+// Purpose: One pass over the index. Entries pointing outside the food
+//          section or holding no valid date are skipped, and so are days
+//          without entries (older files may hold some).
+// -----------------------------------------------------------------------------
+void StoredFile::forEachDay(const std::function<void(Date date, const BinaryDayEntry &entry)> &visit) const {
+    for (uint32_t i = 0; i < reader.dayCount(); i++) {
+        BinaryDayEntry entry = reader.dayAt(i);
+        Date date;
+        if (static_cast<uint64_t>(entry.firstFood) + entry.foodCount > reader.foodCount() ||
+            !Date::fromPackedKey(entry.dateKey, date) || entry.foodCount == 0)
+            continue;
+        visit(date, entry);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Method: StoredFile::findDay
+// Purpose: Binary search of the index, with the same checks as forEachDay.
+// -----------------------------------------------------------------------------
+bool StoredFile::findDay(Date date, BinaryDayEntry &entry) const {
+    return reader.findDay(date.packedKey(), entry) &&
+           static_cast<uint64_t>(entry.firstFood) + entry.foodCount <= reader.foodCount();
+}
+
+// -----------------------------------------------------------------------------
+// Method: StoredFile::loadDay
+// Purpose: Decodes the day's records with their names interned.
+// -----------------------------------------------------------------------------
+bool StoredFile::loadDay(Date date, std::vector<Food> &foods) const {
+    BinaryDayEntry entry;
+    if (!findDay(date, entry))
+        return false;
+    foods.reserve(foods.size() + entry.foodCount);
+    for (uint32_t f = 0; f < entry.foodCount; f++)
+        foods.push_back(reader.foodAt(entry.firstFood + f));
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: StoredFile::visitDay
+// Purpose: Decodes the day's records with their names as text in the file.
+// -----------------------------------------------------------------------------
+bool StoredFile::visitDay(Date date, const FoodVisitor &visitor) const {
+    BinaryDayEntry entry;
+    if (!findDay(date, entry))
+        return false;
+    Food food;
+    for (uint32_t f = 0; f < entry.foodCount; f++) {
+        std::string_view name = reader.foodValuesAt(entry.firstFood + f, food);
+        visitor(food, name);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Constructor: DayStore
+// Purpose: Remember the path; nothing is opened until open().
+// -----------------------------------------------------------------------------
+DayStore::DayStore(const std::string &filePath) : path(filePath), savedChanges(0) {
+}
+
+// -----------------------------------------------------------------------------
+// Method: open
+// Purpose: Opens the file as a new version and makes it current.
+// -----------------------------------------------------------------------------
+bool DayStore::open() {
+    std::shared_ptr<StoredFile> opened = std::make_shared<StoredFile>();
+    if (!opened->open(path))
+        opened.reset();
+    std::atomic_store(&current, std::shared_ptr<const StoredFile>(opened));
+    return opened != nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// Method: file
+// Purpose: The version a new snapshot's stored days are read from.
+// -----------------------------------------------------------------------------
+std::shared_ptr<const StoredFile> DayStore::file() const {
+    return std::atomic_load(&current);
+}
+
+// -----------------------------------------------------------------------------
+// Method: save
+// Purpose: Encodes and writes the temporary file, reading stored days from
+//          the versions the snapshot holds, then renames it into place and
+//          opens it as the new current version. Older versions stay open
+//          for the snapshots that hold them. If the new file cannot be
+//          opened, the save counts as failed and is retried by the next one.
+// -----------------------------------------------------------------------------
+bool DayStore::save(const DataSnapshot &snapshot, uint16_t generation, uint64_t changeCount, bool sync) {
+    std::vector<unsigned char> out;
+    if (!encodeBinaryStore(snapshot, generation, out))
+        return false;
+    if (!writeTemporaryFile(path, out.data(), out.size(), sync))
+        return false;
+    if (!commitTemporaryFile(path, sync))
+        return false;
+    std::shared_ptr<StoredFile> saved = std::make_shared<StoredFile>();
+    if (!saved->open(path))
+        return false;
+    // The version first: a day evicted once the new count shows must be
+    // read back from the file that holds its change.
+    std::atomic_store(&current, std::shared_ptr<const StoredFile>(saved));
+    savedChanges.store(changeCount);
+    return true;
+}
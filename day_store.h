@@ -0,0 +1,105 @@
+#ifndef DAY_STORE_H
+#define DAY_STORE_H
+
+// -----------------------------------------------------------------------------
+// File: day_store.h
+// Purpose: Declare DayStore, the open binary data file from which a
+//          DataManager reads days on demand instead of loading them all at
+//          startup, and StoredFile, one saved version of that file.
+// -----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include "binary_store.h"   // File layout and reader
+#include "data_snapshot.h"  // What save() writes
+#include "date.h"
+
+// -----------------------------------------------------------------------------
+// Class: StoredFile
+// Purpose: One version of the data file, open read-only. It never changes
+//          once opened: a save writes a new version, and this one stays
+//          readable, under the old contents, for as long as anything holds
+//          it. Snapshots hold the version their stored days are read from.
+// -----------------------------------------------------------------------------
+class StoredFile {
+public:
+    StoredFile() = default;
+
+    // Maps the file. Returns false if it is missing or invalid.
+    bool open(const std::string &path);
+
+    // Header values (see BinaryStoreReader).
+    int goal(int index) const { return reader.goal(index); }
+    uint16_t generation() const { return reader.generation(); }
+    bool hasDayTotals() const { return reader.hasDayTotals(); }
+    // Index entries, including any forEachDay skips.
+    uint32_t dayCount() const { return reader.dayCount(); }
+
+    // Calls 'visit' for every index entry with a valid date, at least one
+    // food and records inside the file, in date order.
+    void forEachDay(const std::function<void(Date date, const BinaryDayEntry &entry)> &visit) const;
+
+    // Owner thread only: appends the day's entries to 'foods', interning
+    // their names in the NamePool. Returns false if the day is not in the file.
+    bool loadDay(Date date, std::vector<Food> &foods) const;
+    // Any thread: calls 'visitor' for each of the day's entries. Returns
+    // false if the day is not in the file.
+    bool visitDay(Date date, const FoodVisitor &visitor) const;
+
+private:
+    StoredFile(const StoredFile &) = delete;
+    StoredFile &operator=(const StoredFile &) = delete;
+
+    BinaryStoreReader reader;  // Mapping of this version
+
+    // The day's index entry, with its records checked to lie in the file.
+    bool findDay(Date date, BinaryDayEntry &entry) const;
+};
+
+// -----------------------------------------------------------------------------
+// Class: DayStore
+// Purpose: Holds the current version of the binary data file. It is shared
+//          by a DataManager and its persistence worker, which replaces the
+//          file through save():
+//          - save() renames the new file into place and opens it as a new
+//            StoredFile; the old version is never closed under a reader,
+//            only released once the last snapshot holding it is gone.
+//          - The current version is swapped with std::atomic_store, so file()
+//            may be called from any thread.
+//          - On Windows a file that is mapped cannot be renamed over, so
+//            versions are read into memory there instead (see
+//            MappedFile::read).
+// -----------------------------------------------------------------------------
+class DayStore {
+public:
+    explicit DayStore(const std::string &path);
+
+    // Opens the file as the current version. Returns false if it is
+    // missing or invalid, in which case the store holds no days.
+    bool open();
+
+    // The current version, or nullptr if there is none.
+    std::shared_ptr<const StoredFile> file() const;
+
+    // Persistence worker: replaces the file with 'snapshot' under
+    // 'generation' (see writeFileAtomically), then records 'changeCount' as
+    // the DataManager change the file includes. Returns false, leaving the
+    // old file current and in place, on failure.
+    bool save(const DataSnapshot &snapshot, uint16_t generation, uint64_t changeCount, bool sync);
+    // 'changeCount' of the last successful save; 0 before the first.
+    uint64_t savedChangeCount() const { return savedChanges.load(); }
+
+private:
+    DayStore(const DayStore &) = delete;
+    DayStore &operator=(const DayStore &) = delete;
+
+    std::string path;                           // Data file
+    std::shared_ptr<const StoredFile> current;  // Only accessed through std::atomic_load/store
+    std::atomic<uint64_t> savedChanges;         // See savedChangeCount
+};
+
+#endif // DAY_STORE_H
@@ -0,0 +1,114 @@
+#include "durable_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>         // _commit / _fileno
+#else
+#include <fcntl.h>      // open
+#include <unistd.h>     // fsync / close
+#endif
+#include <atomic>
+
+// Value returned by deviceSyncCount.
+static std::atomic<uint64_t> deviceSyncs(0);
+
+// -----------------------------------------------------------------------------
+// Helper: replaceFile
+// Purpose: Atomic rename over an existing file. POSIX rename already replaces
+//          the target atomically; Windows needs MoveFileEx for that.
+// -----------------------------------------------------------------------------
+static bool replaceFile(const std::string &from, const std::string &to, bool sync) {
+#ifdef _WIN32
+    DWORD flags = MOVEFILE_REPLACE_EXISTING | (sync ? MOVEFILE_WRITE_THROUGH : 0);
+    return MoveFileExA(from.c_str(), to.c_str(), flags) != 0;
+#else
+    (void)sync;
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Helper: syncDirectoryOf
+// Purpose: On POSIX a rename is only durable once the directory holding the
+//          entry is synced. Windows commits it with MOVEFILE_WRITE_THROUGH.
+// -----------------------------------------------------------------------------
+static void syncDirectoryOf(const std::string &path) {
+#ifndef _WIN32
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    ::fsync(fd);
+    deviceSyncs++;
+    ::close(fd);
+#else
+    (void)path;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Function: syncFile
+// Purpose: stdio buffer first, then the OS cache.
+// -----------------------------------------------------------------------------
+bool syncFile(std::FILE *file) {
+    if (std::fflush(file) != 0)
+        return false;
+    deviceSyncs++;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return ::fsync(fileno(file)) == 0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Function: deviceSyncCount
+// Purpose: Read by tests; counted by syncFile and syncDirectoryOf.
+// -----------------------------------------------------------------------------
+uint64_t deviceSyncCount() {
+    return deviceSyncs.load();
+}
+
+// -----------------------------------------------------------------------------
+// Function: writeFileAtomically
+// Purpose: Temporary file, optional sync, rename. A failed write removes the
+//          temporary file and leaves the original alone.
+// -----------------------------------------------------------------------------
+bool writeFileAtomically(const std::string &path, const void *data, size_t size, bool sync) {
+    return writeTemporaryFile(path, data, size, sync) && commitTemporaryFile(path, sync);
+}
+
+// -----------------------------------------------------------------------------
+// Function: writeTemporaryFile
+// Purpose: One write, then the optional sync, then close.
+// -----------------------------------------------------------------------------
+bool writeTemporaryFile(const std::string &path, const void *data, size_t size, bool sync) {
+    std::string tempPath = path + ".tmp";
+    std::FILE *file = std::fopen(tempPath.c_str(), "wb");
+    if (!file)
+        return false;
+    bool written = std::fwrite(data, 1, size, file) == size;
+    if (written)
+        written = sync ? syncFile(file) : std::fflush(file) == 0;
+    if (std::fclose(file) != 0)
+        written = false;
+    if (!written)
+        std::remove(tempPath.c_str());
+    return written;
+}
+
+// -----------------------------------------------------------------------------
+// Function: commitTemporaryFile
+// Purpose: The rename, then (with 'sync') the directory entry.
+// -----------------------------------------------------------------------------
+bool commitTemporaryFile(const std::string &path, bool sync) {
+    std::string tempPath = path + ".tmp";
+    if (!replaceFile(tempPath, path, sync)) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    if (sync)
+        syncDirectoryOf(path);
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef DURABLE_FILE_H
+#define DURABLE_FILE_H
+
+// -----------------------------------------------------------------------------
+// File: durable_file.h
+// Purpose: Declare the file operations the data files rely on to survive a
+//          crash: whole-file replacement by rename and forcing written bytes
+//          to the storage device.
+// -----------------------------------------------------------------------------
+
+#include <string>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+
+// Writes 'size' bytes to "<path>.tmp" and renames it over 'path', so readers
+// see either the old file or the complete new one, never a partial write.
+// With 'sync' the temporary file is flushed to the device before the rename
+// and (on POSIX) the directory entry after it, so the new file also survives
+// a power loss. Returns false, leaving 'path' untouched, on any failure.
+bool writeFileAtomically(const std::string &path, const void *data, size_t size, bool sync);
+
+// The two halves of writeFileAtomically, for callers that must close their
+// own view of 'path' just for the rename (Windows cannot rename over a file
+// that is open or mapped).
+// Writes "<path>.tmp", synced with 'sync'. On failure it is removed.
+bool writeTemporaryFile(const std::string &path, const void *data, size_t size, bool sync);
+// Renames "<path>.tmp" over 'path'. On failure it is removed and 'path' is
+// untouched.
+bool commitTemporaryFile(const std::string &path, bool sync);
+
+// Flushes the stdio buffer of 'file' and forces its contents to the device
+// (fsync on POSIX, _commit on Windows).
+bool syncFile(std::FILE *file);
+
+// Device syncs (files and directories) this process has issued so far, so
+// tests can measure how many writes sync batching saves.
+uint64_t deviceSyncCount();
+
+#endif // DURABLE_FILE_H
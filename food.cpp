@@ -0,0 +1,65 @@
+#include "food.h"
+#include <charconv>     // For std::from_chars
+#include <sstream>      // For building formatted lines
+
+// -----------------------------------------------------------------------------
+// Function: formatFood
+// Purpose: Serializes a food entry as "name|calories|carbs|protein|fat|grams",
+//          the same layout used by FOOD: lines in the data file.
+// -----------------------------------------------------------------------------
+std::string formatFood(const Food &food) {
+    return formatFood(food.name(), food);
+}
+
+std::string formatFood(std::string_view name, const Food &food) {
+    std::ostringstream oss;
+    oss << name << "|" << food.calories << "|" << food.carbs << "|"
+        << food.protein << "|" << food.fat << "|" << food.grams;
+    return oss.str();
+}
+
+// -----------------------------------------------------------------------------
+// Function: parseIntField
+// Purpose: Parses one integer with std::from_chars, skipping surrounding blanks,
+//          and advances 'text' past the value and an optional delimiter.
+// -----------------------------------------------------------------------------
+void parseIntField(std::string_view &text, char delimiter, int &value) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        text = std::string_view();
+        return;
+    }
+    text.remove_prefix(start);
+    if (!text.empty() && text.front() == '+')
+        text.remove_prefix(1);
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    text.remove_prefix(static_cast<size_t>(result.ptr - text.data()));
+    size_t next = text.find(delimiter);
+    text.remove_prefix(next == std::string_view::npos ? text.size() : next + 1);
+}
+
+// -----------------------------------------------------------------------------
+// Function: parseFoodValues
+// Purpose: Fills the numeric fields and hands the name back uninterned, for
+//          parsers that must not touch the NamePool.
+// -----------------------------------------------------------------------------
+std::string_view parseFoodValues(std::string_view text, Food &food) {
+    size_t nameEnd = text.find('|');
+    std::string_view name = text.substr(0, nameEnd);
+    text.remove_prefix(nameEnd == std::string_view::npos ? text.size() : nameEnd + 1);
+    parseIntField(text, '|', food.calories);
+    parseIntField(text, '|', food.carbs);
+    parseIntField(text, '|', food.protein);
+    parseIntField(text, '|', food.fat);
+    parseIntField(text, '|', food.grams);
+    return name;
+}
+
+// -----------------------------------------------------------------------------
+// Function: parseFoodFields
+// Purpose: Fills 'food' from the '|' delimited layout. The name is interned,
+//          so it is only copied the first time it is seen.
+// -----------------------------------------------------------------------------
+void parseFoodFields(std::string_view text, Food &food) {
+    food.setName(parseFoodValues(text, food));
+}
@@ -8,14 +8,19 @@
 // -----------------------------------------------------------------------------
 
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include "name_pool.h"  // Interned food names
 
 // -----------------------------------------------------------------------------
 // Structure: Food
 // Purpose: Contains all nutritional information about a given food along with 
-//          its serving size in grams.
+//          its serving size in grams. The name is an id into NamePool, so
+//          copying a Food never copies text and equal names compare as equal
+//          integers.
 // -----------------------------------------------------------------------------
 struct Food {
-    std::string name;  // Name of the food item (e.g., "Apple", "Chicken Breast")
+    uint32_t nameId;   // Interned name of the food item (e.g., "Apple", "Chicken Breast")
     int calories;      // Energy provided by the food, measured in kilocalories
     int carbs;         // Carbohydrates in grams
     int protein;       // Protein in grams
@@ -23,11 +28,37 @@ struct Food {
     int grams;         // Portion size in grams
 
     // Default constructor initializes fields to default values.
-    Food() : name(""), calories(0), carbs(0), protein(0), fat(0), grams(0) {}
+    Food() : nameId(EMPTY_NAME_ID), calories(0), carbs(0), protein(0), fat(0), grams(0) {}
 
     // Parameterized constructor allows instant initialization of all values.
-    Food(const std::string &n, int cal, int c, int p, int f, int g)
-        : name(n), calories(cal), carbs(c), protein(p), fat(f), grams(g) {}
+    Food(std::string_view n, int cal, int c, int p, int f, int g)
+        : nameId(NamePool::instance().intern(n)), calories(cal), carbs(c), protein(p), fat(f), grams(g) {}
+
+    // The name's text; valid for the lifetime of the program.
+    std::string_view name() const { return NamePool::instance().text(nameId); }
+    void setName(std::string_view n) { nameId = NamePool::instance().intern(n); }
 };
 
+// -----------------------------------------------------------------------------
+// Text format helpers
+// Purpose: Shared by the data file, the journal and the template library, which
+//          all store foods as "name|calories|carbs|protein|fat|grams".
+// -----------------------------------------------------------------------------
+
+// Serializes a food in the '|' delimited layout.
+std::string formatFood(const Food &food);
+// Same, with the name given as text instead of through food.nameId.
+std::string formatFood(std::string_view name, const Food &food);
+
+// Parses the '|' delimited layout with std::from_chars, without temporary strings.
+// Missing numeric fields are left unchanged.
+void parseFoodFields(std::string_view text, Food &food);
+// Same, except that the name is returned as a view into 'text' and not
+// interned; 'food.nameId' is left unchanged.
+std::string_view parseFoodValues(std::string_view text, Food &food);
+
+// Parses one integer (surrounding blanks allowed) and advances 'text' past it
+// and the following 'delimiter'. Leaves 'value' untouched if no number is present.
+void parseIntField(std::string_view &text, char delimiter, int &value);
+
 #endif // FOOD_H
@@ -0,0 +1,157 @@
+#include "food_columns.h"
+
+// -----------------------------------------------------------------------------
+// Constructor: FoodColumns
+// Purpose: Start empty; the first append allocates the first block.
+// -----------------------------------------------------------------------------
+FoodColumns::FoodColumns() : rows(0), deadRows(0) {
+}
+
+// -----------------------------------------------------------------------------
+// Method: nextRow
+// Purpose: Allocates a new block when the last one is full. Existing blocks
+//          are never reallocated, so row ids stay valid.
+// -----------------------------------------------------------------------------
+uint32_t FoodColumns::nextRow() {
+    if (rows == blocks.size() * FOOD_BLOCK_ROWS)
+        blocks.emplace_back(new Block);
+    return static_cast<uint32_t>(rows++);
+}
+
+// -----------------------------------------------------------------------------
+// Method: appendRows
+// Purpose: Allocates every block the new rows reach, so that set() never
+//          changes the block list.
+// -----------------------------------------------------------------------------
+uint32_t FoodColumns::appendRows(size_t count) {
+    uint32_t first = static_cast<uint32_t>(rows);
+    rows += count;
+    while (blocks.size() * FOOD_BLOCK_ROWS < rows)
+        blocks.emplace_back(new Block);
+    return first;
+}
+
+// -----------------------------------------------------------------------------
+// Method: append
+// Purpose: Writes one food into the next free row of every column.
+// -----------------------------------------------------------------------------
+uint32_t FoodColumns::append(const Food &food) {
+    uint32_t row = nextRow();
+    set(row, food);
+    return row;
+}
+
+// -----------------------------------------------------------------------------
+// Method: set
+// Purpose: Scatters one food across the columns of its row.
+// -----------------------------------------------------------------------------
+void FoodColumns::set(uint32_t row, const Food &food) {
+    Block &block = *blocks[row / FOOD_BLOCK_ROWS];
+    uint32_t slot = row % FOOD_BLOCK_ROWS;
+    block.values[COLUMN_CALORIES][slot] = food.calories;
+    block.values[COLUMN_CARBS][slot] = food.carbs;
+    block.values[COLUMN_PROTEIN][slot] = food.protein;
+    block.values[COLUMN_FAT][slot] = food.fat;
+    block.values[COLUMN_GRAMS][slot] = food.grams;
+    block.nameIds[slot] = food.nameId;
+}
+
+// -----------------------------------------------------------------------------
+// Method: appendFrom
+// Purpose: Copies a row between stores without rebuilding a Food.
+// -----------------------------------------------------------------------------
+uint32_t FoodColumns::appendFrom(const FoodColumns &other, uint32_t sourceRow) {
+    uint32_t row = nextRow();
+    Block &block = *blocks[row / FOOD_BLOCK_ROWS];
+    uint32_t slot = row % FOOD_BLOCK_ROWS;
+    const Block &source = *other.blocks[sourceRow / FOOD_BLOCK_ROWS];
+    uint32_t sourceSlot = sourceRow % FOOD_BLOCK_ROWS;
+    for (int column = 0; column < FOOD_COLUMN_COUNT; column++)
+        block.values[column][slot] = source.values[column][sourceSlot];
+    block.nameIds[slot] = source.nameIds[sourceSlot];
+    return row;
+}
+
+// -----------------------------------------------------------------------------
+// Method: release
+// Purpose: Moves a row's values into the dead total. The row itself is left
+//          in place so no other row id changes.
+// -----------------------------------------------------------------------------
+void FoodColumns::release(uint32_t row) {
+    const Block &block = *blocks[row / FOOD_BLOCK_ROWS];
+    uint32_t slot = row % FOOD_BLOCK_ROWS;
+    for (int column = 0; column < FOOD_COLUMN_COUNT; column++)
+        deadTotals.values[column] += block.values[column][slot];
+    deadRows++;
+}
+
+// -----------------------------------------------------------------------------
+// Method: get
+// Purpose: Gathers one row from every column into a Food.
+// -----------------------------------------------------------------------------
+Food FoodColumns::get(uint32_t row) const {
+    const Block &block = *blocks[row / FOOD_BLOCK_ROWS];
+    uint32_t slot = row % FOOD_BLOCK_ROWS;
+    Food food;
+    food.nameId = block.nameIds[slot];
+    food.calories = block.values[COLUMN_CALORIES][slot];
+    food.carbs = block.values[COLUMN_CARBS][slot];
+    food.protein = block.values[COLUMN_PROTEIN][slot];
+    food.fat = block.values[COLUMN_FAT][slot];
+    food.grams = block.values[COLUMN_GRAMS][slot];
+    return food;
+}
+
+// -----------------------------------------------------------------------------
+// Method: value
+// Purpose: Reads a single column of a row.
+// -----------------------------------------------------------------------------
+int32_t FoodColumns::value(FoodColumn column, uint32_t row) const {
+    return blocks[row / FOOD_BLOCK_ROWS]->values[column][row % FOOD_BLOCK_ROWS];
+}
+
+// -----------------------------------------------------------------------------
+// Method: nameId
+// Purpose: Returns the NamePool id of a row's name.
+// -----------------------------------------------------------------------------
+uint32_t FoodColumns::nameId(uint32_t row) const {
+    return blocks[row / FOOD_BLOCK_ROWS]->nameIds[row % FOOD_BLOCK_ROWS];
+}
+
+// -----------------------------------------------------------------------------
+// Method: sumLive
+// Purpose: Hands each block's columns to a summation kernel, then takes the
+//          released rows back out with the dead total.
+// -----------------------------------------------------------------------------
+ColumnTotals FoodColumns::sumLive() const {
+    static const SumKernel best = bestSumKernel();
+    return sumLive(best);
+}
+
+ColumnTotals FoodColumns::sumLive(SumKernel kernel) const {
+    ColumnSumFunction sum = columnSumFunction(kernel);
+    ColumnTotals totals;
+    size_t remaining = rows;
+    for (const auto &block : blocks) {
+        uint32_t used = remaining < FOOD_BLOCK_ROWS ? static_cast<uint32_t>(remaining) : FOOD_BLOCK_ROWS;
+        remaining -= used;
+        const int32_t *columns[FOOD_COLUMN_COUNT];
+        for (int column = 0; column < FOOD_COLUMN_COUNT; column++)
+            columns[column] = block->values[column];
+        sum(columns, used, totals.values);
+    }
+    for (int column = 0; column < FOOD_COLUMN_COUNT; column++)
+        totals.values[column] -= deadTotals.values[column];
+    return totals;
+}
+
+// -----------------------------------------------------------------------------
+// Method: clear
+// Purpose: Releases every block.
+// -----------------------------------------------------------------------------
+void FoodColumns::clear() {
+    blocks.clear();
+    rows = 0;
+    deadRows = 0;
+    deadTotals = ColumnTotals();
+}
@@ -0,0 +1,150 @@
+#ifndef FOOD_COLUMNS_H
+#define FOOD_COLUMNS_H
+
+// -----------------------------------------------------------------------------
+// File: food_columns.h
+// Purpose: Declare FoodColumns, the structure-of-arrays store that holds every
+//          food entry of every day, and FoodListView, the per-day window onto
+//          it that DailyRecord hands out.
+// -----------------------------------------------------------------------------
+
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+#include "food.h"
+#include "column_kernels.h"  // Scalar and SIMD column sums
+
+// Numeric columns of a food entry, in the order they are stored.
+enum FoodColumn {
+    COLUMN_CALORIES,
+    COLUMN_CARBS,
+    COLUMN_PROTEIN,
+    COLUMN_FAT,
+    COLUMN_GRAMS,
+    FOOD_COLUMN_COUNT
+};
+
+// Rows per block. A block of every column is 96 KB, so a scan streams whole
+// blocks while small histories waste little memory.
+const uint32_t FOOD_BLOCK_ROWS = 4096;
+
+// -----------------------------------------------------------------------------
+// Structure: ColumnTotals
+// Purpose: 64-bit sums of each numeric column, indexed by FoodColumn.
+// -----------------------------------------------------------------------------
+struct ColumnTotals {
+    int64_t values[FOOD_COLUMN_COUNT] = {};
+};
+
+// -----------------------------------------------------------------------------
+// Class: FoodColumns
+// Purpose: Stores food entries as one contiguous array per column, split into
+//          fixed-size blocks that never move once allocated.
+//          - Rows are only ever appended. Editing an entry appends a new row,
+//            and editing or removing one releases the old row.
+//          - Released rows stay in the blocks, and their values are collected
+//            in a running dead total. Full-history sums scan every block
+//            linearly and subtract that total.
+//          - Names are stored as their 32-bit NamePool id.
+//          DataManager repacks the store once more than half of it is dead.
+// -----------------------------------------------------------------------------
+class FoodColumns {
+public:
+    FoodColumns();
+
+    // Appends a row and returns its id.
+    uint32_t append(const Food &food);
+    // Appends a copy of 'sourceRow' of another store, used when repacking.
+    uint32_t appendFrom(const FoodColumns &other, uint32_t sourceRow);
+    // Appends 'count' rows without values and returns the first id. Each
+    // row must be filled by set() before it is read.
+    uint32_t appendRows(size_t count);
+    // Writes a row reserved by appendRows. Different rows may be written from
+    // different threads at once, as long as nothing else changes the store.
+    void set(uint32_t row, const Food &food);
+    // Marks a row as no longer referenced by any day.
+    void release(uint32_t row);
+
+    // Rebuilds the food stored in a row.
+    Food get(uint32_t row) const;
+    int32_t value(FoodColumn column, uint32_t row) const;
+    uint32_t nameId(uint32_t row) const;
+
+    // Sums every live row in one pass over each block, with the fastest
+    // kernel this machine supports or with a specific one.
+    ColumnTotals sumLive() const;
+    ColumnTotals sumLive(SumKernel kernel) const;
+
+    size_t rowCount() const { return rows; }
+    size_t deadRowCount() const { return deadRows; }
+
+    // Drops every row.
+    void clear();
+
+private:
+    // -------------------------------------------------------------------------
+    // Structure: Block
+    // Purpose: FOOD_BLOCK_ROWS rows of every column.
+    // -------------------------------------------------------------------------
+    struct Block {
+        int32_t values[FOOD_COLUMN_COUNT][FOOD_BLOCK_ROWS];
+        uint32_t nameIds[FOOD_BLOCK_ROWS];
+    };
+
+    std::vector<std::unique_ptr<Block>> blocks;  // Allocated blocks, all full but the last
+    size_t rows;                                 // Rows appended so far
+    size_t deadRows;                             // Rows released so far
+    ColumnTotals deadTotals;                     // Column sums of the released rows
+
+    // Reserves the next row and returns its id.
+    uint32_t nextRow();
+};
+
+// -----------------------------------------------------------------------------
+// Class: FoodListView
+// Purpose: Read-only view of one day's foods. Indexing rebuilds a Food from
+//          the columns, so code written against std::vector<Food> keeps
+//          working. Copies of the view are cheap and stay valid until the day
+//          changes.
+// -----------------------------------------------------------------------------
+class FoodListView {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Food;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Food;
+
+        const_iterator(const FoodColumns *c, const uint32_t *r) : columns(c), row(r) {}
+        Food operator*() const { return columns->get(*row); }
+        const_iterator &operator++() { ++row; return *this; }
+        bool operator==(const const_iterator &other) const { return row == other.row; }
+        bool operator!=(const const_iterator &other) const { return row != other.row; }
+
+    private:
+        const FoodColumns *columns;
+        const uint32_t *row;
+    };
+
+    FoodListView(const FoodColumns &c, const std::vector<uint32_t> &r) : columns(&c), rows(&r) {}
+
+    size_t size() const { return rows->size(); }
+    bool empty() const { return rows->empty(); }
+    Food operator[](size_t index) const { return columns->get((*rows)[index]); }
+    // Row id of the entry at 'index', for reading single columns.
+    uint32_t row(size_t index) const { return (*rows)[index]; }
+    const FoodColumns &store() const { return *columns; }
+
+    const_iterator begin() const { return const_iterator(columns, rows->data()); }
+    const_iterator end() const { return const_iterator(columns, rows->data() + rows->size()); }
+
+private:
+    const FoodColumns *columns;
+    const std::vector<uint32_t> *rows;
+};
+
+#endif // FOOD_COLUMNS_H
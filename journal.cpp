@@ -0,0 +1,164 @@
+#include "journal.h"
+#include "durable_file.h"  // syncFile
+#include <cstdio>       // For snprintf / strtoul
+#include <cstdlib>
+#include <fstream>
+
+// -----------------------------------------------------------------------------
+// Constructor: Journal
+// Purpose: Remember the journal location; the file is opened on first append.
+// -----------------------------------------------------------------------------
+Journal::Journal(const std::string &p)
+    : path(p), outFile(nullptr), pending(0), syncInterval(0), unsynced(false) {
+}
+
+// -----------------------------------------------------------------------------
+// Destructor: Journal
+// Purpose: Sync and close the append stream if it was opened.
+// -----------------------------------------------------------------------------
+Journal::~Journal() {
+    if (outFile) {
+        sync();
+        std::fclose(outFile);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Methods: setHeader / setSyncInterval
+// Purpose: Configuration; the header applies to the next new file.
+// -----------------------------------------------------------------------------
+void Journal::setHeader(const std::string &payload) {
+    header = payload;
+}
+
+void Journal::setSyncInterval(uint32_t milliseconds) {
+    syncInterval = milliseconds;
+}
+
+// -----------------------------------------------------------------------------
+// Method: checksum
+// Purpose: Bitwise CRC-32 over the payload bytes. Journal lines are short, so a
+//          table-free implementation is fast enough.
+// -----------------------------------------------------------------------------
+uint32_t Journal::checksum(const std::string &payload) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (unsigned char byte : payload) {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+// -----------------------------------------------------------------------------
+// Method: append
+// Purpose: Opens the file on first use (starting a new file with the header),
+//          writes the record, then syncs if this record or an earlier
+//          unsynced one has waited for the whole interval.
+// -----------------------------------------------------------------------------
+bool Journal::append(const std::string &payload) {
+    if (!outFile) {
+        outFile = std::fopen(path.c_str(), "ab");
+        if (!outFile)
+            return false;
+        if (pending == 0 && !header.empty() && !writeRecord(header))
+            return false;
+    }
+    if (!writeRecord(payload))
+        return false;
+    pending++;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (!unsynced) {
+        unsynced = true;
+        firstUnsynced = now;
+    }
+    if (now - firstUnsynced >= std::chrono::milliseconds(syncInterval))
+        return sync();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: writeRecord
+// Purpose: Writes "<payload>#<crc32 in hex>" as a single line and flushes the
+//          stdio buffer so the change survives the process exiting right after.
+// -----------------------------------------------------------------------------
+bool Journal::writeRecord(const std::string &payload) {
+    char crcText[9];
+    snprintf(crcText, sizeof(crcText), "%08x", checksum(payload));
+    std::string line = payload + '#' + crcText + '\n';
+    if (std::fwrite(line.data(), 1, line.size(), outFile) != line.size())
+        return false;
+    return std::fflush(outFile) == 0;
+}
+
+// -----------------------------------------------------------------------------
+// Method: sync
+// Purpose: One device sync covers every record appended since the last one.
+// -----------------------------------------------------------------------------
+bool Journal::sync() {
+    if (!unsynced || !outFile)
+        return true;
+    unsynced = false;
+    return syncFile(outFile);
+}
+
+// -----------------------------------------------------------------------------
+// Method: syncDeadline
+// Purpose: Latest time the unsynced records should be synced by.
+// -----------------------------------------------------------------------------
+std::chrono::steady_clock::time_point Journal::syncDeadline() const {
+    return firstUnsynced + std::chrono::milliseconds(syncInterval);
+}
+
+// -----------------------------------------------------------------------------
+// Method: replay
+// Purpose: Reads the journal line by line, verifying each checksum. Stops at
+//          the first record that is truncated or fails verification.
+// -----------------------------------------------------------------------------
+bool Journal::replay(std::vector<std::string> &payloads, bool &corrupt) {
+    corrupt = false;
+    std::ifstream inFile(path);
+    if (!inFile.is_open())
+        return false;
+    std::string line;
+    while (std::getline(inFile, line)) {
+        size_t hashPos = line.rfind('#');
+        if (hashPos == std::string::npos || line.size() - hashPos - 1 != 8) {
+            corrupt = true;
+            break;
+        }
+        std::string payload = line.substr(0, hashPos);
+        uint32_t stored = static_cast<uint32_t>(std::strtoul(line.c_str() + hashPos + 1, nullptr, 16));
+        if (stored != checksum(payload)) {
+            corrupt = true;
+            break;
+        }
+        payloads.push_back(payload);
+    }
+    pending = payloads.size();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: reset
+// Purpose: Truncates the journal after its contents were folded into the main file.
+// -----------------------------------------------------------------------------
+bool Journal::reset() {
+    if (outFile) {
+        std::fclose(outFile);
+        outFile = nullptr;
+    }
+    unsynced = false;
+    pending = 0;
+    std::remove(path.c_str());
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: pendingCount
+// Purpose: Returns how many records are waiting to be compacted.
+// -----------------------------------------------------------------------------
+size_t Journal::pendingCount() const {
+    return pending;
+}
@@ -0,0 +1,81 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+// -----------------------------------------------------------------------------
+// File: journal.h
+// Purpose: Declare the Journal class, an append-only write-ahead log that
+//          records every data change as one checksummed line. The main data
+//          file is only rewritten when the journal is compacted.
+// -----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+
+// -----------------------------------------------------------------------------
+// Class: Journal
+// Purpose: Appends text payloads to a log file as "<payload>#<crc32>" lines and
+//          replays the intact ones on startup. A torn or corrupted line ends
+//          the replay, so a crash mid-append never yields a half-applied change.
+//          Every append reaches the OS before append() returns, so the process
+//          dying loses nothing. Forcing records to the device (which a power
+//          loss requires) is batched: appends within the sync interval of the
+//          first unsynced one share a single sync.
+// -----------------------------------------------------------------------------
+class Journal {
+public:
+    explicit Journal(const std::string &path);
+    // Syncs unsynced records and closes the file.
+    ~Journal();
+
+    // Payload written, uncounted, as the first record of every new journal
+    // file; DataManager uses it to tag the data file generation.
+    void setHeader(const std::string &payload);
+
+    // Longest time an appended record may stay unsynced while more records
+    // arrive. 0 syncs on every append.
+    void setSyncInterval(uint32_t milliseconds);
+
+    // Appends a single payload line (must not contain '\n') and flushes it to
+    // the OS, syncing it to the device if the sync interval has run out.
+    // Returns true if the record reached the file.
+    bool append(const std::string &payload);
+
+    // Forces every appended record to the device now.
+    bool sync();
+
+    // True if appended records wait for a sync; syncDeadline() is when the
+    // oldest of them has waited the whole sync interval.
+    bool hasUnsynced() const { return unsynced; }
+    std::chrono::steady_clock::time_point syncDeadline() const;
+
+    // Reads back every intact payload in order. Sets 'corrupt' to true if a
+    // damaged record was found (everything after it is ignored).
+    // Returns false if the journal file does not exist.
+    bool replay(std::vector<std::string> &payloads, bool &corrupt);
+
+    // Discards all journal records; called once they are compacted into the main file.
+    bool reset();
+
+    // Number of records currently held in the journal (replayed + appended).
+    size_t pendingCount() const;
+
+    // Computes the CRC-32 (IEEE) checksum of the given payload.
+    static uint32_t checksum(const std::string &payload);
+
+private:
+    std::string path;        // Location of the journal file
+    std::FILE *outFile;      // Kept open in append mode between writes
+    size_t pending;          // Records not yet compacted into the main file
+    std::string header;      // First record of a new file, if not empty
+    uint32_t syncInterval;   // Milliseconds, see setSyncInterval
+    bool unsynced;           // Records were appended since the last sync
+    std::chrono::steady_clock::time_point firstUnsynced;  // Append time of the oldest unsynced record
+
+    // Writes one checksummed line and flushes it to the OS.
+    bool writeRecord(const std::string &payload);
+};
+
+#endif // JOURNAL_H
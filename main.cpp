@@ -1,8 +1,9 @@
 #include "ui_manager.h"    // Manages user interaction, rendering UI, and input processing.
-#include "data_manager.h"  // Handles loading and storing persistent data.
+#include "profile_registry.h"  // One data set per profile, loaded on demand
 #include "constants.h"     // Global constants and helper functions
 #include <iostream>
 #include <string>
+#include <cstdlib>
 
 // -----------------------------------------------------------------------------
 // Utility Lambda: center
@@ -15,27 +16,69 @@ auto center = [](const std::string &text) -> std::string {
     return std::string(padding, ' ') + text;
 };
 
-int main() {
+int main(int argc, char *argv[]) {
     // -------------------------------------------------------------------------
-    // Create and initialize the DataManager:
-    // - Load saved data from file (if exists)
-    // - This instance maintains the data for daily nutritional records and goals.
+    // Set up the profile registry:
+    // - Pick the text import parser ("--loader=stream", "--loader=mmap" or
+    //   "--loader=parallel")
+    // - Pick the starting profile ("--profile=name", created if new)
+    // - Set the journal sync batching window ("--sync-interval=ms", 0 syncs
+    //   every change)
+    // - Only the list of names is read here; a profile's data is loaded when
+    //   it is first opened.
     // -------------------------------------------------------------------------
-    DataManager dataManager;
-    dataManager.loadData();
+    ProfileRegistry profiles(PROFILE_LIST_FILE, PROFILE_CACHE_SIZE);
+    profiles.load();
+    std::string profile = DEFAULT_PROFILE;
+    bool exportRequested = false;
+    std::string exportPath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--loader=stream")
+            profiles.setLoader(LOADER_STREAM);
+        else if (arg == "--loader=mmap")
+            profiles.setLoader(LOADER_MAPPED);
+        else if (arg == "--loader=parallel")
+            profiles.setLoader(LOADER_PARALLEL);
+        else if (arg == "--export-text")
+            exportRequested = true;
+        else if (arg.find("--export-text=") == 0) {
+            exportRequested = true;
+            exportPath = arg.substr(14);
+        }
+        else if (arg.find("--profile=") == 0)
+            profile = arg.substr(10);
+        else if (arg.find("--sync-interval=") == 0)
+            profiles.setSyncInterval(static_cast<uint32_t>(std::strtoul(arg.c_str() + 16, nullptr, 10)));
+    }
+    if (!profiles.contains(profile) && !profiles.add(profile)) {
+        std::cerr << "Invalid profile name: " << profile << std::endl;
+        return 1;
+    }
+
+    // -------------------------------------------------------------------------
+    // "--export-text[=file]" writes the profile's data back in the text format
+    // (to its own text file by default) and exits.
+    // -------------------------------------------------------------------------
+    if (exportRequested) {
+        DataManager &dataManager = profiles.open(profile);
+        if (exportPath.empty())
+            exportPath = dataManager.dataFiles().text;
+        return dataManager.exportText(exportPath) ? 0 : 1;
+    }
 
     // -------------------------------------------------------------------------
-    // Initialize the UIManager with the DataManager reference:
+    // Initialize the UIManager with the profile registry:
     // - This object handles rendering the console UI, keyboard interactions, etc.
     // -------------------------------------------------------------------------
-    UIManager ui(dataManager);
+    UIManager ui(profiles, profile);
     ui.init();
 
     // -------------------------------------------------------------------------
     // If running for the first time (i.e., no saved data exists),
     // prompt the user to input their daily nutritional goals.
     // -------------------------------------------------------------------------
-    if (dataManager.isFirstRun()) {
+    if (profiles.open(profile).isFirstRun()) {
         ui.handleStartGoals();
     }
 
@@ -0,0 +1,153 @@
+#include "mapped_file.h"
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap / munmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // close
+#endif
+
+// -----------------------------------------------------------------------------
+// Constructor: MappedFile
+// Purpose: Start out with no file mapped.
+// -----------------------------------------------------------------------------
+MappedFile::MappedFile() : data(nullptr), length(0),
+#ifdef _WIN32
+    fileHandle(nullptr), mappingHandle(nullptr)
+#else
+    fd(-1)
+#endif
+{
+}
+
+// -----------------------------------------------------------------------------
+// Destructor: MappedFile
+// Purpose: Unmap the file if still mapped.
+// -----------------------------------------------------------------------------
+MappedFile::~MappedFile() {
+    close();
+}
+
+// -----------------------------------------------------------------------------
+// Method: read
+// Purpose: One read of the whole file into 'copy'; close() releases it.
+// -----------------------------------------------------------------------------
+bool MappedFile::read(const std::string &path) {
+    close();
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    std::streamoff size = in.tellg();
+    if (size < 0)
+        return false;
+    copy.resize(static_cast<size_t>(size));
+    in.seekg(0);
+    if (size > 0 && !in.read(copy.data(), size)) {
+        copy = std::vector<char>();
+        return false;
+    }
+    data = copy.empty() ? nullptr : copy.data();
+    length = copy.size();
+    return true;
+}
+
+#ifdef _WIN32
+
+// -----------------------------------------------------------------------------
+// Method: open (Win32)
+// Purpose: Map the file through CreateFileMapping / MapViewOfFile.
+// -----------------------------------------------------------------------------
+bool MappedFile::open(const std::string &path) {
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    if (size.QuadPart == 0)
+        return true;  // Nothing to map; an empty view is valid.
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+    data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr) {
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: close (Win32)
+// Purpose: Unmap the view and close both handles.
+// -----------------------------------------------------------------------------
+void MappedFile::close() {
+    if (data && copy.empty())
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+    if (fileHandle)
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+    data = nullptr;
+    length = 0;
+    copy = std::vector<char>();
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+#else
+
+// -----------------------------------------------------------------------------
+// Method: open (POSIX)
+// Purpose: Map the file read-only with mmap.
+// -----------------------------------------------------------------------------
+bool MappedFile::open(const std::string &path) {
+    close();
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close();
+        return false;
+    }
+    if (info.st_size == 0)
+        return true;  // mmap rejects zero-length mappings; an empty view is valid.
+    void *addr = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        close();
+        return false;
+    }
+    data = static_cast<const char *>(addr);
+    length = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: close (POSIX)
+// Purpose: Unmap the file and close the descriptor.
+// -----------------------------------------------------------------------------
+void MappedFile::close() {
+    if (data && copy.empty())
+        munmap(const_cast<char *>(data), length);
+    if (fd >= 0)
+        ::close(fd);
+    data = nullptr;
+    length = 0;
+    copy = std::vector<char>();
+    fd = -1;
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+// -----------------------------------------------------------------------------
+// File: mapped_file.h
+// Purpose: Declare MappedFile, a read-only memory mapping of a whole file. Used
+//          by the zero-copy loader so the data file can be parsed in place
+//          without copying it into std::string buffers.
+// -----------------------------------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// Class: MappedFile
+// Purpose: Owns a read-only view of a file's contents. The view stays valid
+//          until close() is called or the object is destroyed.
+// -----------------------------------------------------------------------------
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Maps the file at 'path'. Returns false if it cannot be opened.
+    // An empty file opens successfully with a zero-length view.
+    bool open(const std::string &path);
+
+    // Reads the whole file into memory instead of mapping it: the same view,
+    // but the file is not held open, so it can be replaced meanwhile.
+    bool read(const std::string &path);
+
+    // Releases the mapping and the underlying file handle.
+    void close();
+
+    // Returns the mapped bytes as a string_view.
+    std::string_view view() const { return std::string_view(data, length); }
+
+private:
+    const char *data;        // Start of the mapped bytes (nullptr when empty or closed)
+    size_t length;           // Number of mapped bytes
+    std::vector<char> copy;  // File contents after read(); 'data' points into it
+#ifdef _WIN32
+    void *fileHandle;     // HANDLE returned by CreateFileA
+    void *mappingHandle;  // HANDLE returned by CreateFileMappingA
+#else
+    int fd;               // Descriptor kept open for the lifetime of the mapping
+#endif
+};
+
+#endif // MAPPED_FILE_H
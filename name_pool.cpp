@@ -0,0 +1,99 @@
+#include "name_pool.h"
+#include <cstring>
+#include <functional>  // std::hash<std::string_view>
+
+// -----------------------------------------------------------------------------
+// Constructor: NamePool
+// Purpose: Starts with the empty name as id 0, so a default Food needs no
+//          lookup.
+// -----------------------------------------------------------------------------
+NamePool::NamePool() : cursor(nullptr), available(0), reservedBytes(0), count(0), slots(1024, EMPTY_SLOT) {
+    segments[0].reset(new std::string_view[FIRST_SEGMENT_SIZE]);
+    count = 1;
+    slots[findSlot(std::string_view())] = EMPTY_NAME_ID;
+}
+
+// -----------------------------------------------------------------------------
+// Method: instance
+// Purpose: Returns the process-wide pool, created on first use.
+// -----------------------------------------------------------------------------
+NamePool &NamePool::instance() {
+    static NamePool pool;
+    return pool;
+}
+
+// -----------------------------------------------------------------------------
+// Method: intern
+// Purpose: One probe sequence for known names; new names are stored once. A
+//          new id that starts a segment allocates it; existing entries are
+//          never touched, so readers of older ids are unaffected.
+// -----------------------------------------------------------------------------
+uint32_t NamePool::intern(std::string_view text) {
+    size_t slot = findSlot(text);
+    if (slots[slot] != EMPTY_SLOT)
+        return slots[slot];
+    uint32_t id = count;
+    uint32_t biased = id + FIRST_SEGMENT_SIZE;
+    int segment = highestBit(biased) - FIRST_SEGMENT_BITS;
+    uint32_t offset = biased - (FIRST_SEGMENT_SIZE << segment);
+    if (offset == 0)
+        segments[segment].reset(new std::string_view[FIRST_SEGMENT_SIZE << segment]);
+    segments[segment][offset] = store(text);
+    count++;
+    slots[slot] = id;
+    if (static_cast<size_t>(count) * 2 > slots.size())
+        grow();
+    return id;
+}
+
+// -----------------------------------------------------------------------------
+// Method: findSlot
+// Purpose: Linear probing from the text's hash. The table is never more than
+//          half full, so probe sequences stay short and always end.
+// -----------------------------------------------------------------------------
+size_t NamePool::findSlot(std::string_view text) const {
+    size_t mask = slots.size() - 1;
+    size_t slot = std::hash<std::string_view>()(text) & mask;
+    while (slots[slot] != EMPTY_SLOT && this->text(slots[slot]) != text)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+// -----------------------------------------------------------------------------
+// Method: grow
+// Purpose: Doubles the table size (a power of two) and reinserts every id.
+// -----------------------------------------------------------------------------
+void NamePool::grow() {
+    std::vector<uint32_t> old(slots.size() * 2, EMPTY_SLOT);
+    old.swap(slots);
+    size_t mask = slots.size() - 1;
+    for (uint32_t id : old) {
+        if (id == EMPTY_SLOT)
+            continue;
+        size_t slot = std::hash<std::string_view>()(text(id)) & mask;
+        while (slots[slot] != EMPTY_SLOT)
+            slot = (slot + 1) & mask;
+        slots[slot] = id;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Method: store
+// Purpose: Bump-allocates the bytes of a name. A name that does not fit in
+//          the rest of the current chunk starts a new one; names longer than
+//          a chunk get a chunk of their own.
+// -----------------------------------------------------------------------------
+std::string_view NamePool::store(std::string_view text) {
+    if (text.size() > available) {
+        size_t size = text.size() > CHUNK_BYTES ? text.size() : CHUNK_BYTES;
+        chunks.emplace_back(new char[size]);
+        cursor = chunks.back().get();
+        available = size;
+        reservedBytes += size;
+    }
+    std::memcpy(cursor, text.data(), text.size());
+    std::string_view stored(cursor, text.size());
+    cursor += text.size();
+    available -= text.size();
+    return stored;
+}
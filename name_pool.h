@@ -0,0 +1,99 @@
+#ifndef NAME_POOL_H
+#define NAME_POOL_H
+
+// -----------------------------------------------------------------------------
+// File: name_pool.h
+// Purpose: Declare NamePool, the process-wide table of interned food names
+//          that Food refers to by a 32-bit id.
+// -----------------------------------------------------------------------------
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#ifdef _MSC_VER
+#include <intrin.h>  // _BitScanReverse
+#endif
+
+// Id of the empty name, which every pool contains.
+const uint32_t EMPTY_NAME_ID = 0;
+
+// -----------------------------------------------------------------------------
+// Class: NamePool
+// Purpose: Stores each distinct name once and hands out dense ids, so equal
+//          names have equal ids.
+//          - The text lives in a bump arena: large chunks are filled front to
+//            back and never freed or moved, so a name's text stays valid for
+//            the lifetime of the program.
+//          - Ids index a table of string_views into the arena. The table is
+//            split into segments that double in size and never move, so
+//            looking a name up by id is two array reads.
+//          - Text is mapped back to ids by an open-addressing hash table that
+//            holds only ids (4 bytes a slot, at most half full) and compares
+//            candidates through the id table.
+//          intern() is not thread-safe; names are interned on the UI/loading
+//          thread. Because nothing is moved, text() may be called from any
+//          thread for an id handed over from that thread (for example in a
+//          DataSnapshot) while interning goes on.
+// -----------------------------------------------------------------------------
+class NamePool {
+public:
+    // The pool shared by every Food.
+    static NamePool &instance();
+
+    // Returns the id of 'text', copying it into the arena if it is new.
+    uint32_t intern(std::string_view text);
+    // Text of an id returned by intern().
+    std::string_view text(uint32_t id) const {
+        uint32_t biased = id + FIRST_SEGMENT_SIZE;
+        int segment = highestBit(biased) - FIRST_SEGMENT_BITS;
+        return segments[segment][biased - (FIRST_SEGMENT_SIZE << segment)];
+    }
+
+    size_t size() const { return count; }
+    // Bytes reserved by the arena chunks.
+    size_t arenaBytes() const { return reservedBytes; }
+
+private:
+    NamePool();
+    NamePool(const NamePool &) = delete;
+    NamePool &operator=(const NamePool &) = delete;
+
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;  // Arena growth step
+    // Segment k of the id table holds FIRST_SEGMENT_SIZE << k ids, so ids
+    // below 2^32 - FIRST_SEGMENT_SIZE fit in SEGMENT_COUNT segments.
+    static constexpr int FIRST_SEGMENT_BITS = 10;
+    static constexpr uint32_t FIRST_SEGMENT_SIZE = 1u << FIRST_SEGMENT_BITS;
+    static constexpr int SEGMENT_COUNT = 32 - FIRST_SEGMENT_BITS;
+
+    std::vector<std::unique_ptr<char[]>> chunks;        // Arena chunks, oldest first
+    char *cursor;                                       // Next free byte in the newest chunk
+    size_t available;                                   // Free bytes after 'cursor'
+    size_t reservedBytes;                               // Total size of all chunks
+    std::unique_ptr<std::string_view[]> segments[SEGMENT_COUNT];  // Id -> text in the arena
+    uint32_t count;                                     // Ids handed out so far
+    std::vector<uint32_t> slots;                        // Hash table of ids, size a power of two
+
+    static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;  // Free slot in the hash table
+
+    // Copies 'text' to the arena and returns the copy.
+    std::string_view store(std::string_view text);
+    // Slot holding 'text', or the free slot where it belongs.
+    size_t findSlot(std::string_view text) const;
+    // Doubles the hash table and reinserts every id.
+    void grow();
+
+    // Index of the highest set bit of a non-zero value.
+    static int highestBit(uint32_t value) {
+#ifdef _MSC_VER
+        unsigned long bit;
+        _BitScanReverse(&bit, value);
+        return static_cast<int>(bit);
+#else
+        return 31 - __builtin_clz(value);
+#endif
+    }
+};
+
+#endif // NAME_POOL_H
@@ -0,0 +1,135 @@
+#include "parallel_text_loader.h"
+#include <thread>
+#include <system_error>  // Thrown when a thread cannot be started
+#include <unordered_map>
+
+// -----------------------------------------------------------------------------
+// Function: splitTextAtDates
+// Purpose: Aims each cut at an equal share of the bytes, then moves it
+//          forward to the next DATE: line. A cut that finds no DATE: line
+//          leaves the rest of the file to the last piece.
+// -----------------------------------------------------------------------------
+std::vector<std::string_view> splitTextAtDates(std::string_view text, size_t maxChunks) {
+    std::vector<std::string_view> chunks;
+    size_t start = 0;
+    for (size_t i = 1; i < maxChunks; i++) {
+        size_t target = text.size() / maxChunks * i;
+        if (target <= start)
+            continue;
+        // Searching from the byte before 'target' also accepts a DATE: line
+        // that begins exactly at it.
+        size_t cut = text.find("\nDATE:", target - 1);
+        if (cut == std::string_view::npos)
+            break;
+        chunks.push_back(text.substr(start, cut + 1 - start));
+        start = cut + 1;
+    }
+    chunks.push_back(text.substr(start));
+    return chunks;
+}
+
+// -----------------------------------------------------------------------------
+// Function: parseTextChunk
+// Purpose: The loop of DataManager::loadTextMapped, writing to the chunk.
+//          Names are numbered in order of first appearance through a local
+//          table, so each distinct name is interned once per chunk at merge.
+// -----------------------------------------------------------------------------
+void parseTextChunk(std::string_view text, TextChunk &chunk) {
+    std::unordered_map<std::string_view, uint32_t> nameIds;
+    // Data lines are about 30 bytes, so this avoids most regrowth.
+    chunk.foods.reserve(text.size() / 32);
+    Date currentDate;
+    bool dateValid = false;
+    TextChunkDay *currentDay = nullptr;
+    while (!text.empty()) {
+        size_t lineEnd = text.find('\n');
+        std::string_view line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+
+        if (line.compare(0, 12, "DAILY_GOALS:") == 0) {
+            chunk.goalLines.push_back(line.substr(12));
+        }
+        else if (line.compare(0, 5, "DATE:") == 0) {
+            std::string_view dateStr = line.substr(5);
+            size_t start = dateStr.find_first_not_of(" \t");
+            dateStr.remove_prefix(start == std::string_view::npos ? dateStr.size() : start);
+            dateValid = Date::parse(dateStr, currentDate);
+            currentDay = nullptr;
+        }
+        else if (line.compare(0, 5, "FOOD:") == 0 && dateValid) {
+            // As in the sequential loaders, a block exists once it has a food.
+            if (!currentDay) {
+                chunk.days.push_back(TextChunkDay{ currentDate, static_cast<uint32_t>(chunk.foods.size()), 0, 0, 0, 0, 0 });
+                currentDay = &chunk.days.back();
+            }
+            std::string_view fields = line.substr(5);
+            if (!fields.empty() && fields.front() == ' ')
+                fields.remove_prefix(1);
+            Food food;
+            std::string_view name = parseFoodValues(fields, food);
+            auto found = nameIds.emplace(name, static_cast<uint32_t>(chunk.names.size()));
+            if (found.second)
+                chunk.names.push_back(name);
+            food.nameId = found.first->second;
+            chunk.foods.push_back(food);
+            currentDay->foodCount++;
+            currentDay->calories += food.calories;
+            currentDay->carbs += food.carbs;
+            currentDay->protein += food.protein;
+            currentDay->fat += food.fat;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function: runPerChunk
+// Purpose: The first task runs on the calling thread. If a thread cannot be
+//          started its task runs here instead.
+// -----------------------------------------------------------------------------
+void runPerChunk(size_t count, const std::function<void(size_t)> &task) {
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < count; i++) {
+        try {
+            workers.emplace_back(task, i);
+        } catch (const std::system_error &) {
+            task(i);
+        }
+    }
+    if (count > 0)
+        task(0);
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+// -----------------------------------------------------------------------------
+// Function: parseTextParallel
+// Purpose: One thread per piece. The pieces share nothing, so the threads
+//          need no locks.
+// -----------------------------------------------------------------------------
+void parseTextParallel(std::string_view text, std::vector<TextChunk> &chunks, size_t maxThreads) {
+    size_t threads = maxThreads != 0 ? maxThreads : std::thread::hardware_concurrency();
+    size_t bySize = text.size() / PARALLEL_LOAD_MIN_CHUNK_BYTES;
+    if (threads > bySize)
+        threads = bySize;
+    if (threads == 0)
+        threads = 1;
+    std::vector<std::string_view> pieces = splitTextAtDates(text, threads);
+    chunks.clear();
+    chunks.resize(pieces.size());
+    runPerChunk(pieces.size(), [&pieces, &chunks](size_t i) { parseTextChunk(pieces[i], chunks[i]); });
+}
+
+// -----------------------------------------------------------------------------
+// Function: writeTextChunk
+// Purpose: set() only touches the chunk's own rows, so chunks can be written
+//          without locks.
+// -----------------------------------------------------------------------------
+void writeTextChunk(const TextChunk &chunk, FoodColumns &columns) {
+    for (size_t f = 0; f < chunk.foods.size(); f++) {
+        Food food = chunk.foods[f];
+        food.nameId = chunk.nameIds[food.nameId];
+        columns.set(chunk.firstRow + static_cast<uint32_t>(f), food);
+    }
+}
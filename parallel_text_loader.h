@@ -0,0 +1,85 @@
+#ifndef PARALLEL_TEXT_LOADER_H
+#define PARALLEL_TEXT_LOADER_H
+
+// -----------------------------------------------------------------------------
+// File: parallel_text_loader.h
+// Purpose: Declare the pieces of the multi-threaded text data file loader:
+//          splitting the file at DATE: lines, parsing each piece on its own
+//          thread into a TextChunk, and writing the chunks' entries into the
+//          column store, again one thread per chunk, once the caller has
+//          reserved their rows.
+// -----------------------------------------------------------------------------
+
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "food.h"
+#include "food_columns.h"  // Store the parsed entries are written to
+#include "date.h"
+
+// Smallest piece worth a thread of its own; a file below twice this size is
+// parsed on the calling thread alone.
+const size_t PARALLEL_LOAD_MIN_CHUNK_BYTES = 1024 * 1024;
+
+// -----------------------------------------------------------------------------
+// Structure: TextChunkDay
+// Purpose: One DATE: block with at least one food, as a range of
+//          TextChunk::foods, and the sums of its entries.
+// -----------------------------------------------------------------------------
+struct TextChunkDay {
+    Date date;
+    uint32_t firstFood;
+    uint32_t foodCount;
+    int calories;
+    int carbs;
+    int protein;
+    int fat;
+};
+
+// -----------------------------------------------------------------------------
+// Structure: TextChunk
+// Purpose: Everything one piece of the file holds, in file order, parsed
+//          without touching shared state.
+//          - A Food's nameId indexes 'names', not the NamePool, which may only
+//            be changed on one thread. The merge interns each distinct name
+//            once into 'nameIds'.
+//          - Goal lines are kept as text so that several of them apply in
+//            file order, as they do in the sequential loaders.
+//          Every string_view points into the mapped file.
+// -----------------------------------------------------------------------------
+struct TextChunk {
+    std::vector<std::string_view> goalLines;  // Fields after each DAILY_GOALS: label
+    std::vector<TextChunkDay> days;           // Blocks in file order; a date may repeat
+    std::vector<Food> foods;                  // Entries of every block, block after block
+    std::vector<std::string_view> names;      // Chunk-local name id -> text
+
+    // Set by the merge before writeTextChunk.
+    std::vector<uint32_t> nameIds;            // Chunk-local name id -> NamePool id
+    uint32_t firstRow = 0;                    // Store row reserved for foods[0]
+};
+
+// Splits 'text' into at most 'maxChunks' consecutive pieces of roughly equal
+// size. Every piece but the first starts at a line beginning with "DATE:", so
+// each one parses without knowing the lines before it.
+std::vector<std::string_view> splitTextAtDates(std::string_view text, size_t maxChunks);
+
+// Parses one piece with the rules of DataManager's mapped loader. Safe to run
+// on several pieces at once.
+void parseTextChunk(std::string_view text, TextChunk &chunk);
+
+// Splits 'text' into one piece per hardware thread, or at most 'maxThreads'
+// if that is not 0 (fewer for small files), and parses the pieces
+// concurrently. 'chunks' receives them in file order.
+void parseTextParallel(std::string_view text, std::vector<TextChunk> &chunks, size_t maxThreads = 0);
+
+// Writes the chunk's foods, with NamePool ids, to the rows reserved for them.
+// Chunks with disjoint rows may be written at the same time.
+void writeTextChunk(const TextChunk &chunk, FoodColumns &columns);
+
+// Calls task(i) for i in [0, count), each on its own thread, and returns
+// when all are done.
+void runPerChunk(size_t count, const std::function<void(size_t)> &task);
+
+#endif // PARALLEL_TEXT_LOADER_H
@@ -0,0 +1,208 @@
+#include "persistence_worker.h"
+#include <iostream>     // For error output
+#include <chrono>
+#include <utility>
+
+// -----------------------------------------------------------------------------
+// Constructor: PersistQueue
+// Purpose: Allocate every slot up front; pushing never allocates a slot.
+// -----------------------------------------------------------------------------
+PersistQueue::PersistQueue(size_t capacity) : slots(capacity), mask(capacity - 1), head(0), tail(0) {
+}
+
+// -----------------------------------------------------------------------------
+// Method: tryPush
+// Purpose: Fills the slot at 'tail', then publishes it by advancing 'tail'.
+//          The store is sequentially consistent so PersistenceWorker::post
+//          can tell, right after it, whether the consumer went to sleep
+//          without seeing the message.
+// -----------------------------------------------------------------------------
+bool PersistQueue::tryPush(PersistMessage &message) {
+    size_t position = tail.load(std::memory_order_relaxed);
+    if (position - head.load(std::memory_order_acquire) == slots.size())
+        return false;
+    slots[position & mask] = std::move(message);
+    tail.store(position + 1);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: tryPop
+// Purpose: Takes the message at 'head', then frees its slot by advancing 'head'.
+// -----------------------------------------------------------------------------
+bool PersistQueue::tryPop(PersistMessage &message) {
+    size_t position = head.load(std::memory_order_relaxed);
+    if (position == tail.load(std::memory_order_acquire))
+        return false;
+    message = std::move(slots[position & mask]);
+    head.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: empty
+// Purpose: Consumer-side check, sequentially consistent to pair with tryPush.
+// -----------------------------------------------------------------------------
+bool PersistQueue::empty() const {
+    return head.load(std::memory_order_relaxed) == tail.load();
+}
+
+// -----------------------------------------------------------------------------
+// Constructor: PersistenceWorker
+// Purpose: Start the worker thread with an empty queue.
+// -----------------------------------------------------------------------------
+PersistenceWorker::PersistenceWorker(Journal &j, DayStore &s)
+    : journal(j), store(s), queue(QUEUE_CAPACITY), sleeping(false), failures(0), stopping(false),
+      flushesPosted(0), flushesDone(0), messagesPosted(0), messagesDone(0) {
+    worker = std::thread(&PersistenceWorker::workerLoop, this);
+}
+
+// -----------------------------------------------------------------------------
+// Destructor: PersistenceWorker
+// Purpose: Let the worker finish every queued message and sync the journal,
+//          then wait for it to exit.
+// -----------------------------------------------------------------------------
+PersistenceWorker::~PersistenceWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable())
+        worker.join();
+}
+
+// -----------------------------------------------------------------------------
+// Methods: appendChange / writeSnapshot
+// Purpose: Wrap the work in a message and queue it.
+// -----------------------------------------------------------------------------
+void PersistenceWorker::appendChange(std::string payload) {
+    PersistMessage message;
+    message.kind = PERSIST_CHANGE;
+    message.text = std::move(payload);
+    post(message);
+}
+
+void PersistenceWorker::writeSnapshot(std::shared_ptr<const DataSnapshot> snapshot, uint16_t generation,
+                                      uint64_t changeCount, std::string journalHeader) {
+    PersistMessage message;
+    message.kind = PERSIST_SNAPSHOT;
+    message.text = std::move(journalHeader);
+    message.snapshot = std::move(snapshot);
+    message.generation = generation;
+    message.changeCount = changeCount;
+    post(message);
+}
+
+// -----------------------------------------------------------------------------
+// Method: flush
+// Purpose: Queues a flush marker behind everything posted so far and waits
+//          for the worker to reach it.
+// -----------------------------------------------------------------------------
+void PersistenceWorker::flush() {
+    PersistMessage message;
+    message.kind = PERSIST_FLUSH;
+    uint64_t target = ++flushesPosted;
+    post(message);
+    std::unique_lock<std::mutex> lock(mutex);
+    flushed.wait(lock, [this, target] { return flushesDone >= target; });
+}
+
+// -----------------------------------------------------------------------------
+// Method: post
+// Purpose: The ring only fills if the disk falls a whole queue behind; the
+//          producer then yields until the worker frees a slot. The lock is
+//          taken only to wake a sleeping worker: 'sleeping' is read after the
+//          message is published and the worker sets it before its last look
+//          at the queue, so one of the two always sees the other.
+// -----------------------------------------------------------------------------
+void PersistenceWorker::post(PersistMessage &message) {
+    while (!queue.tryPush(message))
+        std::this_thread::yield();
+    messagesPosted++;
+    if (sleeping.load()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wake.notify_one();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Method: workerLoop
+// Purpose: Applies queued messages in order. When the queue runs dry it syncs
+//          journal records whose interval has run out, then sleeps until the
+//          next message, shutdown, or the next sync deadline. The journal
+//          belongs to the owner until the first message arrives, so its state
+//          is not read before then.
+// -----------------------------------------------------------------------------
+void PersistenceWorker::workerLoop() {
+    PersistMessage message;
+    bool ownsJournal = false;
+    for (;;) {
+        if (queue.tryPop(message)) {
+            ownsJournal = true;
+            process(message);
+            messagesDone++;
+            continue;
+        }
+        bool syncPending = ownsJournal && journal.hasUnsynced();
+        if (syncPending && std::chrono::steady_clock::now() >= journal.syncDeadline()) {
+            if (!journal.sync())
+                failures++;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stopping) {
+            // Everything was posted before 'stopping' was set, so the queue
+            // is now final; it may have filled since the pop above.
+            if (queue.empty())
+                break;
+            continue;
+        }
+        sleeping.store(true);
+        auto ready = [this] { return stopping || !queue.empty(); };
+        if (syncPending)
+            wake.wait_until(lock, journal.syncDeadline(), ready);
+        else
+            wake.wait(lock, ready);
+        sleeping.store(false);
+    }
+    if (ownsJournal && !journal.sync())
+        failures++;
+}
+
+// -----------------------------------------------------------------------------
+// Method: process
+// Purpose: Performs one message's writes. A failed write is counted so the
+//          owner can react on its own thread.
+// -----------------------------------------------------------------------------
+void PersistenceWorker::process(PersistMessage &message) {
+    switch (message.kind) {
+    case PERSIST_CHANGE:
+        if (!journal.append(message.text))
+            failures++;
+        break;
+    case PERSIST_SNAPSHOT:
+        if (store.save(*message.snapshot, message.generation, message.changeCount, true)) {
+            // Everything journaled so far is now part of the data file. If the
+            // journal outlives a crash here, its old header marks it as folded.
+            journal.reset();
+            journal.setHeader(message.text);
+        } else {
+            std::cerr << "Error saving data!" << std::endl;
+            failures++;
+        }
+        // Let go of the snapshot now rather than at the next pop, so days
+        // changed since it was taken can be freed.
+        message.snapshot.reset();
+        break;
+    case PERSIST_FLUSH:
+        if (!journal.sync())
+            failures++;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            flushesDone++;
+        }
+        flushed.notify_all();
+        break;
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef PERSISTENCE_WORKER_H
+#define PERSISTENCE_WORKER_H
+
+// -----------------------------------------------------------------------------
+// File: persistence_worker.h
+// Purpose: Declare PersistenceWorker, which performs a DataManager's file
+//          writes on a worker thread so the UI never waits for the disk.
+// -----------------------------------------------------------------------------
+
+#include "journal.h"  // Change log written by the worker
+#include "data_snapshot.h"  // What a snapshot message saves
+#include "day_store.h"  // Data file replaced by snapshots
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// Enum: PersistKind
+// Purpose: What a queued PersistMessage asks the worker to do.
+// -----------------------------------------------------------------------------
+enum PersistKind {
+    PERSIST_CHANGE,    // Append 'text' to the journal
+    PERSIST_SNAPSHOT,  // Replace the data file with 'snapshot', then start a new journal headed by 'text'
+    PERSIST_FLUSH      // Sync the journal and report back to flush()
+};
+
+// -----------------------------------------------------------------------------
+// Structure: PersistMessage
+// Purpose: One unit of work handed from the UI thread to the worker.
+// -----------------------------------------------------------------------------
+struct PersistMessage {
+    PersistKind kind = PERSIST_CHANGE;
+    std::string text;                 // Journal payload, or the new journal's header
+    std::shared_ptr<const DataSnapshot> snapshot;  // Data to save (PERSIST_SNAPSHOT only)
+    uint16_t generation = 0;          // Generation the saved file is tagged with
+    uint64_t changeCount = 0;         // Owner's change count the snapshot includes
+};
+
+// -----------------------------------------------------------------------------
+// Class: PersistQueue
+// Purpose: Fixed-size ring of messages for exactly one producer thread and one
+//          consumer thread. Each side owns one index and only reads the
+//          other's, so neither push nor pop takes a lock.
+// -----------------------------------------------------------------------------
+class PersistQueue {
+public:
+    // 'capacity' must be a power of two.
+    explicit PersistQueue(size_t capacity);
+
+    // Producer: moves 'message' into the ring. Returns false if it is full.
+    bool tryPush(PersistMessage &message);
+    // Consumer: moves the oldest message out. Returns false if it is empty.
+    bool tryPop(PersistMessage &message);
+    bool empty() const;
+
+private:
+    std::vector<PersistMessage> slots;
+    size_t mask;                   // slots.size() - 1
+    // The indices count up without wrapping; the slot is index & mask. They
+    // sit on separate cache lines so the two threads do not share one.
+    alignas(64) std::atomic<size_t> head;  // Next message to pop; written by the consumer
+    alignas(64) std::atomic<size_t> tail;  // Next free slot; written by the producer
+};
+
+// -----------------------------------------------------------------------------
+// Class: PersistenceWorker
+// Purpose: Owns the thread that writes one DataManager's journal and data
+//          file. The owner's thread posts changes and snapshots and returns
+//          at once; the worker applies them in order.
+//          - While idle the worker syncs journal records whose sync interval
+//            has run out, so a single change is not left waiting for the
+//            next one.
+//          - flush() waits until everything posted is written and synced.
+//            The destructor lets the worker finish the queue and sync before
+//            the thread stops, so every change made before a normal exit
+//            reaches the disk.
+//          - A change still in the queue when the process is killed is lost;
+//            what is on disk is always the changes in order up to some point.
+//          The Journal is only touched by the worker once the first message
+//          has been posted.
+// -----------------------------------------------------------------------------
+class PersistenceWorker {
+public:
+    PersistenceWorker(Journal &journal, DayStore &store);
+    ~PersistenceWorker();
+
+    // Queues one journal record.
+    void appendChange(std::string payload);
+    // Queues a replacement data file, encoded and written on the worker.
+    // Once it is written the journal is emptied and restarted with
+    // 'journalHeader' as its first record, and the store reports
+    // 'changeCount' as saved.
+    void writeSnapshot(std::shared_ptr<const DataSnapshot> snapshot, uint16_t generation, uint64_t changeCount,
+                       std::string journalHeader);
+
+    // Blocks until every message posted so far is done and the journal is
+    // synced.
+    void flush();
+
+    // True once every message posted so far is done, so the destructor only
+    // has a final journal sync left. Does not wait.
+    bool idle() const { return messagesDone.load() == messagesPosted; }
+    // Number of writes that have failed so far. When it changes the owner
+    // posts a snapshot, which saves a lost change another way.
+    uint32_t failureCount() const { return failures.load(); }
+
+private:
+    PersistenceWorker(const PersistenceWorker &) = delete;
+    PersistenceWorker &operator=(const PersistenceWorker &) = delete;
+
+    static const size_t QUEUE_CAPACITY = 256;  // Messages the worker may fall behind by
+
+    Journal &journal;                  // Written only by the worker once it runs
+    DayStore &store;                   // Data file replaced by snapshots
+    PersistQueue queue;                // UI thread -> worker
+    std::mutex mutex;                  // For sleeping and waking only; the queue needs none
+    std::condition_variable wake;      // Signals the worker: messages or shutdown
+    std::condition_variable flushed;   // Signals flush(): 'flushesDone' advanced
+    std::atomic<bool> sleeping;        // The worker is waiting on 'wake'
+    std::atomic<uint32_t> failures;    // See failureCount; written by the worker
+    bool stopping;                     // Set by the destructor; guarded by 'mutex'
+    uint64_t flushesPosted;            // Owner thread only
+    uint64_t flushesDone;              // Guarded by 'mutex'
+    uint64_t messagesPosted;           // Owner thread only
+    std::atomic<uint64_t> messagesDone;  // Written by the worker after each message
+    std::thread worker;
+
+    // Queues a message, yielding while the ring is full, and wakes the worker.
+    void post(PersistMessage &message);
+    // Applies messages until 'stopping' is set and the queue is empty.
+    void workerLoop();
+    void process(PersistMessage &message);
+};
+
+#endif // PERSISTENCE_WORKER_H
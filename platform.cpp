@@ -0,0 +1,13 @@
+#include "platform.h"
+
+// -----------------------------------------------------------------------------
+// Function: toLocalTime
+// Purpose: Thread-safe localtime on both platforms.
+// -----------------------------------------------------------------------------
+bool toLocalTime(std::time_t time, std::tm &out) {
+#ifdef _WIN32
+    return localtime_s(&out, &time) == 0;
+#else
+    return localtime_r(&time, &out) != nullptr;
+#endif
+}
@@ -0,0 +1,16 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// -----------------------------------------------------------------------------
+// File: platform.h
+// Purpose: Declare small wrappers over C library functions whose thread-safe
+//          variants are spelled differently on Windows and POSIX.
+// -----------------------------------------------------------------------------
+
+#include <ctime>
+
+// Converts 'time' to local calendar time (localtime_s on Windows, localtime_r
+// elsewhere). Returns false if the time cannot be represented.
+bool toLocalTime(std::time_t time, std::tm &out);
+
+#endif // PLATFORM_H
@@ -0,0 +1,168 @@
+#include "profile_registry.h"
+#include "constants.h"  // DEFAULT_PROFILE, JOURNAL_SYNC_INTERVAL_MS
+#include "durable_file.h"  // Atomic list rewrite
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+
+// -----------------------------------------------------------------------------
+// Constructor: ProfileRegistry
+// Purpose: Starts with only the default profile; nothing is read yet.
+// -----------------------------------------------------------------------------
+ProfileRegistry::ProfileRegistry(const std::string &path, size_t maxLoaded)
+    : listPath(path), capacity(maxLoaded > 0 ? maxLoaded : 1), loader(LOADER_PARALLEL),
+      syncInterval(JOURNAL_SYNC_INTERVAL_MS) {
+    profileNames.push_back(DEFAULT_PROFILE);
+}
+
+// -----------------------------------------------------------------------------
+// Method: load
+// Purpose: One name per line; invalid and repeated names are ignored.
+// -----------------------------------------------------------------------------
+void ProfileRegistry::load() {
+    std::ifstream inFile(listPath);
+    std::string line;
+    while (std::getline(inFile, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (isValidName(line) && !contains(line))
+            profileNames.push_back(line);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Method: names / contains
+// Purpose: The known profiles.
+// -----------------------------------------------------------------------------
+const std::vector<std::string> &ProfileRegistry::names() const {
+    return profileNames;
+}
+
+bool ProfileRegistry::contains(const std::string &name) const {
+    return std::find(profileNames.begin(), profileNames.end(), name) != profileNames.end();
+}
+
+// -----------------------------------------------------------------------------
+// Method: add
+// Purpose: Registers a new, empty profile.
+// -----------------------------------------------------------------------------
+bool ProfileRegistry::add(const std::string &name) {
+    if (!isValidName(name) || contains(name))
+        return false;
+    profileNames.push_back(name);
+    if (!saveList()) {
+        profileNames.pop_back();
+        return false;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Method: isValidName
+// Purpose: Keeps names usable as part of a file name on every platform.
+// -----------------------------------------------------------------------------
+bool ProfileRegistry::isValidName(const std::string &name) {
+    if (name.empty() || name.size() > 32)
+        return false;
+    for (char ch : name) {
+        bool allowed = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+                       (ch >= '0' && ch <= '9') || ch == '-' || ch == '_';
+        if (!allowed)
+            return false;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Methods: setLoader / setSyncInterval
+// Purpose: Affect profiles loaded after the call.
+// -----------------------------------------------------------------------------
+void ProfileRegistry::setLoader(LoaderType type) {
+    loader = type;
+}
+
+void ProfileRegistry::setSyncInterval(uint32_t milliseconds) {
+    syncInterval = milliseconds;
+}
+
+// -----------------------------------------------------------------------------
+// Method: open
+// Purpose: LRU lookup. A hit moves the entry to the front; a miss takes the
+//          profile back from 'unloading' or loads it, at the front, and
+//          unloads from the back. Unloading queues a save that folds the
+//          profile's journal into its data file and moves it to 'unloading'.
+// -----------------------------------------------------------------------------
+DataManager &ProfileRegistry::open(const std::string &name) {
+    auto it = loadedIndex.find(name);
+    if (it != loadedIndex.end()) {
+        loaded.splice(loaded.begin(), loaded, it->second);
+        return *loaded.front().data;
+    }
+
+    auto parked = std::find_if(unloading.begin(), unloading.end(),
+                               [&name](const LoadedProfile &profile) { return profile.name == name; });
+    if (parked != unloading.end()) {
+        loaded.splice(loaded.begin(), unloading, parked);
+    } else {
+        DataFiles files = (name == DEFAULT_PROFILE) ? DataFiles::defaults() : DataFiles::forProfile(name);
+        std::unique_ptr<DataManager> data(new DataManager(files));
+        data->setLoader(loader);
+        data->setSyncInterval(syncInterval);
+        data->loadData();
+        loaded.push_front(LoadedProfile{ name, std::move(data) });
+    }
+    loadedIndex[name] = loaded.begin();
+
+    while (loaded.size() > capacity) {
+        loadedIndex.erase(loaded.back().name);
+        loaded.back().data->saveInBackground();
+        unloading.splice(unloading.end(), loaded, std::prev(loaded.end()));
+    }
+    releaseUnloaded();
+    return *loaded.front().data;
+}
+
+// -----------------------------------------------------------------------------
+// Method: releaseUnloaded
+// Purpose: A profile whose worker is idle is destroyed at once. Waiting for
+//          the oldest bounds the memory held by profiles still saving.
+// -----------------------------------------------------------------------------
+void ProfileRegistry::releaseUnloaded() {
+    for (auto it = unloading.begin(); it != unloading.end();) {
+        if (it->data->saving())
+            ++it;
+        else
+            it = unloading.erase(it);
+    }
+    while (unloading.size() > capacity)
+        unloading.pop_front();
+}
+
+// -----------------------------------------------------------------------------
+// Methods: isLoaded / loadedCount
+// Purpose: What is in memory.
+// -----------------------------------------------------------------------------
+bool ProfileRegistry::isLoaded(const std::string &name) const {
+    if (loadedIndex.find(name) != loadedIndex.end())
+        return true;
+    return std::any_of(unloading.begin(), unloading.end(),
+                       [&name](const LoadedProfile &profile) { return profile.name == name; });
+}
+
+size_t ProfileRegistry::loadedCount() const {
+    return loaded.size();
+}
+
+// -----------------------------------------------------------------------------
+// Method: saveList
+// Purpose: Rewrites the list file in place of the old one. The default
+//          profile is implied.
+// -----------------------------------------------------------------------------
+bool ProfileRegistry::saveList() const {
+    std::string text;
+    for (const auto &name : profileNames) {
+        if (name != DEFAULT_PROFILE)
+            text += name + '\n';
+    }
+    return writeFileAtomically(listPath, text.data(), text.size(), true);
+}
@@ -0,0 +1,94 @@
+#ifndef PROFILE_REGISTRY_H
+#define PROFILE_REGISTRY_H
+
+// -----------------------------------------------------------------------------
+// File: profile_registry.h
+// Purpose: Declare the ProfileRegistry class, which lists the people whose
+//          data this installation keeps and loads each one's DataManager on
+//          demand.
+// -----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include "data_manager.h"
+
+// -----------------------------------------------------------------------------
+// Class: ProfileRegistry
+// Purpose: Owns one DataManager per loaded profile.
+//          - The profile names are read from a small list file at startup; no
+//            profile's data is touched until it is opened, so startup does not
+//            depend on how many profiles exist.
+//          - Loaded profiles are kept in least-recently-used order. Opening a
+//            loaded profile is a hash lookup and a list splice; opening one
+//            more than 'capacity' unloads the least recently used.
+//          - Unloading queues the profile's save on its persistence worker
+//            and keeps it in memory until the save is written, so a switch
+//            never waits for the disk. Opening it again meanwhile takes it
+//            back as it is. Unloaded profiles are let go by later calls to
+//            open() once their saves are done, or waited for if more than
+//            'capacity' of them are still saving.
+//          - DEFAULT_PROFILE always exists and uses DataFiles::defaults(), so
+//            data from single-user installs is picked up unchanged.
+// -----------------------------------------------------------------------------
+class ProfileRegistry {
+public:
+    ProfileRegistry(const std::string &listPath, size_t capacity);
+
+    // Reads the profile list. Missing or unreadable lists leave just the default profile.
+    void load();
+
+    // Profile names in the order they were added, DEFAULT_PROFILE first.
+    const std::vector<std::string> &names() const;
+    bool contains(const std::string &name) const;
+
+    // Adds a profile and rewrites the list file. Returns false if the name is
+    // invalid or already taken. The profile's files are created on first save.
+    bool add(const std::string &name);
+
+    // Letters, digits, '-' and '_', at most 32 characters, so the name is
+    // safe inside a file name.
+    static bool isValidName(const std::string &name);
+
+    // Parser and journal sync interval used for profiles loaded from now on.
+    void setLoader(LoaderType type);
+    void setSyncInterval(uint32_t milliseconds);
+
+    // Returns the named profile's data, loading it if it is not in memory and
+    // marking it most recently used. The reference stays valid until
+    // 'capacity' other profiles have been opened after it. 'name' must be
+    // one of names().
+    DataManager &open(const std::string &name);
+
+    // True if the profile is in memory, so open() will not touch the disk.
+    // This includes an unloaded profile whose save is still being written.
+    bool isLoaded(const std::string &name) const;
+    // Number of loaded profiles, at most 'capacity'; unloaded profiles still
+    // saving are not counted.
+    size_t loadedCount() const;
+
+private:
+    struct LoadedProfile {
+        std::string name;
+        std::unique_ptr<DataManager> data;
+    };
+
+    std::string listPath;                    // Location of the profile list file
+    size_t capacity;                         // Most profiles kept in memory at once
+    LoaderType loader;                       // Passed to every DataManager created
+    uint32_t syncInterval;                   // Likewise
+    std::vector<std::string> profileNames;   // Known profiles, DEFAULT_PROFILE first
+    std::list<LoadedProfile> loaded;         // In memory, most recently used first
+    std::unordered_map<std::string, std::list<LoadedProfile>::iterator> loadedIndex;  // Name -> entry in 'loaded'
+    std::list<LoadedProfile> unloading;      // Unloaded, oldest first, until their saves are written
+
+    // Writes every name except DEFAULT_PROFILE to the list file.
+    bool saveList() const;
+    // Lets go of unloaded profiles whose saves are done, and waits for the
+    // oldest while more than 'capacity' are still saving.
+    void releaseUnloaded();
+};
+
+#endif // PROFILE_REGISTRY_H
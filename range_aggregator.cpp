@@ -0,0 +1,203 @@
+#include "range_aggregator.h"
+#include <algorithm>
+
+// -----------------------------------------------------------------------------
+// Operators: RangeValues += / -=
+// Purpose: Field-wise sums, the only operations the Fenwick tree needs.
+// -----------------------------------------------------------------------------
+RangeValues &RangeValues::operator+=(const RangeValues &other) {
+    calories += other.calories;
+    carbs += other.carbs;
+    protein += other.protein;
+    fat += other.fat;
+    entries += other.entries;
+    loggedDays += other.loggedDays;
+    return *this;
+}
+
+RangeValues &RangeValues::operator-=(const RangeValues &other) {
+    calories -= other.calories;
+    carbs -= other.carbs;
+    protein -= other.protein;
+    fat -= other.fat;
+    entries -= other.entries;
+    loggedDays -= other.loggedDays;
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+// Constructor: RangeAggregator
+// Purpose: Start with no days.
+// -----------------------------------------------------------------------------
+RangeAggregator::RangeAggregator() : deferred(false), tree(1) {
+}
+
+// -----------------------------------------------------------------------------
+// Method: clear
+// Purpose: Drops all days and their values.
+// -----------------------------------------------------------------------------
+void RangeAggregator::clear() {
+    keys.clear();
+    days.clear();
+    pending.clear();
+    tree.assign(1, RangeValues());
+}
+
+// -----------------------------------------------------------------------------
+// Method: lowerBound
+// Purpose: Binary search of the sorted day numbers.
+// -----------------------------------------------------------------------------
+size_t RangeAggregator::lowerBound(int32_t day) const {
+    return static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), day) - keys.begin());
+}
+
+// -----------------------------------------------------------------------------
+// Method: add
+// Purpose: Records the change for one day and, unless building is deferred,
+//          propagates it up the tree. A day after all others gets its own
+//          tree node from two prefix sums: node i covers days
+//          (i - lowbit(i), i], all of which are already in the tree.
+// -----------------------------------------------------------------------------
+void RangeAggregator::add(int32_t day, const RangeValues &delta) {
+    if (deferred) {
+        // Days after every other one, as a load from a sorted file adds
+        // them, go straight to the sorted arrays and need no sort.
+        if (keys.empty() || day > keys.back()) {
+            keys.push_back(day);
+            days.push_back(delta);
+        } else {
+            pending.emplace_back(day, delta);
+        }
+        return;
+    }
+    size_t index = lowerBound(day);
+    if (index == keys.size()) {
+        keys.push_back(day);
+        days.push_back(delta);
+        size_t node = days.size();
+        RangeValues sum = delta;
+        sum += prefix(node - 1);
+        sum -= prefix(node - (node & (~node + 1)));
+        tree.push_back(sum);
+        return;
+    }
+    if (keys[index] != day) {
+        keys.insert(keys.begin() + index, day);
+        days.insert(days.begin() + index, delta);
+        rebuildTree();
+        return;
+    }
+    days[index] += delta;
+    for (size_t i = index + 1; i < tree.size(); i += i & (~i + 1))
+        tree[i] += delta;
+}
+
+// -----------------------------------------------------------------------------
+// Method: beginBulk
+// Purpose: Defers sorting and tree maintenance until build().
+// -----------------------------------------------------------------------------
+void RangeAggregator::beginBulk(size_t expectedDays) {
+    deferred = true;
+    keys.reserve(keys.size() + expectedDays);
+    days.reserve(days.size() + expectedDays);
+}
+
+// -----------------------------------------------------------------------------
+// Method: build
+// Purpose: Sorts the deferred values that came out of order and merges them
+//          into the sorted days in one pass, summing values of the same day,
+//          then builds the tree once. Ends a bulk load.
+// -----------------------------------------------------------------------------
+void RangeAggregator::build() {
+    deferred = false;
+    if (!pending.empty()) {
+        std::stable_sort(pending.begin(), pending.end(),
+                         [](const std::pair<int32_t, RangeValues> &a, const std::pair<int32_t, RangeValues> &b) {
+                             return a.first < b.first;
+                         });
+        std::vector<int32_t> mergedKeys;
+        std::vector<RangeValues> mergedDays;
+        mergedKeys.reserve(keys.size() + pending.size());
+        mergedDays.reserve(keys.size() + pending.size());
+        auto append = [&mergedKeys, &mergedDays](int32_t day, const RangeValues &value) {
+            if (!mergedKeys.empty() && mergedKeys.back() == day) {
+                mergedDays.back() += value;
+            } else {
+                mergedKeys.push_back(day);
+                mergedDays.push_back(value);
+            }
+        };
+        size_t next = 0;
+        for (const auto &entry : pending) {
+            for (; next < keys.size() && keys[next] <= entry.first; next++)
+                append(keys[next], days[next]);
+            append(entry.first, entry.second);
+        }
+        for (; next < keys.size(); next++)
+            append(keys[next], days[next]);
+        keys.swap(mergedKeys);
+        days.swap(mergedDays);
+        pending.clear();
+        pending.shrink_to_fit();
+    }
+    rebuildTree();
+}
+
+// -----------------------------------------------------------------------------
+// Method: rebuildTree
+// Purpose: Linear-time Fenwick construction: every node starts as its own
+//          day and, once complete, pushes its sum to the single parent that
+//          also covers it.
+// -----------------------------------------------------------------------------
+void RangeAggregator::rebuildTree() {
+    tree.clear();
+    tree.reserve(days.size() + 1);
+    tree.emplace_back();
+    tree.insert(tree.end(), days.begin(), days.end());
+    for (size_t i = 1; i < tree.size(); i++) {
+        size_t parent = i + (i & (~i + 1));
+        if (parent < tree.size())
+            tree[parent] += tree[i];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Method: prefix
+// Purpose: Standard Fenwick prefix sum.
+// -----------------------------------------------------------------------------
+RangeValues RangeAggregator::prefix(size_t count) const {
+    RangeValues sum;
+    for (size_t i = count; i > 0; i -= i & (~i + 1))
+        sum += tree[i];
+    return sum;
+}
+
+// -----------------------------------------------------------------------------
+// Method: query
+// Purpose: Two binary searches find the days inside the range, two prefix
+//          sums add them up.
+// -----------------------------------------------------------------------------
+RangeSummary RangeAggregator::query(int32_t firstDay, int32_t lastDay) const {
+    RangeSummary summary;
+    if (lastDay < firstDay)
+        return summary;
+    summary.days = static_cast<int64_t>(lastDay) - firstDay + 1;
+    size_t first = lowerBound(firstDay);
+    size_t end = static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), lastDay) - keys.begin());
+    if (end <= first)
+        return summary;
+    summary.totals = prefix(end);
+    summary.totals -= prefix(first);
+    return summary;
+}
+
+// -----------------------------------------------------------------------------
+// Method: perDay
+// Purpose: Zero-fills 'out' and copies the days in the range to their slots.
+// -----------------------------------------------------------------------------
+void RangeAggregator::perDay(int32_t firstDay, size_t count, RangeValues *out) const {
+    std::fill(out, out + count, RangeValues());
+    int64_t end = static_cast<int64_t>(firstDay) + static_cast<int64_t>(count);
+    for (size_t i = lowerBound(firstDay); i < keys.size() && keys[i] < end; i++)
+        out[keys[i] - firstDay] = days[i];
+}
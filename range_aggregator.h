@@ -0,0 +1,88 @@
+#ifndef RANGE_AGGREGATOR_H
+#define RANGE_AGGREGATOR_H
+
+// -----------------------------------------------------------------------------
+// File: range_aggregator.h
+// Purpose: Declare RangeAggregator, which answers "total over these days"
+//          questions (weeks, months, years) in O(log n).
+// -----------------------------------------------------------------------------
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// Structure: RangeValues
+// Purpose: Summed nutrition over a set of days, the number of food entries
+//          and how many of those days have at least one food entry.
+// -----------------------------------------------------------------------------
+struct RangeValues {
+    int64_t calories = 0;
+    int64_t carbs = 0;
+    int64_t protein = 0;
+    int64_t fat = 0;
+    int64_t entries = 0;
+    int64_t loggedDays = 0;
+
+    RangeValues &operator+=(const RangeValues &other);
+    RangeValues &operator-=(const RangeValues &other);
+};
+
+// -----------------------------------------------------------------------------
+// Structure: RangeSummary
+// Purpose: Result of a range query: the totals and the number of calendar
+//          days the range spans, so callers can average per day or per
+//          logged day.
+// -----------------------------------------------------------------------------
+struct RangeSummary {
+    RangeValues totals;
+    int64_t days = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Class: RangeAggregator
+// Purpose: Fenwick (binary indexed) tree over the days that have a value,
+//          kept in a sorted array of day numbers (Date::days()), so memory
+//          follows the number of logged days, not the span between the
+//          first and the last. Point updates and range sums are O(log n).
+//          A new day after every other one is appended in O(log n); a new
+//          day before the last one is inserted and the tree rebuilt in O(n).
+// -----------------------------------------------------------------------------
+class RangeAggregator {
+public:
+    RangeAggregator();
+
+    // Forgets every value.
+    void clear();
+    // Adds 'delta' to a single day.
+    void add(int32_t day, const RangeValues &delta);
+    // Bulk loading: between beginBulk() and build(), add() only records the
+    // per-day values; build() then sorts them and constructs the tree once
+    // in O(n log n), or O(n) if the days were added in order. 'expectedDays'
+    // reserves room for that many days.
+    void beginBulk(size_t expectedDays = 0);
+    void build();
+    // Sums every day from 'firstDay' to 'lastDay' inclusive.
+    RangeSummary query(int32_t firstDay, int32_t lastDay) const;
+    // Copies the values of 'count' consecutive days starting at 'firstDay'
+    // into 'out'; days never added are zero. One binary search, then a walk
+    // over the days in the range.
+    void perDay(int32_t firstDay, size_t count, RangeValues *out) const;
+
+private:
+    bool deferred;                   // Inside beginBulk() / build()
+    std::vector<int32_t> keys;       // Day numbers with a value, ascending
+    std::vector<RangeValues> days;   // Value of each day in 'keys'
+    std::vector<RangeValues> tree;   // Fenwick tree over 'days', 1-based, same size + 1
+    std::vector<std::pair<int32_t, RangeValues>> pending;  // add() calls since beginBulk()
+
+    // Position of the first key not before 'day'.
+    size_t lowerBound(int32_t day) const;
+    // Recomputes 'tree' from 'days' in O(n).
+    void rebuildTree();
+    // Sum of the first 'count' days in 'keys'.
+    RangeValues prefix(size_t count) const;
+};
+
+#endif // RANGE_AGGREGATOR_H
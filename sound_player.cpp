@@ -0,0 +1,97 @@
+#include "sound_player.h"
+#include "terminal.h"  // Tone output
+
+// -----------------------------------------------------------------------------
+// Method: instance
+// Purpose: Returns the shared player. A function-local static is created on
+//          first use and destroyed, joining the worker, at program exit.
+// -----------------------------------------------------------------------------
+SoundPlayer &SoundPlayer::instance() {
+    static SoundPlayer player;
+    return player;
+}
+
+// -----------------------------------------------------------------------------
+// Constructor: SoundPlayer
+// Purpose: Start the worker thread with an empty queue.
+// -----------------------------------------------------------------------------
+SoundPlayer::SoundPlayer() : stopping(false), muted(false) {
+    worker = std::thread(&SoundPlayer::workerLoop, this);
+}
+
+// -----------------------------------------------------------------------------
+// Destructor: SoundPlayer
+// Purpose: Discard waiting tones and wait for the worker to exit.
+// -----------------------------------------------------------------------------
+SoundPlayer::~SoundPlayer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        pending.clear();
+    }
+    wake.notify_one();
+    if (worker.joinable())
+        worker.join();
+}
+
+// -----------------------------------------------------------------------------
+// Method: play
+// Purpose: Adds a tone to the queue, merging it with an identical waiting tone
+//          and dropping the oldest waiting tone when the queue is full.
+// -----------------------------------------------------------------------------
+void SoundPlayer::play(unsigned frequency, unsigned durationMs) {
+    if (muted.load(std::memory_order_relaxed))
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Tone &tone : pending) {
+            if (tone.frequency == frequency && tone.durationMs == durationMs)
+                return;
+        }
+        if (pending.size() >= QUEUE_CAPACITY)
+            pending.pop_front();
+        pending.push_back(Tone{ frequency, durationMs });
+    }
+    wake.notify_one();
+}
+
+// -----------------------------------------------------------------------------
+// Method: toggleMute
+// Purpose: Flips muting; muting also drops tones that have not started yet.
+// -----------------------------------------------------------------------------
+void SoundPlayer::toggleMute() {
+    bool nowMuted = !muted.load();
+    muted.store(nowMuted);
+    if (nowMuted) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.clear();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Method: isMuted
+// Purpose: Reports whether tones are currently ignored.
+// -----------------------------------------------------------------------------
+bool SoundPlayer::isMuted() const {
+    return muted.load();
+}
+
+// -----------------------------------------------------------------------------
+// Method: workerLoop
+// Purpose: Takes one tone at a time and plays it outside the lock, so play()
+//          never waits for a tone to finish.
+// -----------------------------------------------------------------------------
+void SoundPlayer::workerLoop() {
+    for (;;) {
+        Tone tone;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (stopping)
+                return;
+            tone = pending.front();
+            pending.pop_front();
+        }
+        systemTerminal().playTone(tone.frequency, tone.durationMs);
+    }
+}
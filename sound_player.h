@@ -0,0 +1,63 @@
+#ifndef SOUND_PLAYER_H
+#define SOUND_PLAYER_H
+
+// -----------------------------------------------------------------------------
+// File: sound_player.h
+// Purpose: Declare SoundPlayer, which plays feedback tones on a worker thread
+//          so the UI never waits for a tone to finish.
+// -----------------------------------------------------------------------------
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+// -----------------------------------------------------------------------------
+// Class: SoundPlayer
+// Purpose: Queues tones for a single worker thread that plays them in order.
+//          The queue is bounded so key repeat cannot build up a backlog:
+//          - a tone already waiting in the queue is not queued again;
+//          - when the queue is full the oldest waiting tone is dropped, so the
+//            most recent action is the one heard.
+//          Muting discards waiting tones and ignores new ones.
+// -----------------------------------------------------------------------------
+class SoundPlayer {
+public:
+    // The process-wide player; the worker thread starts on first use.
+    static SoundPlayer &instance();
+
+    // Queues a tone and returns immediately.
+    void play(unsigned frequency, unsigned durationMs);
+
+    // Turns muting on or off.
+    void toggleMute();
+    bool isMuted() const;
+
+    // Stops the worker after the tone it is playing, if any.
+    ~SoundPlayer();
+
+private:
+    SoundPlayer();
+    SoundPlayer(const SoundPlayer &) = delete;
+    SoundPlayer &operator=(const SoundPlayer &) = delete;
+
+    struct Tone {
+        unsigned frequency;
+        unsigned durationMs;
+    };
+
+    static const size_t QUEUE_CAPACITY = 4;  // Tones waiting behind the one playing
+
+    std::mutex mutex;                 // Guards 'pending' and 'stopping'
+    std::condition_variable wake;     // Signals new tones or shutdown
+    std::deque<Tone> pending;         // Tones not yet started
+    bool stopping;                    // Set by the destructor
+    std::atomic<bool> muted;          // Read without the lock by play()
+    std::thread worker;
+
+    // Plays queued tones until 'stopping' is set.
+    void workerLoop();
+};
+
+#endif // SOUND_PLAYER_H
@@ -0,0 +1,767 @@
+#include "template_index.h"
+#include <algorithm>
+#include <array>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TEMPLATE_INDEX_SSE2  // SSE2 is part of x86-64
+#include <emmintrin.h>
+#endif
+
+// Longest folded term the edit-distance kernel handles; one bit per byte.
+static const size_t MAX_PATTERN_LENGTH = 64;
+
+// -----------------------------------------------------------------------------
+// Tables: accent folding
+// Purpose: Lower-case ASCII base letter for U+00C0..U+00FF and U+0100..U+017F.
+//          A '?' marks a symbol (multiplication and division signs) that is
+//          kept as it is.
+// -----------------------------------------------------------------------------
+static const char LATIN1_FOLD[] =
+    "aaaaaaaceeeeiiiidnooooo?ouuuuyts"
+    "aaaaaaaceeeeiiiidnooooo?ouuuuyty";
+static const char LATIN_EXTENDED_A_FOLD[] =
+    "aaaaaacccccccc" "dddd" "eeeeeeeeee" "gggggggg" "hhhh" "iiiiiiiiiiii" "jj" "kkk"
+    "llllllllll" "nnnnnnnnn" "oooooooo" "rrrrrr" "ssssssss" "tttttt" "uuuuuuuuuuuu"
+    "ww" "yyy" "zzzzzz" "s";
+static_assert(sizeof(LATIN1_FOLD) == 64 + 1, "one entry per code point U+00C0..U+00FF");
+static_assert(sizeof(LATIN_EXTENDED_A_FOLD) == 128 + 1, "one entry per code point U+0100..U+017F");
+
+// -----------------------------------------------------------------------------
+// Helper: foldText
+// Purpose: Lower-cases ASCII and replaces accented Latin letters with their
+//          base letter. Accented letters are read as two-byte UTF-8 when the
+//          bytes form a valid sequence and as single Latin-1 bytes otherwise,
+//          so names typed in either encoding fold the same way.
+// -----------------------------------------------------------------------------
+static void foldText(std::string_view text, std::string &out) {
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c < 0x80) {
+            out.push_back((c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : static_cast<char>(c));
+            continue;
+        }
+        size_t length = 1;
+        unsigned codePoint = c;
+        if (c >= 0xC2 && c <= 0xC5 && i + 1 < text.size() &&
+            (static_cast<unsigned char>(text[i + 1]) & 0xC0) == 0x80) {
+            codePoint = ((c & 0x1Fu) << 6) | (static_cast<unsigned char>(text[i + 1]) & 0x3Fu);
+            length = 2;
+        }
+        char folded = '?';
+        if (codePoint >= 0xC0 && codePoint <= 0xFF)
+            folded = LATIN1_FOLD[codePoint - 0xC0];
+        else if (codePoint >= 0x100 && codePoint <= 0x17F)
+            folded = LATIN_EXTENDED_A_FOLD[codePoint - 0x100];
+        if (folded != '?')
+            out.push_back(folded);
+        else
+            out.append(text.data() + i, length);
+        i += length - 1;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Helper: gramKey
+// Purpose: Packs an n-gram of one to three bytes into a single integer. The
+//          length goes in the top byte so "a", "a\0" and "a\0\0" stay distinct.
+// -----------------------------------------------------------------------------
+static uint32_t gramKey(const char *text, size_t length) {
+    uint32_t key = static_cast<uint32_t>(length) << 24;
+    for (size_t i = 0; i < length; i++)
+        key |= static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << (8 * i);
+    return key;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: maxEditsFor
+// Purpose: Typo budget for a folded term: none for short terms, where a single
+//          edit would match nearly everything, then one, then two.
+// -----------------------------------------------------------------------------
+static int maxEditsFor(size_t termLength) {
+    if (termLength <= 3)
+        return 0;
+    return termLength <= 6 ? 1 : 2;
+}
+
+// -----------------------------------------------------------------------------
+// Struct: MyersPattern
+// Purpose: Per-byte match masks of the search term for the edit-distance
+//          kernel; bit i of peq[c] is set when term[i] == c.
+// -----------------------------------------------------------------------------
+struct MyersPattern {
+    uint64_t peq[256];
+    size_t length;
+};
+
+static void buildPattern(std::string_view term, bool reversed, MyersPattern &pattern) {
+    std::fill(pattern.peq, pattern.peq + 256, 0);
+    for (size_t i = 0; i < term.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(reversed ? term[term.size() - 1 - i] : term[i]);
+        pattern.peq[c] |= 1ULL << i;
+    }
+    pattern.length = term.size();
+}
+
+// -----------------------------------------------------------------------------
+// Helper: myersStep
+// Purpose: Advances the Myers column state by one text byte and returns the
+//          change (-1, 0 or +1) in the distance for the whole pattern.
+// -----------------------------------------------------------------------------
+static inline int myersStep(const MyersPattern &pattern, uint64_t high, unsigned char c, uint64_t &pv, uint64_t &mv) {
+    uint64_t eq = pattern.peq[c];
+    uint64_t xv = eq | mv;
+    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    int delta = (ph & high) ? 1 : ((mh & high) ? -1 : 0);
+    // No carry into bit 0: a match may start anywhere in the text.
+    ph <<= 1;
+    mh <<= 1;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return delta;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: myersSearch
+// Purpose: Smallest edit distance between the pattern and any substring of
+//          'text' (Myers, 1999), processing all pattern positions of a text
+//          byte in a handful of 64-bit operations. 'bestEnd' receives the end
+//          of the first substring reaching that distance.
+// -----------------------------------------------------------------------------
+static int myersSearch(const MyersPattern &pattern, std::string_view text, size_t &bestEnd) {
+    const uint64_t high = 1ULL << (pattern.length - 1);
+    uint64_t pv = ~0ULL, mv = 0;
+    int score = static_cast<int>(pattern.length);
+    int best = score;
+    bestEnd = 0;
+    for (size_t j = 0; j < text.size(); j++) {
+        score += myersStep(pattern, high, static_cast<unsigned char>(text[j]), pv, mv);
+        if (score < best) {
+            best = score;
+            bestEnd = j + 1;
+            if (best == 0)
+                break;
+        }
+    }
+    return best;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: myersMatchStart
+// Purpose: Runs the reversed pattern backwards from 'end' and returns the
+//          earliest start of a substring within 'distance' edits that ends no
+//          later than 'end',
+//          so a typo near the front still counts as a match at the word start.
+// -----------------------------------------------------------------------------
+static size_t myersMatchStart(const MyersPattern &reversed, std::string_view text, size_t end, int distance) {
+    const uint64_t high = 1ULL << (reversed.length - 1);
+    uint64_t pv = ~0ULL, mv = 0;
+    int score = static_cast<int>(reversed.length);
+    size_t start = end;
+    for (size_t j = end; j > 0; j--) {
+        score += myersStep(reversed, high, static_cast<unsigned char>(text[j - 1]), pv, mv);
+        if (score <= distance)
+            start = j - 1;
+    }
+    return start;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: byteSetOf
+// Purpose: One bit per letter and digit in 'text', with every other byte
+//          sharing the remaining 28 bits. A term byte missing from a name
+//          costs at least one edit, so a name missing more of the term's
+//          bits than the edit budget cannot match.
+// -----------------------------------------------------------------------------
+static uint64_t byteSetOf(std::string_view text) {
+    uint64_t set = 0;
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        unsigned bit = (byte >= 'a' && byte <= 'z') ? byte - 'a'
+                     : (byte >= '0' && byte <= '9') ? 26 + byte - '0'
+                     : 36 + byte % 28;
+        set |= 1ULL << bit;
+    }
+    return set;
+}
+
+// -----------------------------------------------------------------------------
+// Helpers: packMatch / matchIndex / matchPosition / matchDistance
+// Purpose: A match in one 32-bit word: the template index in the low 28
+//          bits, then where the match starts (0 name start, 1 word start,
+//          2 elsewhere), then the edit distance.
+// -----------------------------------------------------------------------------
+static const uint32_t INDEX_MASK = (1u << 28) - 1;
+
+static uint32_t packMatch(uint32_t index, uint32_t position, int distance) {
+    return index | (position << 28) | (static_cast<uint32_t>(distance) << 30);
+}
+
+static uint32_t matchIndex(uint32_t match) { return match & INDEX_MASK; }
+static uint32_t matchPosition(uint32_t match) { return (match >> 28) & 3; }
+static uint32_t matchDistance(uint32_t match) { return match >> 30; }
+
+// -----------------------------------------------------------------------------
+// Helper: isWordByte
+// Purpose: Letters and digits of folded text; anything else ends a word.
+// -----------------------------------------------------------------------------
+static inline bool isWordByte(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+}
+
+// -----------------------------------------------------------------------------
+// Helper: positionOf
+// Purpose: Position class of a match starting at 'start' in 'name'.
+// -----------------------------------------------------------------------------
+static uint32_t positionOf(std::string_view name, size_t start) {
+    if (start == 0)
+        return 0;
+    if (start <= name.size() && !isWordByte(name[start - 1]))
+        return 1;
+    return 2;
+}
+
+// -----------------------------------------------------------------------------
+// Helpers: lengthMask / equalMask
+// Purpose: Row bits of a name: every end position 0..length, and the end
+//          positions j where name[j - 1] == c.
+// -----------------------------------------------------------------------------
+static const size_t MAX_ROW_LENGTH = 63;
+
+static uint64_t lengthMask(size_t length) {
+    return (2ULL << length) - 1;  // Wraps to all ones for 63
+}
+
+#ifdef TEMPLATE_INDEX_SSE2
+// Reads up to 15 bytes past the name; rebuild pads foldedData for the last.
+static uint64_t equalMask(std::string_view name, char c) {
+    const __m128i wanted = _mm_set1_epi8(c);
+    uint64_t mask = 0;
+    for (size_t j = 0; j < name.size(); j += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(name.data() + j));
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, wanted)))) << j;
+    }
+    return (mask << 1) & lengthMask(name.size());
+}
+#else
+static uint64_t equalMask(std::string_view name, char c) {
+    uint64_t mask = 0;
+    for (size_t j = 0; j < name.size(); j++)
+        mask |= static_cast<uint64_t>(name[j] == c) << (j + 1);
+    return mask;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Helper: startRow
+// Purpose: Row of the empty term: no edits at the name start, at every word
+//          start, and at every position.
+// -----------------------------------------------------------------------------
+static void startRow(std::string_view name, uint64_t (&rows)[3][3]) {
+    uint64_t words = 1;
+    for (size_t j = 1; j <= name.size(); j++) {
+        if (!isWordByte(name[j - 1]))
+            words |= 1ULL << j;
+    }
+    const uint64_t starts[3] = { 1, words, lengthMask(name.size()) };
+    for (size_t anchor = 0; anchor < 3; anchor++) {
+        for (size_t edits = 0; edits < 3; edits++)
+            rows[anchor][edits] = starts[anchor];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Helper: stepRow
+// Purpose: Extends the term by one byte, given the name positions holding it
+//          ('equal'). An end position is within d edits if the previous one
+//          was and the byte matches, or the previous one was within d - 1
+//          (substitution), or this one was (the byte is dropped), or the
+//          previous one is now (a name byte is skipped) - the bitap
+//          recurrence of Wu and Manber with the roles of text and pattern
+//          swapped, so the term can grow.
+// -----------------------------------------------------------------------------
+static inline void stepRow(uint64_t (&row)[3], uint64_t equal, uint64_t all) {
+    uint64_t none = (row[0] << 1) & equal;
+    uint64_t one = ((row[1] << 1) & equal) | (row[0] << 1) | row[0] | (none << 1);
+    uint64_t two = ((row[2] << 1) & equal) | (row[1] << 1) | row[1] | (one << 1);
+    row[0] = none;
+    row[1] = one & all;
+    row[2] = two & all;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: rowMatch
+// Purpose: Packs the match a row describes, if it is within 'maxEdits': the
+//          fewest edits, and the best position class reaching them.
+// -----------------------------------------------------------------------------
+static bool rowMatch(const uint64_t (&rows)[3][3], uint32_t index, int maxEdits, uint32_t &match) {
+    for (int edits = 0; edits <= maxEdits; edits++) {
+        if (rows[2][edits] == 0)
+            continue;
+        uint32_t position = rows[0][edits] ? 0 : (rows[1][edits] ? 1 : 2);
+        match = packMatch(index, position, edits);
+        return true;
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// Constructor: TemplateIndex
+// Purpose: Start empty; the first search builds the index.
+// -----------------------------------------------------------------------------
+TemplateIndex::TemplateIndex() : indexedRevision(0), built(false), usedRevision(0) {
+}
+
+// -----------------------------------------------------------------------------
+// Method: rebuild
+// Purpose: Folds every name once and appends it to the posting list of each
+//          n-gram the folded name contains, with the best position class of
+//          its occurrences. Names are visited in order, so each list comes
+//          out sorted and holds a name at most once.
+// -----------------------------------------------------------------------------
+void TemplateIndex::rebuild(const TemplateStore &store) {
+    const std::vector<Food> &templates = store.all();
+    postings.clear();
+    foldedData.clear();
+    nameOffsets.clear();
+    allMatches.resize(templates.size());
+    byteSets.resize(templates.size());
+    for (uint32_t i = 0; i < static_cast<uint32_t>(templates.size()); i++) {
+        allMatches[i] = packMatch(i, 0, 0);
+        size_t start = foldedData.size();
+        nameOffsets.push_back(static_cast<uint32_t>(start));
+        foldText(templates[i].name(), foldedData);
+        std::string_view name(foldedData.data() + start, foldedData.size() - start);
+        byteSets[i] = byteSetOf(name);
+        for (size_t pos = 0; pos < name.size(); pos++) {
+            for (size_t length = 1; length <= 3 && pos + length <= name.size(); length++) {
+                std::vector<uint32_t> &list = postings[gramKey(name.data() + pos, length)];
+                uint32_t position = positionOf(name, pos);
+                if (list.empty() || matchIndex(list.back()) != i)
+                    list.push_back(packMatch(i, position, 0));
+                else if (position < matchPosition(list.back()))
+                    list.back() = packMatch(i, position, 0);
+            }
+        }
+    }
+    nameOffsets.push_back(static_cast<uint32_t>(foldedData.size()));
+    foldedData.append(16, '\0');  // Lets equalMask read whole 16-byte blocks
+    indexedRevision = store.revision();
+    built = true;
+    usedTemplates.clear();
+    for (uint32_t i = 0; i < static_cast<uint32_t>(templates.size()); i++) {
+        if (store.useCount(i) > 0)
+            usedTemplates.push_back(i);
+    }
+    usedRevision = store.useRevision();
+    levelTerm.clear();
+    levels.assign(1, Level());
+    levels[0].shared = &allMatches;
+}
+
+// -----------------------------------------------------------------------------
+// Method: nameAt
+// Purpose: View of one folded name in foldedData.
+// -----------------------------------------------------------------------------
+std::string_view TemplateIndex::nameAt(uint32_t index) const {
+    return std::string_view(foldedData).substr(nameOffsets[index], nameOffsets[index + 1] - nameOffsets[index]);
+}
+
+// -----------------------------------------------------------------------------
+// Method: addLevel
+// Purpose: Exact matches of levelTerm. A term of up to three bytes is an
+//          n-gram, so its posting list is the answer. A longer one checks
+//          the smaller of the previous level's matches and the posting list
+//          of the term's rarest trigram, both of which hold every match.
+// -----------------------------------------------------------------------------
+void TemplateIndex::addLevel() {
+    const Level &previous = levels.back();
+    Level level;
+    level.maxEdits = maxEditsFor(levelTerm.size());
+    if (levelTerm.size() <= 3) {
+        auto it = postings.find(gramKey(levelTerm.data(), levelTerm.size()));
+        level.shared = it != postings.end() ? &it->second : &noMatches;
+        levels.push_back(std::move(level));
+        return;
+    }
+    const std::vector<uint32_t> *candidates = &previous.exactMatches();
+    for (size_t pos = 0; pos + 3 <= levelTerm.size() && !candidates->empty(); pos++) {
+        auto it = postings.find(gramKey(levelTerm.data() + pos, 3));
+        if (it == postings.end())
+            candidates = &noMatches;
+        else if (it->second.size() < candidates->size())
+            candidates = &it->second;
+    }
+    for (uint32_t match : *candidates) {
+        uint32_t index = matchIndex(match);
+        std::string_view name = nameAt(index);
+        size_t pos = name.find(levelTerm);
+        if (pos == std::string_view::npos)
+            continue;
+        // A later occurrence may start a word.
+        uint32_t position = positionOf(name, pos);
+        while (position > 1 && (pos = name.find(levelTerm, pos + 1)) != std::string_view::npos)
+            position = std::min(position, positionOf(name, pos));
+        level.exact.push_back(packMatch(index, position, 0));
+    }
+    levels.push_back(std::move(level));
+}
+
+// -----------------------------------------------------------------------------
+// Method: pigeonholeSources
+// Purpose: A match with at most maxEdits edits leaves one of any maxEdits + 1
+//          pieces of the term intact, so it contains every n-gram of that
+//          piece. Picks the split, and the n-gram of each piece, with the
+//          shortest posting lists.
+// -----------------------------------------------------------------------------
+void TemplateIndex::pigeonholeSources(const std::string &term, int maxEdits, std::vector<Source> &out) const {
+    typedef const std::vector<uint32_t> *List;
+    const size_t length = term.size();
+    // ending[e][n - 1]: posting list of the n-gram ending at term[e - 1].
+    std::vector<std::array<List, 3>> ending(length + 1);
+    for (size_t e = 1; e <= length; e++) {
+        for (size_t gram = 1; gram <= 3 && gram <= e; gram++) {
+            auto it = postings.find(gramKey(term.data() + e - gram, gram));
+            ending[e][gram - 1] = it != postings.end() ? &it->second : &noMatches;
+        }
+    }
+    // rarest[b][e]: shortest posting list of an n-gram inside term[b, e).
+    std::vector<std::vector<List>> rarest(length + 1, std::vector<List>(length + 1));
+    for (size_t b = 0; b < length; b++) {
+        List best = nullptr;
+        for (size_t e = b + 1; e <= length; e++) {
+            for (size_t gram = 1; gram <= 3 && gram <= e - b; gram++) {
+                if (!best || ending[e][gram - 1]->size() < best->size())
+                    best = ending[e][gram - 1];
+            }
+            rarest[b][e] = best;
+        }
+    }
+    std::vector<List> bestLists;
+    size_t bestSize = SIZE_MAX;
+    if (maxEdits == 1) {
+        for (size_t split = 1; split < length; split++) {
+            size_t size = rarest[0][split]->size() + rarest[split][length]->size();
+            if (size < bestSize) {
+                bestSize = size;
+                bestLists = { rarest[0][split], rarest[split][length] };
+            }
+        }
+    } else {
+        for (size_t first = 1; first + 1 < length; first++) {
+            for (size_t second = first + 1; second < length; second++) {
+                size_t size = rarest[0][first]->size() + rarest[first][second]->size() + rarest[second][length]->size();
+                if (size < bestSize) {
+                    bestSize = size;
+                    bestLists = { rarest[0][first], rarest[first][second], rarest[second][length] };
+                }
+            }
+        }
+    }
+    out.clear();
+    for (List list : bestLists)
+        out.push_back(Source{ list, 0 });
+}
+
+// -----------------------------------------------------------------------------
+// Helper: skipSources
+// Purpose: Moves every source past the templates below 'end' and returns how
+//          many entries remain.
+// -----------------------------------------------------------------------------
+template <typename Sources>
+static size_t skipSources(Sources &sources, uint32_t end) {
+    size_t remaining = 0;
+    for (auto &source : sources) {
+        const std::vector<uint32_t> &list = *source.list;
+        source.next = static_cast<size_t>(
+            std::lower_bound(list.begin() + static_cast<std::ptrdiff_t>(source.next), list.end(), end,
+                             [](uint32_t match, uint32_t index) { return matchIndex(match) < index; }) -
+            list.begin());
+        remaining += list.size() - source.next;
+    }
+    return remaining;
+}
+
+// -----------------------------------------------------------------------------
+// Method: scoreName
+// Purpose: A fresh row is first run for matches anywhere only, since most
+//          candidates fail; the rows anchored at name and word starts are
+//          added for those that match.
+// -----------------------------------------------------------------------------
+bool TemplateIndex::scoreName(uint32_t index, const std::string &term, size_t from, int maxEdits, RowState &state,
+                              uint32_t &match) const {
+    std::string_view name = nameAt(index);
+    if (from == 0) {
+        state.index = index;
+        state.longName = name.size() > MAX_ROW_LENGTH;
+    }
+    if (state.longName) {
+        if (name.size() + static_cast<size_t>(maxEdits) < term.size())
+            return false;
+        MyersPattern pattern, reversed;
+        buildPattern(term, false, pattern);
+        buildPattern(term, true, reversed);
+        size_t end;
+        int distance = myersSearch(pattern, name, end);
+        if (distance > maxEdits)
+            return false;
+        size_t start = myersMatchStart(reversed, name, end, distance);
+        match = packMatch(index, positionOf(name, start), distance);
+        return true;
+    }
+
+    const uint64_t all = lengthMask(name.size());
+    if (from == 0) {
+        uint64_t equal[MAX_PATTERN_LENGTH];
+        uint64_t anywhere[3] = { all, all, all };
+        for (size_t i = 0; i < term.size(); i++) {
+            equal[i] = equalMask(name, term[i]);
+            stepRow(anywhere, equal[i], all);
+        }
+        if (anywhere[maxEdits] == 0)
+            return false;
+        startRow(name, state.rows);
+        for (size_t i = 0; i < term.size(); i++) {
+            stepRow(state.rows[0], equal[i], all);
+            stepRow(state.rows[1], equal[i], all);
+        }
+        std::copy(anywhere, anywhere + 3, state.rows[2]);
+    } else {
+        for (size_t i = from; i < term.size(); i++) {
+            uint64_t equal = equalMask(name, term[i]);
+            for (uint64_t (&row)[3] : state.rows)
+                stepRow(row, equal, all);
+        }
+    }
+    return rowMatch(state.rows, index, maxEdits, match);
+}
+
+// -----------------------------------------------------------------------------
+// Method: findFuzzy
+// Purpose: Matches of an extended term with the same edit budget are a subset
+//          of the shorter term's: trimming the extra bytes off a match leaves
+//          a match of the shorter term. So the nearest shorter prefix with
+//          the same budget that was scored hands over its matches, whose
+//          rows only need the extra bytes, and its candidates for the blocks
+//          it did not score unless the term's own pigeonhole lists are
+//          shorter. Used templates are few and always scored in full.
+// -----------------------------------------------------------------------------
+void TemplateIndex::findFuzzy(const TemplateStore &store, size_t depth, size_t wanted) {
+    Level &level = levels[depth];
+    const std::string term = levelTerm.substr(0, depth);
+    if (!level.fuzzyStarted) {
+        level.fuzzyStarted = true;
+        pigeonholeSources(term, level.maxEdits, level.sources);
+        for (size_t shorter = depth; shorter-- > 0 && levels[shorter].maxEdits == level.maxEdits;) {
+            const Level &previous = levels[shorter];
+            if (!previous.fuzzyStarted)
+                continue;
+            for (const RowState &previousState : previous.states) {
+                RowState state = previousState;
+                uint32_t match;
+                if (scoreName(state.index, term, shorter, level.maxEdits, state, match)) {
+                    level.fuzzy.push_back(match);
+                    level.states.push_back(state);
+                }
+            }
+            level.scoredEnd = previous.scoredEnd;
+            std::vector<Source> inherited = previous.sources;
+            if (skipSources(inherited, level.scoredEnd) < skipSources(level.sources, level.scoredEnd))
+                level.sources.swap(inherited);
+            break;
+        }
+    }
+
+    if (level.usedRevision != store.useRevision()) {
+        if (usedRevision != store.useRevision()) {
+            usedTemplates.clear();
+            for (uint32_t index = 0; index + 1 < static_cast<uint32_t>(nameOffsets.size()); index++) {
+                if (store.useCount(index) > 0)
+                    usedTemplates.push_back(index);
+            }
+            usedRevision = store.useRevision();
+        }
+        level.usedFuzzy.clear();
+        for (uint32_t index : usedTemplates) {
+            RowState state;
+            uint32_t match;
+            if (scoreName(index, term, 0, level.maxEdits, state, match) && matchDistance(match) > 0)
+                level.usedFuzzy.push_back(match);
+        }
+        level.unusedFuzzy = 0;
+        for (uint32_t match : level.fuzzy) {
+            if (matchDistance(match) > 0 && store.useCount(matchIndex(match)) == 0)
+                level.unusedFuzzy++;
+        }
+        level.usedRevision = store.useRevision();
+        level.ranked = false;
+    }
+
+    while (level.scoredEnd + 1 < nameOffsets.size() && level.usedFuzzy.size() + level.unusedFuzzy < wanted)
+        scoreBlock(store, depth);
+}
+
+// -----------------------------------------------------------------------------
+// Method: scoreBlock
+// Purpose: Merges the sources' candidates in the next block and scores them
+//          from the first byte, skipping names that lack too many of the
+//          term's bytes.
+// -----------------------------------------------------------------------------
+void TemplateIndex::scoreBlock(const TemplateStore &store, size_t depth) {
+    Level &level = levels[depth];
+    const std::string term = levelTerm.substr(0, depth);
+    const uint32_t templateCount = static_cast<uint32_t>(nameOffsets.size() - 1);
+    const uint32_t end = level.scoredEnd + std::min(FUZZY_BLOCK, templateCount - level.scoredEnd);
+    skipSources(level.sources, level.scoredEnd);
+    std::vector<uint32_t> candidates;
+    for (Source &source : level.sources) {
+        const std::vector<uint32_t> &list = *source.list;
+        size_t middle = candidates.size();
+        for (; source.next < list.size() && matchIndex(list[source.next]) < end; source.next++)
+            candidates.push_back(matchIndex(list[source.next]));
+        std::inplace_merge(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(middle), candidates.end());
+    }
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    level.fuzzy.reserve(level.fuzzy.size() + candidates.size());
+    level.states.reserve(level.states.size() + candidates.size());
+    const uint64_t termBytes = byteSetOf(term);
+    for (uint32_t index : candidates) {
+        uint64_t missing = termBytes & ~byteSets[index];
+        for (int edits = 0; edits < level.maxEdits && missing; edits++)
+            missing &= missing - 1;
+        if (missing)
+            continue;
+        RowState state;
+        uint32_t match;
+        if (!scoreName(index, term, 0, level.maxEdits, state, match))
+            continue;
+        level.fuzzy.push_back(match);
+        level.states.push_back(state);
+        if (matchDistance(match) > 0 && store.useCount(index) == 0)
+            level.unusedFuzzy++;
+    }
+    level.scoredEnd = end;
+    level.ranked = false;
+}
+
+// -----------------------------------------------------------------------------
+// Method: rank
+// Purpose: Exact matches first, sorted in one pass into position groups.
+//          They are in index order, so within a group the templates never
+//          used are already in display order and only the first 'wanted' of
+//          them are kept; the used ones, usually few, are sorted by count.
+//          Then the used templates' matches with edits, then the others'
+//          block by block, grouped the same way by distance and position.
+// -----------------------------------------------------------------------------
+void TemplateIndex::rank(const TemplateStore &store, Level &level, size_t wanted) {
+    auto byUses = [&store](uint32_t a, uint32_t b) {
+        uint32_t usesA = store.useCount(a), usesB = store.useCount(b);
+        return usesA != usesB ? usesA > usesB : a < b;
+    };
+    bool capped = false;
+    level.results.clear();
+    {
+        std::vector<uint32_t> used[3], unused[3];
+        for (uint32_t match : level.exactMatches()) {
+            uint32_t index = matchIndex(match);
+            if (store.useCount(index) > 0)
+                used[matchPosition(match)].push_back(index);
+            else if (unused[matchPosition(match)].size() < wanted)
+                unused[matchPosition(match)].push_back(index);
+            else
+                capped = true;
+        }
+        for (size_t position = 0; position < 3; position++) {
+            std::sort(used[position].begin(), used[position].end(), byUses);
+            level.results.insert(level.results.end(), used[position].begin(), used[position].end());
+            level.results.insert(level.results.end(), unused[position].begin(), unused[position].end());
+        }
+    }
+
+    if (level.fuzzyStarted) {
+        std::vector<uint32_t> used = level.usedFuzzy;
+        std::sort(used.begin(), used.end(), [&byUses](uint32_t a, uint32_t b) {
+            uint32_t groupA = a >> 28, groupB = b >> 28;  // Distance, then position
+            return groupA != groupB ? groupA < groupB : byUses(matchIndex(a), matchIndex(b));
+        });
+        for (uint32_t match : used)
+            level.results.push_back(matchIndex(match));
+
+        const size_t GROUPS = 6;  // Distances 1 and 2 by three positions
+        std::vector<uint32_t> groups[GROUPS];
+        size_t next = 0;
+        while (next < level.fuzzy.size() && level.results.size() < wanted) {
+            const uint32_t block = matchIndex(level.fuzzy[next]) / FUZZY_BLOCK;
+            const size_t room = wanted - level.results.size();
+            for (; next < level.fuzzy.size() && matchIndex(level.fuzzy[next]) / FUZZY_BLOCK == block; next++) {
+                uint32_t match = level.fuzzy[next];
+                if (matchDistance(match) == 0 || store.useCount(matchIndex(match)) > 0)
+                    continue;
+                std::vector<uint32_t> &group = groups[(matchDistance(match) - 1) * 3 + matchPosition(match)];
+                if (group.size() < room)
+                    group.push_back(matchIndex(match));
+                else
+                    capped = true;
+            }
+            for (std::vector<uint32_t> &group : groups) {
+                level.results.insert(level.results.end(), group.begin(), group.end());
+                group.clear();
+            }
+        }
+        capped = capped || next < level.fuzzy.size();
+    }
+    level.complete = !capped && (level.maxEdits == 0 || (level.fuzzyStarted && level.scoredEnd + 1 >= nameOffsets.size()));
+    level.ranked = true;
+    level.rankedUseRevision = store.useRevision();
+}
+
+// -----------------------------------------------------------------------------
+// Method: search
+// Purpose: Keeps the levels of the common prefix with the previous term and
+//          adds one level per new byte, then ranks the last level, scoring
+//          matches with edits only if the exact ones fall short of 'wanted'.
+// -----------------------------------------------------------------------------
+const std::vector<uint32_t> &TemplateIndex::search(const TemplateStore &store, const std::string &term, size_t wanted) {
+    if (!built || indexedRevision != store.revision())
+        rebuild(store);
+    std::string folded;
+    foldText(term, folded);
+    if (folded.size() > MAX_PATTERN_LENGTH)
+        folded.resize(MAX_PATTERN_LENGTH);
+
+    size_t common = 0;
+    while (common < levelTerm.size() && common < folded.size() && levelTerm[common] == folded[common])
+        common++;
+    levels.resize(common + 1);
+    levelTerm.resize(common);
+    while (levelTerm.size() < folded.size()) {
+        levelTerm.push_back(folded[levelTerm.size()]);
+        addLevel();
+    }
+
+    Level &level = levels.back();
+    const size_t exactCount = level.exactMatches().size();
+    if (level.maxEdits > 0 && exactCount < wanted)
+        findFuzzy(store, levels.size() - 1, wanted - exactCount);
+    if (!level.ranked || level.rankedUseRevision != store.useRevision() ||
+        (!level.complete && level.results.size() < wanted))
+        rank(store, level, wanted);
+    return level.results;
+}
+
+// -----------------------------------------------------------------------------
+// Methods: matchCount / complete
+// Purpose: State of the last search's level.
+// -----------------------------------------------------------------------------
+size_t TemplateIndex::matchCount() const {
+    if (levels.empty())
+        return 0;
+    const Level &level = levels.back();
+    return level.exactMatches().size() + (level.fuzzyStarted ? level.usedFuzzy.size() + level.unusedFuzzy : 0);
+}
+
+bool TemplateIndex::complete() const {
+    return levels.empty() || levels.back().complete;
+}
@@ -0,0 +1,141 @@
+#ifndef TEMPLATE_INDEX_H
+#define TEMPLATE_INDEX_H
+
+// -----------------------------------------------------------------------------
+// File: template_index.h
+// Purpose: Declare TemplateIndex, the ranked fuzzy search used by the template
+//          popup so a keystroke never rescans the whole template library.
+// -----------------------------------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "template_store.h"
+
+// -----------------------------------------------------------------------------
+// Class: TemplateIndex
+// Purpose: Finds templates whose name contains the search term, ignoring case
+//          and accents and tolerating typos, best matches first.
+//          - Names and terms are folded to lower-case ASCII before comparing.
+//          - Terms of up to three bytes must match exactly and are answered
+//            from n-gram posting lists over the folded names.
+//          - Longer terms allow one edit, and two from seven bytes on. Names
+//            are scored with a bit-parallel edit-distance kernel that keeps
+//            one row per name, so a longer term only adds a row.
+//          - Every prefix of the term keeps its matches, so a keystroke only
+//            narrows the previous prefix's matches and a backspace reuses
+//            them. Matches with edits rank after every exact match, so they
+//            are only scored once the exact ones do not fill the requested
+//            page, one block of FUZZY_BLOCK templates at a time until it is
+//            full, and narrowed from a shorter prefix with the same budget.
+//          Results are indices into TemplateStore::all(). Exact matches come
+//          first, ordered by where the match starts (name start, word start,
+//          elsewhere), then usage count, then name. Matches with edits follow:
+//          those of used templates by distance, position and usage count,
+//          then the rest block by block of names, by distance and position
+//          within a block. A library of one block is ranked as a whole.
+// -----------------------------------------------------------------------------
+class TemplateIndex {
+public:
+    // Templates whose matches with edits are scored together.
+    static constexpr uint32_t FUZZY_BLOCK = 8192;
+
+    TemplateIndex();
+
+    // Returns the ranked matches for 'term': at least the first 'wanted' of
+    // them, or all if there are fewer. The index is rebuilt first if the
+    // store changed since the last call; new usage counts only re-rank.
+    const std::vector<uint32_t> &search(const TemplateStore &store, const std::string &term,
+                                        size_t wanted = SIZE_MAX);
+
+    // Matches of the last search found so far, and whether the list it
+    // returned holds all of them.
+    size_t matchCount() const;
+    bool complete() const;
+
+private:
+    // -------------------------------------------------------------------------
+    // Structure: RowState
+    // Purpose: Last row of the edit-distance table of one name against the
+    //          prefix, one bit per end position in the name: rows[a][d] has
+    //          bit j set when name[0, j) ends a substring within d edits that
+    //          starts at the name start (a = 0), at a word start (a = 1) or
+    //          anywhere (a = 2). Names too long for a row are scored whole.
+    // -------------------------------------------------------------------------
+    struct RowState {
+        uint32_t index;
+        uint32_t longName;     // Non-zero when 'rows' is unused
+        uint64_t rows[3][3];
+    };
+
+    // Unscored part of a posting list the candidates come from.
+    struct Source {
+        const std::vector<uint32_t> *list;
+        size_t next;
+    };
+
+    // -------------------------------------------------------------------------
+    // Structure: Level
+    // Purpose: Matches of one prefix of the term, packed with their match
+    //          position and distance (see template_index.cpp), in index order.
+    // -------------------------------------------------------------------------
+    struct Level {
+        int maxEdits = 0;                            // Edit budget of the prefix
+        const std::vector<uint32_t> *shared = nullptr;  // Exact matches when they are a posting list
+        std::vector<uint32_t> exact;                 // Exact matches otherwise
+        bool fuzzyStarted = false;                   // Matches with edits are being scored
+        uint32_t scoredEnd = 0;                      // Every template below this index is scored
+        std::vector<uint32_t> fuzzy;                 // Scored matches within maxEdits
+        std::vector<RowState> states;                // Row of each match in 'fuzzy'
+        std::vector<Source> sources;                 // Candidates from scoredEnd on
+        size_t unusedFuzzy = 0;                      // Matches in 'fuzzy' with edits, never used
+        std::vector<uint32_t> usedFuzzy;             // Matches with edits of used templates, all scored
+        uint64_t usedRevision = UINT64_MAX;          // Usage revision 'usedFuzzy' was scored for
+        std::vector<uint32_t> results;               // Ranked matches handed out by search
+        bool ranked = false;                         // 'results' is current for rankedUseRevision
+        bool complete = false;                       // 'results' holds every match
+        uint64_t rankedUseRevision = 0;              // Store usage revision 'results' was ranked with
+
+        const std::vector<uint32_t> &exactMatches() const { return shared ? *shared : exact; }
+    };
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;  // Folded n-gram key -> packed matches
+    std::vector<uint32_t> allMatches;  // Every template, the matches of the empty term
+    std::vector<uint32_t> noMatches;   // Posting list of an n-gram no name contains
+    std::string foldedData;            // All folded names back to back, so scans read contiguous memory
+    std::vector<uint32_t> nameOffsets; // Start of each name in foldedData, plus the end offset
+    std::vector<uint64_t> byteSets;    // Bytes each folded name contains (see byteSetOf)
+    uint64_t indexedRevision;          // Store revision the index describes
+    bool built;                        // False until the first build
+    std::vector<uint32_t> usedTemplates;  // Templates with a usage count, as of usedRevision
+    uint64_t usedRevision;             // Usage revision 'usedTemplates' was collected for
+
+    std::string levelTerm;             // Folded term whose prefixes 'levels' holds
+    std::vector<Level> levels;         // levels[n]: matches of the first n bytes of levelTerm
+
+    // Rebuilds the folded names and posting lists from the store.
+    void rebuild(const TemplateStore &store);
+    // Folded name of template 'index'.
+    std::string_view nameAt(uint32_t index) const;
+    // Appends the level for levelTerm, narrowed from the one before.
+    void addLevel();
+    // Scores matches with edits for levels[depth] until 'wanted' of them
+    // from templates never used are found, or every candidate is scored.
+    void findFuzzy(const TemplateStore &store, size_t depth, size_t wanted);
+    // Scores template 'index' against 'term', carrying on from a state
+    // holding its first 'from' bytes (0 starts afresh). False if it does
+    // not match within 'maxEdits'.
+    bool scoreName(uint32_t index, const std::string &term, size_t from, int maxEdits, RowState &state,
+                   uint32_t &match) const;
+    // Scores the next block of candidates for levels[depth].
+    void scoreBlock(const TemplateStore &store, size_t depth);
+    // Posting lists a term within 'maxEdits' edits must be in one of: those
+    // of an intact piece of the term (pigeonhole).
+    void pigeonholeSources(const std::string &term, int maxEdits, std::vector<Source> &out) const;
+    // Fills level.results with at least 'wanted' ranked matches.
+    void rank(const TemplateStore &store, Level &level, size_t wanted);
+};
+
+#endif // TEMPLATE_INDEX_H
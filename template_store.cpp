@@ -0,0 +1,245 @@
+#include "template_store.h"
+#include "mapped_file.h"  // The library is parsed in place, like the data file
+#include "durable_file.h"  // Atomic rewrite on compaction
+#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <string_view>
+
+// -----------------------------------------------------------------------------
+// Helper: nameLess
+// Purpose: Orders templates by name text; used for sorting and sorted
+//          insertion.
+// -----------------------------------------------------------------------------
+static bool nameLess(const Food &a, const Food &b) {
+    return a.name() < b.name();
+}
+
+// -----------------------------------------------------------------------------
+// Constructor: TemplateStore
+// Purpose: Remember the file location; nothing is read until ensureLoaded().
+// -----------------------------------------------------------------------------
+TemplateStore::TemplateStore(const std::string &p) : path(p), loaded(false), deadRecords(0), changeCount(0), useChangeCount(0) {
+}
+
+// -----------------------------------------------------------------------------
+// Method: ensureLoaded
+// Purpose: Replays the library log once. Every add is collected with its line
+//          number; a later DEL for the same name cancels it. The survivors are
+//          sorted a single time, so loading 100k+ templates stays O(n log n).
+// -----------------------------------------------------------------------------
+void TemplateStore::ensureLoaded() {
+    if (loaded)
+        return;
+    loaded = true;
+    MappedFile file;
+    if (!file.open(path))
+        return;
+
+    std::vector<std::pair<std::string_view, size_t>> added;  // Raw TPL fields and line number
+    std::vector<std::pair<std::string_view, size_t>> used;   // Raw USE fields and line number
+    std::unordered_map<std::string_view, size_t> lastDelete;  // Name -> line of last DEL
+    size_t lineNumber = 0;
+    std::string_view remaining = file.view();
+    while (!remaining.empty()) {
+        size_t lineEnd = remaining.find('\n');
+        std::string_view line = remaining.substr(0, lineEnd);
+        remaining.remove_prefix(lineEnd == std::string_view::npos ? remaining.size() : lineEnd + 1);
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        lineNumber++;
+        if (line.compare(0, 5, "TPL: ") == 0)
+            added.emplace_back(line.substr(5), lineNumber);
+        else if (line.compare(0, 5, "DEL: ") == 0)
+            lastDelete[line.substr(5)] = lineNumber;
+        else if (line.compare(0, 5, "USE: ") == 0)
+            used.emplace_back(line.substr(5), lineNumber);
+    }
+
+    // Usage recorded before a name's last delete belongs to a removed template.
+    std::unordered_map<std::string_view, uint32_t> useTotals;
+    for (const auto &entry : used) {
+        std::string_view fields = entry.first;
+        size_t separator = fields.find('|');
+        if (separator == std::string_view::npos)
+            continue;
+        std::string_view name = fields.substr(0, separator);
+        auto del = lastDelete.find(name);
+        if (del != lastDelete.end() && del->second > entry.second)
+            continue;
+        int count = 0;
+        std::string_view countText = fields.substr(separator + 1);
+        parseIntField(countText, '|', count);
+        if (count > 0)
+            useTotals[name] += static_cast<uint32_t>(count);
+    }
+
+    templates.reserve(added.size());
+    for (const auto &entry : added) {
+        std::string_view name = entry.first.substr(0, entry.first.find('|'));
+        auto del = lastDelete.find(name);
+        if (del != lastDelete.end() && del->second > entry.second)
+            continue;
+        templates.emplace_back();
+        parseFoodFields(entry.first, templates.back());
+    }
+    std::stable_sort(templates.begin(), templates.end(), nameLess);
+    uses.assign(templates.size(), 0);
+    size_t usedNames = 0;
+    for (size_t i = 0; i < templates.size(); i++) {
+        auto total = useTotals.find(templates[i].name());
+        if (total == useTotals.end())
+            continue;
+        uses[i] = total->second;
+        if (i == 0 || templates[i - 1].nameId != templates[i].nameId)
+            usedNames++;
+    }
+    // A compacted file has one TPL line per template and one USE line per used name.
+    deadRecords = lineNumber - templates.size() - usedNames;
+    changeCount++;
+}
+
+// -----------------------------------------------------------------------------
+// Method: all
+// Purpose: Returns the live templates sorted by name.
+// -----------------------------------------------------------------------------
+const std::vector<Food> &TemplateStore::all() const {
+    return templates;
+}
+
+// -----------------------------------------------------------------------------
+// Method: add
+// Purpose: Inserts after any templates with an equal name and logs one line.
+// -----------------------------------------------------------------------------
+void TemplateStore::add(const Food &tpl) {
+    ensureLoaded();
+    auto pos = std::upper_bound(templates.begin(), templates.end(), tpl, nameLess);
+    // A template added under an existing name shares that name's usage count.
+    uint32_t count = (pos != templates.begin() && (pos - 1)->nameId == tpl.nameId) ? uses[pos - templates.begin() - 1] : 0;
+    uses.insert(uses.begin() + (pos - templates.begin()), count);
+    templates.insert(pos, tpl);
+    changeCount++;
+    appendLine("TPL: " + formatFood(tpl));
+}
+
+// -----------------------------------------------------------------------------
+// Helper: nameRun
+// Purpose: Bounds of the run of templates sharing the name of the one at
+//          'index'. Equal names have equal ids and sort together, so the run
+//          is found by comparing ids outward from 'index', not name text.
+// -----------------------------------------------------------------------------
+static void nameRun(const std::vector<Food> &templates, size_t index, size_t &first, size_t &last) {
+    uint32_t nameId = templates[index].nameId;
+    first = index;
+    while (first > 0 && templates[first - 1].nameId == nameId)
+        first--;
+    last = index + 1;
+    while (last < templates.size() && templates[last].nameId == nameId)
+        last++;
+}
+
+// -----------------------------------------------------------------------------
+// Method: remove
+// Purpose: Erases the contiguous run of templates with the name of the one at
+//          'index' and logs one line; compacts the file once it is mostly
+//          dead records.
+// -----------------------------------------------------------------------------
+void TemplateStore::remove(size_t index) {
+    ensureLoaded();
+    if (index >= templates.size())
+        return;
+    size_t first, last;
+    nameRun(templates, index, first, last);
+    std::string line = "DEL: " + std::string(templates[index].name());
+    deadRecords += last - first;
+    if (uses[first] > 0)
+        deadRecords++;  // The name's USE line is dead as well
+    uses.erase(uses.begin() + first, uses.begin() + last);
+    templates.erase(templates.begin() + first, templates.begin() + last);
+    changeCount++;
+    appendLine(line);
+    deadRecords++;
+    if (deadRecords > 64 && deadRecords > templates.size())
+        compact();
+}
+
+// -----------------------------------------------------------------------------
+// Method: recordUse
+// Purpose: Bumps the usage count of the name of the template at 'index' and
+//          logs one line. Every USE line after the first for a name is merged
+//          away by compaction.
+// -----------------------------------------------------------------------------
+void TemplateStore::recordUse(size_t index) {
+    ensureLoaded();
+    if (index >= templates.size())
+        return;
+    size_t first, last;
+    nameRun(templates, index, first, last);
+    if (uses[first] > 0)
+        deadRecords++;
+    for (size_t i = first; i < last; i++)
+        uses[i]++;
+    useChangeCount++;
+    appendLine("USE: " + std::string(templates[index].name()) + "|1");
+    if (deadRecords > 64 && deadRecords > templates.size())
+        compact();
+}
+
+// -----------------------------------------------------------------------------
+// Method: useCount
+// Purpose: Returns the usage count of the template at 'index' in all().
+// -----------------------------------------------------------------------------
+uint32_t TemplateStore::useCount(size_t index) const {
+    return uses[index];
+}
+
+// -----------------------------------------------------------------------------
+// Method: revision
+// Purpose: Returns a counter that changes whenever the template list does.
+// -----------------------------------------------------------------------------
+uint64_t TemplateStore::revision() const {
+    return changeCount;
+}
+
+// -----------------------------------------------------------------------------
+// Method: useRevision
+// Purpose: Returns a counter that changes whenever a usage count does.
+// -----------------------------------------------------------------------------
+uint64_t TemplateStore::useRevision() const {
+    return useChangeCount;
+}
+
+// -----------------------------------------------------------------------------
+// Method: appendLine
+// Purpose: Writes one record to the end of the library file.
+// -----------------------------------------------------------------------------
+void TemplateStore::appendLine(const std::string &line) {
+    if (!outFile.is_open()) {
+        outFile.open(path, std::ios::out | std::ios::app);
+        if (!outFile.is_open())
+            return;
+    }
+    outFile << line << '\n';
+    outFile.flush();
+}
+
+// -----------------------------------------------------------------------------
+// Method: compact
+// Purpose: Replaces the log with one TPL line per live template and one USE
+//          line per used name. The new log is renamed over the old one, so a
+//          crash mid-rewrite leaves the old log intact.
+// -----------------------------------------------------------------------------
+void TemplateStore::compact() {
+    if (outFile.is_open())
+        outFile.close();
+    std::ostringstream rewrite;
+    for (const auto &tpl : templates)
+        rewrite << "TPL: " << formatFood(tpl) << '\n';
+    for (size_t i = 0; i < templates.size(); i++) {
+        if (uses[i] > 0 && (i == 0 || templates[i - 1].nameId != templates[i].nameId))
+            rewrite << "USE: " << templates[i].name() << '|' << uses[i] << '\n';
+    }
+    std::string text = rewrite.str();
+    if (writeFileAtomically(path, text.data(), text.size(), true))
+        deadRecords = 0;
+}
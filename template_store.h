@@ -0,0 +1,73 @@
+#ifndef TEMPLATE_STORE_H
+#define TEMPLATE_STORE_H
+
+// -----------------------------------------------------------------------------
+// File: template_store.h
+// Purpose: Declare the TemplateStore class, the on-disk library of food
+//          templates offered by "Add from templates".
+// -----------------------------------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "food.h"
+
+// -----------------------------------------------------------------------------
+// Class: TemplateStore
+// Purpose: Keeps food templates sorted by name and persists them in their own
+//          file. The file is an append-only log:
+//            TPL: name|calories|carbs|protein|fat|grams   adds a template
+//            DEL: name                                    removes every template with that name
+//            USE: name|count                              adds to the name's usage count
+//          so creating, deleting or using a template writes one line. The log
+//          is rewritten only when dead entries outnumber live ones.
+// -----------------------------------------------------------------------------
+class TemplateStore {
+public:
+    explicit TemplateStore(const std::string &path);
+
+    // Reads the library the first time it is called; later calls do nothing.
+    void ensureLoaded();
+
+    // All templates, sorted by name.
+    const std::vector<Food> &all() const;
+
+    // Inserts a template at its sorted position and appends it to the file.
+    void add(const Food &tpl);
+
+    // Removes every template named like the one at 'index' in all() and
+    // appends a delete record.
+    void remove(size_t index);
+
+    // Counts one more use of every template named like the one at 'index'.
+    void recordUse(size_t index);
+
+    // How often the template at 'index' in all() has been used.
+    uint32_t useCount(size_t index) const;
+
+    // Incremented whenever all() changes, so indexes built over it can tell
+    // when they are stale. Usage counts do not move templates and leave it alone.
+    uint64_t revision() const;
+
+    // Incremented whenever a usage count changes, so rankings can be redone.
+    uint64_t useRevision() const;
+
+private:
+    std::string path;            // Location of the template library file
+    bool loaded;                 // True once the file has been read
+    std::vector<Food> templates; // Live templates, sorted by name
+    std::vector<uint32_t> uses;  // Usage count of each template, parallel to 'templates'
+    size_t deadRecords;          // Lines in the file that no longer describe a live template
+    uint64_t changeCount;        // Value returned by revision()
+    uint64_t useChangeCount;     // Value returned by useRevision()
+    std::ofstream outFile;       // Append stream, opened on first write
+
+    // Appends one line to the library file.
+    void appendLine(const std::string &line);
+    // Rewrites the file with only the live templates.
+    void compact();
+};
+
+#endif // TEMPLATE_STORE_H
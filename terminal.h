@@ -0,0 +1,57 @@
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+// -----------------------------------------------------------------------------
+// File: terminal.h
+// Purpose: Declare the Terminal interface, the only place the application
+//          touches the console, with a Win32 and a POSIX/ANSI implementation.
+// -----------------------------------------------------------------------------
+
+#include <string>
+#include "constants.h"  // ColorAttribute
+
+// -----------------------------------------------------------------------------
+// Struct: TerminalCell
+// Purpose: One character position on screen with its color.
+// -----------------------------------------------------------------------------
+struct TerminalCell {
+    char ch;
+    ColorAttribute attribute;
+};
+
+// -----------------------------------------------------------------------------
+// Class: Terminal
+// Purpose: Console backend used by the renderer, the input helpers and the
+//          sound player. Screen output may be batched until flush().
+//          Keys are reported the way the Windows console does: Enter is '\r'
+//          and Backspace is '\b' on every platform.
+// -----------------------------------------------------------------------------
+class Terminal {
+public:
+    virtual ~Terminal() {}
+
+    // Prepares the console for full-screen use: clears it and hides the cursor.
+    virtual void open() = 0;
+    // Restores the console to the state open() found it in.
+    virtual void close() = 0;
+
+    // Draws a width x height block of cells, stored row by row, at (left, top).
+    virtual void writeRegion(int left, int top, int width, int height, const TerminalCell *cells) = 0;
+    // Moves the visible cursor, where echoed line input appears.
+    virtual void moveCursor(int x, int y) = 0;
+    // Sends any batched output to the console.
+    virtual void flush() = 0;
+
+    // Waits for one keypress without echo.
+    virtual char readKey() = 0;
+    // Reads one line with echo, without the line terminator.
+    virtual void readLine(std::string &line) = 0;
+
+    // Plays a tone and returns when it has finished; called from the sound worker.
+    virtual void playTone(unsigned frequency, unsigned durationMs) = 0;
+};
+
+// Returns the backend for the platform the program was built for.
+Terminal &systemTerminal();
+
+#endif // TERMINAL_H
@@ -0,0 +1,152 @@
+#ifndef _WIN32
+
+#include "terminal.h"
+#include <termios.h>
+#include <unistd.h>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+
+// -----------------------------------------------------------------------------
+// Helper: ansiColor
+// Purpose: Converts a Win32-style blue/green/red bit triple to the ANSI color
+//          index, which orders the bits red, green, blue.
+// -----------------------------------------------------------------------------
+static int ansiColor(int bits) {
+    return ((bits & 4) ? 1 : 0) | ((bits & 2) ? 2 : 0) | ((bits & 1) ? 4 : 0);
+}
+
+// -----------------------------------------------------------------------------
+// Class: PosixTerminal
+// Purpose: Console backend for ANSI terminals. Screen output is collected in
+//          one string and written with a single write() per flush(); keys are
+//          read in raw (non-canonical, no echo) mode.
+// -----------------------------------------------------------------------------
+class PosixTerminal : public Terminal {
+public:
+    PosixTerminal() : isOpen(false), haveSavedMode(false) {
+    }
+
+    void open() override {
+        if (isOpen)
+            return;
+        isOpen = true;
+        haveSavedMode = tcgetattr(STDIN_FILENO, &savedMode) == 0;
+        enterRawMode();
+        // Switch to the alternate screen, clear it and hide the cursor.
+        pending += "\x1b[?1049h\x1b[2J\x1b[H\x1b[?25l";
+        flush();
+    }
+
+    void close() override {
+        if (!isOpen)
+            return;
+        isOpen = false;
+        pending += "\x1b[0m\x1b[?25h\x1b[?1049l";
+        flush();
+        if (haveSavedMode)
+            tcsetattr(STDIN_FILENO, TCSANOW, &savedMode);
+    }
+
+    ~PosixTerminal() override {
+        close();
+    }
+
+    void writeRegion(int left, int top, int width, int height, const TerminalCell *cells) override {
+        char sequence[32];
+        int current = -1;  // Attribute in effect; unknown at the start of each region
+        for (int y = 0; y < height; y++) {
+            std::snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", top + y + 1, left + 1);
+            pending += sequence;
+            for (int x = 0; x < width; x++) {
+                const TerminalCell &cell = cells[y * width + x];
+                if (cell.attribute != current) {
+                    current = cell.attribute;
+                    int foreground = ((current & FG_INTENSITY) ? 90 : 30) + ansiColor(current & 7);
+                    int backBits = (current >> 4) & 7;
+                    // A black background is left to the terminal's own background color.
+                    int background = backBits == 0 && !(current & BG_INTENSITY)
+                                         ? 49 : ((current & BG_INTENSITY) ? 100 : 40) + ansiColor(backBits);
+                    std::snprintf(sequence, sizeof(sequence), "\x1b[0;%d;%dm", foreground, background);
+                    pending += sequence;
+                }
+                pending += (cell.ch == '\0') ? ' ' : cell.ch;
+            }
+        }
+        pending += "\x1b[0m";
+    }
+
+    void moveCursor(int x, int y) override {
+        char sequence[32];
+        std::snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", y + 1, x + 1);
+        pending += sequence;
+    }
+
+    void flush() override {
+        size_t written = 0;
+        while (written < pending.size()) {
+            ssize_t result = ::write(STDOUT_FILENO, pending.data() + written, pending.size() - written);
+            if (result <= 0)
+                break;
+            written += static_cast<size_t>(result);
+        }
+        pending.clear();
+    }
+
+    char readKey() override {
+        unsigned char c = 0;
+        if (::read(STDIN_FILENO, &c, 1) != 1)
+            return 'q';  // Input closed: back out of every screen
+        if (c == '\n')
+            return '\r';
+        if (c == 0x7F)
+            return '\b';
+        return static_cast<char>(c);
+    }
+
+    void readLine(std::string &line) override {
+        // Line input needs the terminal's own editing and echo.
+        if (haveSavedMode)
+            tcsetattr(STDIN_FILENO, TCSANOW, &savedMode);
+        if (!std::getline(std::cin, line))
+            line.clear();
+        enterRawMode();
+    }
+
+    void playTone(unsigned, unsigned durationMs) override {
+        // Terminals have no pitch control; ring the bell and keep the pacing.
+        const char bell = '\a';
+        ssize_t ignored = ::write(STDOUT_FILENO, &bell, 1);
+        (void)ignored;
+        std::this_thread::sleep_for(std::chrono::milliseconds(durationMs));
+    }
+
+private:
+    bool isOpen;
+    bool haveSavedMode;       // savedMode holds the settings found by open()
+    struct termios savedMode;
+    std::string pending;      // Output batched until flush()
+
+    // Turns off line buffering and echo so single keys arrive immediately.
+    void enterRawMode() {
+        if (!haveSavedMode)
+            return;
+        struct termios raw = savedMode;
+        raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Function: systemTerminal
+// Purpose: Returns the process-wide ANSI terminal backend.
+// -----------------------------------------------------------------------------
+Terminal &systemTerminal() {
+    static PosixTerminal terminal;
+    return terminal;
+}
+
+#endif // !_WIN32
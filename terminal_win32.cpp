@@ -0,0 +1,93 @@
+#ifdef _WIN32
+
+#include "terminal.h"
+#include <windows.h>
+#include <conio.h>     // _getch for unbuffered key input
+#include <iostream>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Class: Win32Terminal
+// Purpose: Console backend built on the Win32 console API. Color attributes
+//          already use the console's bit layout and are passed through.
+// -----------------------------------------------------------------------------
+class Win32Terminal : public Terminal {
+public:
+    Win32Terminal() : output(GetStdHandle(STD_OUTPUT_HANDLE)) {
+    }
+
+    void open() override {
+        // Hide the blinking console cursor for a cleaner UI appearance.
+        CONSOLE_CURSOR_INFO cursorInfo;
+        GetConsoleCursorInfo(output, &cursorInfo);
+        cursorInfo.bVisible = FALSE;
+        SetConsoleCursorInfo(output, &cursorInfo);
+
+        // Blank the whole screen buffer once; later frames only send changes.
+        CONSOLE_SCREEN_BUFFER_INFO info;
+        if (GetConsoleScreenBufferInfo(output, &info)) {
+            DWORD cells = static_cast<DWORD>(info.dwSize.X) * static_cast<DWORD>(info.dwSize.Y);
+            DWORD written = 0;
+            COORD home = { 0, 0 };
+            FillConsoleOutputCharacterA(output, ' ', cells, home, &written);
+            FillConsoleOutputAttribute(output, ConsoleColors::DEFAULT, cells, home, &written);
+            SetConsoleCursorPosition(output, home);
+        }
+    }
+
+    void close() override {
+        CONSOLE_CURSOR_INFO cursorInfo;
+        GetConsoleCursorInfo(output, &cursorInfo);
+        cursorInfo.bVisible = TRUE;
+        SetConsoleCursorInfo(output, &cursorInfo);
+    }
+
+    void writeRegion(int left, int top, int width, int height, const TerminalCell *cells) override {
+        buffer.resize(static_cast<size_t>(width) * height);
+        for (size_t i = 0; i < buffer.size(); i++) {
+            buffer[i].Char.AsciiChar = cells[i].ch;
+            buffer[i].Attributes = cells[i].attribute;
+        }
+        COORD size = { static_cast<SHORT>(width), static_cast<SHORT>(height) };
+        COORD origin = { 0, 0 };
+        SMALL_RECT region = { static_cast<SHORT>(left), static_cast<SHORT>(top),
+                              static_cast<SHORT>(left + width - 1), static_cast<SHORT>(top + height - 1) };
+        WriteConsoleOutputA(output, buffer.data(), size, origin, &region);
+    }
+
+    void moveCursor(int x, int y) override {
+        COORD coord = { static_cast<SHORT>(x), static_cast<SHORT>(y) };
+        SetConsoleCursorPosition(output, coord);
+    }
+
+    void flush() override {
+        // WriteConsoleOutput is not buffered.
+    }
+
+    char readKey() override {
+        return static_cast<char>(_getch());
+    }
+
+    void readLine(std::string &line) override {
+        std::getline(std::cin, line);
+    }
+
+    void playTone(unsigned frequency, unsigned durationMs) override {
+        Beep(frequency, durationMs);
+    }
+
+private:
+    HANDLE output;                  // Console screen buffer
+    std::vector<CHAR_INFO> buffer;  // Reused staging area for writeRegion
+};
+
+// -----------------------------------------------------------------------------
+// Function: systemTerminal
+// Purpose: Returns the process-wide Win32 console backend.
+// -----------------------------------------------------------------------------
+Terminal &systemTerminal() {
+    static Win32Terminal terminal;
+    return terminal;
+}
+
+#endif // _WIN32
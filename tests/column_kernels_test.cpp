@@ -0,0 +1,75 @@
+// -----------------------------------------------------------------------------
+// File: column_kernels_test.cpp
+// Purpose: Checks that every column sum kernel returns exactly the sums of a
+//          plain 64-bit reference loop, on stores with extreme values, uneven
+//          tails and released rows. Exits non-zero on the first mismatch.
+// -----------------------------------------------------------------------------
+
+#include "food_columns.h"
+#include <climits>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Helper: randomValue
+// Purpose: Mostly small values, with INT_MAX, INT_MIN and values near them
+//          often enough that any 32-bit accumulation would overflow.
+// -----------------------------------------------------------------------------
+static int randomValue(std::mt19937 &random) {
+    switch (random() % 8) {
+    case 0: return INT_MAX;
+    case 1: return INT_MIN;
+    case 2: return INT_MAX - static_cast<int>(random() % 1000);
+    case 3: return INT_MIN + static_cast<int>(random() % 1000);
+    default: return static_cast<int>(random() % 2001) - 1000;
+    }
+}
+
+int main() {
+    const SumKernel kernels[] = { SUM_KERNEL_SCALAR, SUM_KERNEL_SSE2, SUM_KERNEL_AVX2 };
+    std::mt19937 random(12345);
+    int failures = 0;
+    for (int store = 0; store < 200; store++) {
+        // Sizes around block and vector boundaries as well as random ones.
+        size_t rowCount = store < 16 ? FOOD_BLOCK_ROWS - 8 + store : random() % 20000;
+        FoodColumns columns;
+        ColumnTotals expected;
+        std::vector<Food> foods(rowCount);
+        for (size_t i = 0; i < rowCount; i++) {
+            Food &food = foods[i];
+            food.calories = randomValue(random);
+            food.carbs = randomValue(random);
+            food.protein = randomValue(random);
+            food.fat = randomValue(random);
+            food.grams = randomValue(random);
+            columns.append(food);
+        }
+        for (size_t i = 0; i < rowCount; i++) {
+            if (random() % 5 == 0) {
+                columns.release(static_cast<uint32_t>(i));
+                continue;
+            }
+            expected.values[COLUMN_CALORIES] += foods[i].calories;
+            expected.values[COLUMN_CARBS] += foods[i].carbs;
+            expected.values[COLUMN_PROTEIN] += foods[i].protein;
+            expected.values[COLUMN_FAT] += foods[i].fat;
+            expected.values[COLUMN_GRAMS] += foods[i].grams;
+        }
+        for (SumKernel kernel : kernels) {
+            ColumnTotals totals = columns.sumLive(kernel);
+            for (int column = 0; column < FOOD_COLUMN_COUNT; column++) {
+                if (totals.values[column] == expected.values[column])
+                    continue;
+                std::printf("store %d (%zu rows), %s kernel, column %d: %lld, expected %lld\n", store, rowCount,
+                            sumKernelName(kernel), column, static_cast<long long>(totals.values[column]),
+                            static_cast<long long>(expected.values[column]));
+                failures++;
+            }
+        }
+    }
+    for (SumKernel kernel : kernels)
+        std::printf("%s: %s\n", sumKernelName(kernel), sumKernelSupported(kernel) ? "tested" : "not supported here, scalar used");
+    std::printf(failures == 0 ? "All kernels bit-exact\n" : "%d mismatches\n", failures);
+    return failures == 0 ? 0 : 1;
+}
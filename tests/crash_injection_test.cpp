@@ -0,0 +1,388 @@
+// -----------------------------------------------------------------------------
+// File: crash_injection_test.cpp
+// Purpose: Crash-injection harness for the data files (POSIX only).
+//          - A child process applies a fixed stream of random edits to a
+//            DataManager, saving every few hundred or few dozen edits and
+//            reporting each completed save through a pipe.
+//          - The parent kills it with SIGKILL at a random moment, reloads
+//            the files and compares the result with a model of the edits.
+//            The data must equal the model after some prefix of the edits,
+//            at least as long as the last reported save: nothing saved is
+//            lost, nothing is applied twice or out of order.
+//          - Then counts device syncs for the same edits with and without
+//            journal sync batching.
+//          Exits non-zero on any failure.
+// -----------------------------------------------------------------------------
+
+#include "data_manager.h"
+#include "durable_file.h"  // deviceSyncCount
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+static const char *const NAMES[] = { "Apple", "Rice", "Chicken", "Yogurt", "Soup" };
+static const int EDIT_COUNT = 3000;
+static const Date FIRST_DAY = Date::fromCivil(2024, 1, 1);
+
+// -----------------------------------------------------------------------------
+// Structure: Edit
+// Purpose: One generated change: add, edit or delete an entry, or new goals.
+// -----------------------------------------------------------------------------
+enum EditKind { EDIT_ADD, EDIT_REPLACE, EDIT_REMOVE, EDIT_GOALS };
+
+struct Edit {
+    EditKind kind;
+    Date date;
+    size_t index;      // Entry replaced or removed
+    int name;          // Index into NAMES
+    int values[5];     // calories, carbs, protein, fat, grams; goals use the first four
+};
+
+// -----------------------------------------------------------------------------
+// Helpers: mix / hashDay
+// Purpose: Order-sensitive 64-bit fingerprint of one day's entries, the same
+//          for the model and for a loaded snapshot.
+// -----------------------------------------------------------------------------
+static uint64_t mix(uint64_t hash, uint64_t value) {
+    hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    return hash * 0x100000001B3ull;
+}
+
+static uint64_t mixFood(uint64_t hash, std::string_view name, const int values[5]) {
+    for (char c : name)
+        hash = mix(hash, static_cast<unsigned char>(c));
+    for (int i = 0; i < 5; i++)
+        hash = mix(hash, static_cast<uint32_t>(values[i]));
+    return mix(hash, 0xFF);
+}
+
+static uint64_t mixGoals(const int goals[4]) {
+    uint64_t hash = 17;
+    for (int i = 0; i < 4; i++)
+        hash = mix(hash, static_cast<uint32_t>(goals[i]));
+    return hash;
+}
+
+// -----------------------------------------------------------------------------
+// Class: Model
+// Purpose: What the data should hold after each edit, with a fingerprint
+//          updated per edit in O(entries of the changed day).
+// -----------------------------------------------------------------------------
+class Model {
+public:
+    Model() : goals{ 2000, 250, 150, 70 }, daysHash(0) {}
+
+    void apply(const Edit &edit) {
+        if (edit.kind == EDIT_GOALS) {
+            for (int i = 0; i < 4; i++)
+                goals[i] = edit.values[i];
+            return;
+        }
+        std::vector<Edit> &foods = days[edit.date.days()];
+        daysHash -= hashOf(edit.date, foods);
+        if (edit.kind == EDIT_ADD)
+            foods.push_back(edit);
+        else if (edit.kind == EDIT_REPLACE)
+            foods[edit.index] = edit;
+        else
+            foods.erase(foods.begin() + static_cast<std::ptrdiff_t>(edit.index));
+        daysHash += hashOf(edit.date, foods);
+    }
+
+    size_t entryCount(Date date) const {
+        auto it = days.find(date.days());
+        return it == days.end() ? 0 : it->second.size();
+    }
+
+    uint64_t fingerprint() const { return mix(mixGoals(goals), daysHash); }
+
+    // Days without entries hash to 0, like days a snapshot leaves out.
+    static uint64_t hashOf(Date date, const std::vector<Edit> &foods) {
+        if (foods.empty())
+            return 0;
+        uint64_t hash = mix(1, static_cast<uint32_t>(date.days()));
+        for (const Edit &food : foods)
+            hash = mixFood(hash, NAMES[food.name], food.values);
+        return hash;
+    }
+
+private:
+    int goals[4];
+    std::map<int32_t, std::vector<Edit>> days;
+    uint64_t daysHash;  // Sum of every day's hash
+};
+
+// -----------------------------------------------------------------------------
+// Helper: generateEdits
+// Purpose: A fixed random stream of valid edits over 60 days, and the model
+//          fingerprint after each prefix: fingerprints[k] is after k edits.
+// -----------------------------------------------------------------------------
+static void generateEdits(std::vector<Edit> &edits, std::vector<uint64_t> &fingerprints) {
+    std::mt19937 random(2024);
+    Model model;
+    fingerprints.push_back(model.fingerprint());
+    for (int i = 0; i < EDIT_COUNT; i++) {
+        Edit edit;
+        unsigned choice = random() % 20;
+        edit.date = FIRST_DAY + static_cast<int32_t>(random() % 60);
+        edit.name = static_cast<int>(random() % 5);
+        for (int &value : edit.values)
+            value = static_cast<int>(random() % 900);
+        size_t count = model.entryCount(edit.date);
+        edit.index = count > 0 ? random() % count : 0;
+        if (choice == 0)
+            edit.kind = EDIT_GOALS;
+        else if (choice >= 12 && choice < 17 && count > 0)
+            edit.kind = EDIT_REPLACE;
+        else if (choice >= 17 && count > 0)
+            edit.kind = EDIT_REMOVE;
+        else
+            edit.kind = EDIT_ADD;
+        model.apply(edit);
+        edits.push_back(edit);
+        fingerprints.push_back(model.fingerprint());
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Helper: applyEdit
+// Purpose: Makes one generated edit through the DataManager API.
+// -----------------------------------------------------------------------------
+static void applyEdit(DataManager &data, const Edit &edit) {
+    Food food(NAMES[edit.name], edit.values[0], edit.values[1], edit.values[2], edit.values[3], edit.values[4]);
+    if (edit.kind == EDIT_ADD) {
+        data.addFood(edit.date, food);
+    } else if (edit.kind == EDIT_REPLACE) {
+        data.updateFood(edit.date, edit.index, food);
+    } else if (edit.kind == EDIT_REMOVE) {
+        data.removeFood(edit.date, edit.index);
+    } else {
+        DailyGoals goals = { edit.values[0], edit.values[1], edit.values[2], edit.values[3] };
+        data.setDailyGoals(goals);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Helper: fingerprintOf
+// Purpose: The model fingerprint computed from a DataManager's snapshot.
+// -----------------------------------------------------------------------------
+static uint64_t fingerprintOf(const DataManager &data) {
+    std::shared_ptr<const DataSnapshot> snapshot = data.snapshot();
+    std::vector<const DaySnapshot *> days;
+    snapshot->collectDays(days);
+    uint64_t daysHash = 0;
+    for (const DaySnapshot *day : days) {
+        uint64_t hash = mix(1, static_cast<uint32_t>(day->date.days()));
+        snapshot->visitFoods(*day, [&hash](const Food &food, std::string_view name) {
+            int values[5] = { food.calories, food.carbs, food.protein, food.fat, food.grams };
+            hash = mixFood(hash, name, values);
+        });
+        daysHash += hash;
+    }
+    return mix(mixGoals(snapshot->goals()), daysHash);
+}
+
+static DataFiles testFiles(const fs::path &directory) {
+    return DataFiles{ (directory / "data.txt").string(), (directory / "data.bin").string(),
+                      (directory / "data.journal").string() };
+}
+
+static void removeFiles(const DataFiles &files) {
+    fs::remove(files.text);
+    fs::remove(files.binary);
+    fs::remove(files.journal);
+    fs::remove(files.binary + ".tmp");
+}
+
+// -----------------------------------------------------------------------------
+// Helper: runChild
+// Purpose: Body of the child process: every edit, a save every
+//          'saveEvery' edits, and the number of edits each save covers
+//          written to 'reportFd'. Never returns.
+// -----------------------------------------------------------------------------
+[[noreturn]] static void runChild(const DataFiles &files, const std::vector<Edit> &edits, int saveEvery, int reportFd) {
+    {
+        DataManager data(files);
+        data.loadData();
+        for (size_t i = 0; i < edits.size(); i++) {
+            applyEdit(data, edits[i]);
+            if ((i + 1) % static_cast<size_t>(saveEvery) == 0 && data.saveData()) {
+                uint32_t saved = static_cast<uint32_t>(i + 1);
+                if (write(reportFd, &saved, sizeof(saved)) != sizeof(saved))
+                    _exit(2);
+            }
+        }
+        data.saveData();
+    }
+    uint32_t saved = static_cast<uint32_t>(edits.size());
+    if (write(reportFd, &saved, sizeof(saved)) != sizeof(saved))
+        _exit(2);
+    _exit(0);
+}
+
+// -----------------------------------------------------------------------------
+// Helper: crashRun
+// Purpose: Forks a child on fresh files and kills it after 'killAfter'
+//          (never, if negative). Returns the edit count of the last save
+//          the child reported, and sets 'finished' if it exited by itself.
+// -----------------------------------------------------------------------------
+static uint32_t crashRun(const DataFiles &files, const std::vector<Edit> &edits, int saveEvery,
+                         std::chrono::microseconds killAfter, bool &finished) {
+    removeFiles(files);
+    int report[2];
+    if (pipe(report) != 0)
+        return 0;
+    std::fflush(stdout);
+    pid_t child = fork();
+    if (child == 0) {
+        close(report[0]);
+        runChild(files, edits, saveEvery, report[1]);
+    }
+    close(report[1]);
+    if (killAfter.count() >= 0) {
+        std::this_thread::sleep_for(killAfter);
+        kill(child, SIGKILL);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    finished = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    uint32_t saved = 0, value;
+    while (read(report[0], &value, sizeof(value)) == sizeof(value))
+        saved = value;
+    close(report[0]);
+    return saved;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: checkRecovery
+// Purpose: Reloads the files twice (the first load may compact a damaged
+//          journal) and finds the prefix of the edits the data matches.
+//          Returns that prefix length, or -1 if the data matches none at
+//          or after 'saved'.
+// -----------------------------------------------------------------------------
+static int checkRecovery(const DataFiles &files, const std::vector<uint64_t> &fingerprints, uint32_t saved) {
+    uint64_t first, second;
+    {
+        DataManager data(files);
+        data.loadData();
+        first = fingerprintOf(data);
+    }
+    {
+        DataManager data(files);
+        data.loadData();
+        second = fingerprintOf(data);
+    }
+    if (first != second)
+        return -1;
+    for (size_t k = saved; k < fingerprints.size(); k++) {
+        if (fingerprints[k] == first)
+            return static_cast<int>(k);
+    }
+    return -1;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: countSyncs
+// Purpose: Device syncs and wall time for 'count' edits, 'gap' apart, with
+//          the given journal sync interval, including the final save.
+// -----------------------------------------------------------------------------
+static uint64_t countSyncs(const DataFiles &files, const std::vector<Edit> &edits, size_t count,
+                           std::chrono::milliseconds gap, uint32_t interval, double &seconds) {
+    removeFiles(files);
+    uint64_t before = deviceSyncCount();
+    auto start = std::chrono::steady_clock::now();
+    {
+        DataManager data(files);
+        data.setSyncInterval(interval);
+        data.loadData();
+        for (size_t i = 0; i < count; i++) {
+            applyEdit(data, edits[i]);
+            if (gap.count() > 0)
+                std::this_thread::sleep_for(gap);
+        }
+        data.saveData();
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return deviceSyncCount() - before;
+}
+
+int main() {
+    fs::path directory = fs::temp_directory_path() / "calorie_tests" / "crash_injection";
+    fs::create_directories(directory);
+    DataFiles files = testFiles(directory);
+    std::vector<Edit> edits;
+    std::vector<uint64_t> fingerprints;
+    generateEdits(edits, fingerprints);
+    int failures = 0;
+
+    // An uninterrupted run must end on the last model state; its length
+    // sets the window the kills are spread over.
+    const int saveIntervals[] = { 300, 40 };
+    std::mt19937 random(99);
+    for (int saveEvery : saveIntervals) {
+        bool finished = false;
+        auto start = std::chrono::steady_clock::now();
+        crashRun(files, edits, saveEvery, std::chrono::microseconds(-1), finished);
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        if (!finished || checkRecovery(files, fingerprints, EDIT_COUNT) != EDIT_COUNT) {
+            std::printf("saves every %d edits: uninterrupted run does not end on the last state\n", saveEvery);
+            failures++;
+            continue;
+        }
+
+        const int runs = 50;
+        int intact = 0, killed = 0;
+        long journaledBeyondSave = 0;
+        for (int run = 0; run < runs; run++) {
+            std::chrono::microseconds killAfter(static_cast<long>(random() % static_cast<unsigned>(duration.count() + 1)));
+            uint32_t saved = crashRun(files, edits, saveEvery, killAfter, finished);
+            int recovered = checkRecovery(files, fingerprints, saved);
+            if (!finished)
+                killed++;
+            if (recovered < 0) {
+                std::printf("  run %d: killed after %lld us, last save at edit %u: data matches no later state\n", run,
+                            static_cast<long long>(killAfter.count()), saved);
+                failures++;
+                continue;
+            }
+            intact++;
+            journaledBeyondSave += recovered - static_cast<long>(saved);
+        }
+        std::printf("saves every %3d edits: %d/%d runs intact (%d killed mid-run), on average %.0f edits "
+                    "recovered from the journal beyond the last save\n",
+                    saveEvery, intact, runs, killed, static_cast<double>(journaledBeyondSave) / runs);
+    }
+
+    // Write amplification: device syncs with every change synced against
+    // changes batched over JOURNAL_SYNC_INTERVAL_MS.
+    double unbatchedTime = 0, batchedTime = 0;
+    uint64_t unbatched = countSyncs(files, edits, 2000, std::chrono::milliseconds(0), 0, unbatchedTime);
+    uint64_t batched = countSyncs(files, edits, 2000, std::chrono::milliseconds(0), 100, batchedTime);
+    std::printf("2000 edits back to back: interval 0: %llu syncs, %.0f ms; interval 100: %llu syncs, %.0f ms\n",
+                static_cast<unsigned long long>(unbatched), unbatchedTime * 1e3,
+                static_cast<unsigned long long>(batched), batchedTime * 1e3);
+    if (batched >= unbatched) {
+        std::printf("  batching did not reduce syncs\n");
+        failures++;
+    }
+    unbatched = countSyncs(files, edits, 100, std::chrono::milliseconds(5), 0, unbatchedTime);
+    batched = countSyncs(files, edits, 100, std::chrono::milliseconds(5), 100, batchedTime);
+    std::printf("100 edits 5 ms apart:    interval 0: %llu syncs, %.0f ms; interval 100: %llu syncs, %.0f ms\n",
+                static_cast<unsigned long long>(unbatched), unbatchedTime * 1e3,
+                static_cast<unsigned long long>(batched), batchedTime * 1e3);
+
+    removeFiles(files);
+    fs::remove_all(directory);
+    std::printf(failures == 0 ? "No data lost\n" : "%d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+// -----------------------------------------------------------------------------
+// File: data_snapshot_test.cpp
+// Purpose: Checks that a snapshot whose days are still in the data file keeps
+//          reading its own version of them after those days are changed and
+//          the file is saved again, and that the live data sees the changes.
+//          Exits non-zero on any difference.
+// -----------------------------------------------------------------------------
+
+#include "data_manager.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// -----------------------------------------------------------------------------
+// Helper: textOf
+// Purpose: Every day of 'snapshot' with its entries, one line per entry.
+//          A day that cannot be read is marked as such.
+// -----------------------------------------------------------------------------
+static std::string textOf(const DataSnapshot &snapshot) {
+    std::vector<const DaySnapshot *> days;
+    snapshot.collectDays(days);
+    std::string text;
+    for (const DaySnapshot *day : days) {
+        text += day->date.toString() + (day->stored ? " (stored)\n" : "\n");
+        bool read = snapshot.visitFoods(*day, [&text](const Food &food, std::string_view name) {
+            text += "  " + std::string(name) + " " + std::to_string(food.calories) + " " +
+                    std::to_string(food.grams) + "\n";
+        });
+        if (!read)
+            text += "  (unreadable)\n";
+    }
+    return text;
+}
+
+static std::string readFile(const fs::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static int check(bool ok, const char *what) {
+    if (!ok)
+        std::printf("FAILED: %s\n", what);
+    return ok ? 0 : 1;
+}
+
+int main() {
+    fs::path directory = fs::temp_directory_path() / "calorie_tests" / "data_snapshot";
+    fs::create_directories(directory);
+    DataFiles files{ (directory / "data.txt").string(), (directory / "data.bin").string(),
+                     (directory / "data.journal").string() };
+    fs::remove(files.binary);
+    fs::remove(files.journal);
+
+    const Date first = Date::fromCivil(2024, 3, 1);
+    {
+        DataManager data(files);
+        data.loadData();
+        for (int day = 0; day < 5; day++) {
+            for (int entry = 0; entry < 3; entry++)
+                data.addFood(first + day, Food("Oats", 100 * day + entry, 10, 5, 2, 50 + entry));
+        }
+        data.saveData();
+    }
+
+    int failures = 0;
+    DataManager data(files);
+    data.loadData();
+    // Every day is still in the file, so this snapshot reads them all there.
+    std::shared_ptr<const DataSnapshot> before = data.snapshot();
+    std::string beforeText = textOf(*before);
+    failures += check(beforeText.find("(stored)") != std::string::npos, "days left in the file are stored");
+
+    // Change two of the stored days and save twice, so the file the first
+    // snapshot was taken from is replaced, and its replacement too.
+    data.addFood(first + 1, Food("Soup", 999, 1, 1, 1, 300));
+    data.removeFood(first + 3, 0);
+    failures += check(data.saveData(), "first save");
+    std::shared_ptr<const DataSnapshot> middle = data.snapshot();
+    std::string middleText = textOf(*middle);
+    data.updateFood(first + 1, 0, Food("Bread", 250, 40, 8, 3, 90));
+    failures += check(data.saveData(), "second save");
+
+    failures += check(textOf(*before) == beforeText, "the first snapshot still reads the first file");
+    failures += check(textOf(*middle) == middleText, "the second snapshot still reads the second file");
+    std::string afterText = textOf(*data.snapshot());
+    failures += check(afterText.find("Soup 999") != std::string::npos && afterText.find("Bread 250") != std::string::npos &&
+                      afterText.find("Oats 300 50") == std::string::npos,
+                      "the live data holds the changes");
+    failures += check(middleText.find("Oats 100 50") != std::string::npos, "the second snapshot predates the update");
+
+    // A fresh load of the saved file matches the live data.
+    fs::path exported = directory / "export_live.txt";
+    fs::path reloaded = directory / "export_reloaded.txt";
+    data.exportText(exported.string());
+    {
+        DataManager again(files);
+        again.loadData();
+        again.exportText(reloaded.string());
+    }
+    std::string liveFile = readFile(exported), reloadedFile = readFile(reloaded);
+    failures += check(!liveFile.empty() && liveFile == reloadedFile, "a reload matches the live data");
+
+    if (failures == 0)
+        std::printf("Snapshots keep their file version across saves\n");
+    return failures == 0 ? 0 : 1;
+}
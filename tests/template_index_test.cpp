@@ -0,0 +1,133 @@
+// -----------------------------------------------------------------------------
+// File: template_index_test.cpp
+// Purpose: Checks TemplateIndex against a brute-force edit distance over a
+//          library of several blocks: every template within the term's edit
+//          budget is found and nothing else, exact matches rank first, and
+//          the ranking does not depend on the terms searched before or on
+//          how many results were asked for. Exits non-zero on any difference.
+// -----------------------------------------------------------------------------
+
+#include "template_index.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// -----------------------------------------------------------------------------
+// Helper: distanceTo
+// Purpose: Fewest edits turning 'term' into some substring of 'name', both
+//          lower-case ASCII, by the textbook table for every start position.
+// -----------------------------------------------------------------------------
+static int distanceTo(const std::string &term, const std::string &name) {
+    int best = static_cast<int>(term.size());
+    for (size_t start = 0; start < name.size(); start++) {
+        size_t width = name.size() - start;
+        std::vector<int> previous(width + 1), current(width + 1);
+        for (size_t j = 0; j <= width; j++)
+            previous[j] = static_cast<int>(j);
+        for (size_t i = 1; i <= term.size(); i++) {
+            current[0] = static_cast<int>(i);
+            for (size_t j = 1; j <= width; j++) {
+                int substitute = previous[j - 1] + (term[i - 1] != name[start + j - 1] ? 1 : 0);
+                current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, substitute });
+            }
+            previous.swap(current);
+        }
+        best = std::min(best, *std::min_element(previous.begin(), previous.end()));
+    }
+    return best;
+}
+
+static std::string lowerCase(std::string_view text) {
+    std::string lower(text);
+    for (char &c : lower) {
+        if (c >= 'A' && c <= 'Z')
+            c = static_cast<char>(c - 'A' + 'a');
+    }
+    return lower;
+}
+
+static int check(bool ok, const std::string &what) {
+    if (!ok)
+        std::printf("FAILED: %s\n", what.c_str());
+    return ok ? 0 : 1;
+}
+
+int main() {
+    fs::path directory = fs::temp_directory_path() / "calorie_tests" / "template_index";
+    fs::create_directories(directory);
+    fs::path path = directory / "templates.txt";
+    static const char *const words[] = { "Chicken", "beef", "Rice", "salad", "soup", "bread", "cheese", "apple",
+                                         "pear", "grilled", "Spicy", "ham", "tuna", "milk", "oat", "chick" };
+    {
+        std::mt19937 random(3);
+        std::ofstream out(path, std::ios::binary);
+        std::vector<std::string> names;
+        // Three blocks' worth, so matches with edits span several blocks.
+        for (uint32_t i = 0; i < 3 * TemplateIndex::FUZZY_BLOCK; i++) {
+            std::string name;
+            for (unsigned word = random() % 3 + 1; word > 0; word--)
+                name += std::string(words[random() % 16]) + " ";
+            name += std::to_string(i % 97);
+            out << "TPL: " << name << "|100|10|5|2|100\n";
+            names.push_back(name);
+        }
+        for (size_t i = 0; i < 400; i += 7)
+            out << "USE: " << names[i] << '|' << 1 + i % 5 << '\n';
+    }
+
+    TemplateStore store(path.string());
+    store.ensureLoaded();
+    const std::vector<Food> &templates = store.all();
+    TemplateIndex index;
+    int failures = 0;
+    const char *const terms[] = { "ric", "chik", "brad", "tuan", "salda", "applle", "piccy",
+                                  "chikcen", "spicy ham", "oat 3", "beef r", "xyz" };
+    for (const char *term : terms) {
+        const std::string text = term;
+        const int maxEdits = text.size() <= 3 ? 0 : (text.size() <= 6 ? 1 : 2);
+        // Typed one byte at a time with a small page, as the popup does.
+        for (size_t length = 1; length <= text.size(); length++)
+            index.search(store, text.substr(0, length), 10);
+        const std::vector<uint32_t> results = index.search(store, text);
+        failures += check(index.complete(), text + ": a full search is complete");
+
+        std::vector<int> distances(templates.size());
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < templates.size(); i++) {
+            distances[i] = distanceTo(text, lowerCase(templates[i].name()));
+            if (distances[i] <= maxEdits)
+                expected.push_back(i);
+        }
+        std::vector<uint32_t> found = results;
+        std::sort(found.begin(), found.end());
+        failures += check(found == expected, text + ": finds exactly the templates within the budget");
+
+        bool edited = false, exactAfterEdited = false;
+        for (uint32_t i : results) {
+            edited = edited || distances[i] > 0;
+            exactAfterEdited = exactAfterEdited || (edited && distances[i] == 0);
+        }
+        failures += check(!exactAfterEdited, text + ": exact matches rank first");
+
+        TemplateIndex fresh;
+        failures += check(fresh.search(store, text) == results, text + ": same ranking without the earlier terms");
+        TemplateIndex paged;
+        paged.search(store, text, 5);
+        const std::vector<uint32_t> &page = paged.search(store, text, 50);
+        failures += check(page.size() >= std::min<size_t>(50, results.size()) &&
+                          std::equal(page.begin(), page.begin() + std::min<ptrdiff_t>(50, static_cast<ptrdiff_t>(results.size())),
+                                     results.begin()),
+                          text + ": a page is the start of the full ranking");
+    }
+    fs::remove(path);
+
+    if (failures == 0)
+        std::printf("Template search matches the brute-force edit distance\n");
+    return failures == 0 ? 0 : 1;
+}
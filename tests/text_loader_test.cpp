@@ -0,0 +1,91 @@
+// -----------------------------------------------------------------------------
+// File: text_loader_test.cpp
+// Purpose: Loads the same text data file with "\n" and with "\r\n" line ends
+//          through every loader and checks that each builds the same data,
+//          compared through exportText. Exits non-zero on any difference.
+// -----------------------------------------------------------------------------
+
+#include "data_manager.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// -----------------------------------------------------------------------------
+// Helpers: readFile / writeFile
+// Purpose: Whole-file contents, byte for byte.
+// -----------------------------------------------------------------------------
+static std::string readFile(const fs::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const fs::path &path, const std::string &contents) {
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+}
+
+// -----------------------------------------------------------------------------
+// Helper: loadAndExport
+// Purpose: Loads 'text' as a fresh data set with 'loader' and returns what
+//          exportText writes for it.
+// -----------------------------------------------------------------------------
+static std::string loadAndExport(const fs::path &directory, const std::string &text, LoaderType loader) {
+    DataFiles files{ (directory / "data.txt").string(), (directory / "data.bin").string(),
+                     (directory / "data.journal").string() };
+    fs::remove(files.binary);
+    fs::remove(files.journal);
+    writeFile(files.text, text);
+    std::string exported;
+    {
+        DataManager data(files);
+        data.setLoader(loader);
+        if (!data.loadData())
+            return "(not loaded)";
+        fs::path exportPath = directory / "export.txt";
+        if (!data.exportText(exportPath.string()))
+            return "(not exported)";
+        exported = readFile(exportPath);
+    }
+    return exported;
+}
+
+int main() {
+    fs::path directory = fs::temp_directory_path() / "calorie_tests" / "text_loader";
+    fs::create_directories(directory);
+
+    // The export format, so a correct load exports exactly the input.
+    std::string text = "DAILY_GOALS: 2100,260,140,65\n";
+    Date first = Date::fromCivil(2023, 12, 30);
+    for (int d = 0; d < 40; d++) {
+        text += "DATE: " + (first + d).toString() + "\n";
+        for (int f = 0; f <= d % 3; f++)
+            text += "FOOD: Food " + std::to_string(f) + "|" + std::to_string(100 + d) + "|20|10|5|150\n";
+    }
+    std::string crlf;
+    for (char c : text) {
+        if (c == '\n')
+            crlf += '\r';
+        crlf += c;
+    }
+
+    const struct { LoaderType type; const char *name; } loaders[] = {
+        { LOADER_STREAM, "stream" }, { LOADER_MAPPED, "mmap" }, { LOADER_PARALLEL, "parallel" }
+    };
+    int failures = 0;
+    for (const auto &loader : loaders) {
+        const struct { const std::string *input; const char *name; } inputs[] = { { &text, "LF" }, { &crlf, "CRLF" } };
+        for (const auto &input : inputs) {
+            std::string exported = loadAndExport(directory, *input.input, loader.type);
+            bool same = exported == text;
+            std::printf("%-8s %-4s %s\n", loader.name, input.name, same ? "ok" : "DIFFERENT");
+            if (!same)
+                failures++;
+        }
+    }
+    fs::remove_all(directory);
+    return failures == 0 ? 0 : 1;
+}
@@ -1,9 +1,9 @@
 #include "ui_manager.h"
 #include "constants.h"    // Provides console dimensions, color codes, and sound functions.
+#include "template_store.h"  // Persistent food template library
+#include "template_index.h"  // Ranked search over the template library
 #include <iostream>
-#include <conio.h>        // For _getch() used for capturing keyboard input.
-#include <windows.h>
-#include <ctime>          // For handling dates and time functions.
+#include "terminal.h"     // Console backend for input, cursor and output
 #include <cstdio>
 #include <sstream>
 #include <iomanip>
@@ -15,16 +15,42 @@
 // Global Variables and Helper Definitions for UIManager:
 // -----------------------------------------------------------------------------
 
-// A global vector holding predefined food templates.
-static std::vector<Food> g_foodTemplates;
+// The persistent food template library; read lazily when the template popup first opens.
+static TemplateStore g_templateStore(TEMPLATE_FILE);
+// Search index over g_templateStore; rebuilt automatically when the library changes.
+static TemplateIndex g_templateIndex;
 
 // Maximum display width allocated for food names in the UI table.
 const int maxNameLen = 21;
 
-// Utility function to get the day name from a given tm structure (e.g., Monday, Tuesday).
-std::string getDayOfWeek(const std::tm &timeInfo) {
-    static const char *days[] = { "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday" };
-    return days[timeInfo.tm_wday];
+// Day names indexed by Date::weekday() (0 = Sunday).
+static const char *const dayNames[] = { "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday" };
+
+// Calendar heatmap colours, from no entries to well over the calorie goal.
+static const ColorAttribute HEAT_EMPTY = FG_INTENSITY;
+static const ColorAttribute HEAT_UNDER = FG_GREEN | FG_BLUE | FG_INTENSITY;
+static const ColorAttribute HEAT_ON_TARGET = FG_GREEN | FG_INTENSITY;
+static const ColorAttribute HEAT_SLIGHTLY_OVER = FG_RED | FG_GREEN | FG_INTENSITY;
+static const ColorAttribute HEAT_OVER = FG_RED | FG_INTENSITY;
+
+// -----------------------------------------------------------------------------
+// Helper: heatmapColor
+// Purpose: Colours a calendar day by its calories against the daily goal:
+//          under 75%, 75-100% (on target), up to 110%, and beyond that.
+// -----------------------------------------------------------------------------
+static ColorAttribute heatmapColor(const RangeValues &day, int calorieGoal) {
+    if (day.entries == 0)
+        return HEAT_EMPTY;
+    if (calorieGoal <= 0)
+        return ConsoleColors::DEFAULT;
+    int64_t percent = day.calories * 100 / calorieGoal;
+    if (percent < 75)
+        return HEAT_UNDER;
+    if (percent <= 100)
+        return HEAT_ON_TARGET;
+    if (percent <= 110)
+        return HEAT_SLIGHTLY_OVER;
+    return HEAT_OVER;
 }
 
 // -----------------------------------------------------------------------------
@@ -32,34 +58,41 @@ std::string getDayOfWeek(const std::tm &timeInfo) {
 // -----------------------------------------------------------------------------
 
 // Constructor: Initializes the UIManager, sets the initial UI state, and prepares menu items.
-UIManager::UIManager(DataManager &dm) : 
-    dataManager(dm), 
+UIManager::UIManager(ProfileRegistry &registry, const std::string &profile) : 
+    calendarOriginalDate(),
+    profiles(registry), 
+    activeProfile(profile), 
+    dataManager(&registry.open(profile)), 
     currentState(STATE_MAIN_MENU), 
     selectedIndex(0),
+    foodScrollOffset(0),
     totalCalories(0), 
     totalCarbs(0), 
     totalProtein(0), 
     totalFat(0),
-    foodScrollOffset(0),
     selectedCalendarDay(1),
-    calendarOriginalDate("")
+    calendarMonth(MonthLayout::of(1970, 1)),
+    quitRequested(false),
+    terminal(systemTerminal()),
+    renderer(terminal),
+    rendererStream(renderer),
+    previousCoutBuffer(nullptr)
 {
-    // Obtain and set the current system date in "DD/MM/YYYY" format.
-    time_t now = time(0);
-    tm localTime;
-    localtime_s(&localTime, &now);
-    char buffer[11];
-    sprintf_s(buffer, "%02d/%02d/%04d", localTime.tm_mday, localTime.tm_mon + 1, localTime.tm_year + 1900);
-    currentDate = buffer;
+    // Start on today's date.
+    currentDate = Date::today();
 
     // Define the main menu items.
-    // Item 0: "Add from templates", Item 1: "Add custom food", Item 2: "Calendar", Item 3: "Reset goals"
-    menuItems = { "Add from templates", "Add custom food", "Calendar", "Reset goals" };
+    // Item 0: "Add from templates", Item 1: "Add custom food", Item 2: "Calendar", Item 3: "Reset goals",
+    // Item 4: "Switch profile"
+    menuItems = { "Add from templates", "Add custom food", "Calendar", "Reset goals", "Switch profile" };
 }
 
-// Destructor: Currently no dynamic allocation requires explicit cleanup.
+// Destructor: Gives std::cout its console stream buffer back and restores the console.
 UIManager::~UIManager() {
-    // Nothing to delete explicitly.
+    if (previousCoutBuffer) {
+        std::cout.rdbuf(previousCoutBuffer);
+        terminal.close();
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -67,12 +100,10 @@ UIManager::~UIManager() {
 // Purpose: Sets up the console environment (e.g., hides the cursor) and clears the screen.
 // -----------------------------------------------------------------------------
 void UIManager::init() {
-    // Hide the blinking console cursor for a cleaner UI appearance.
-    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    CONSOLE_CURSOR_INFO cursorInfo;
-    GetConsoleCursorInfo(hOut, &cursorInfo);
-    cursorInfo.bVisible = FALSE;
-    SetConsoleCursorInfo(hOut, &cursorInfo);
+    // Clear the console and hide the blinking cursor for a cleaner UI appearance.
+    terminal.open();
+    // From here on std::cout draws into the renderer's off-screen buffer.
+    previousCoutBuffer = std::cout.rdbuf(&rendererStream);
     clearScreen();
 }
 
@@ -81,18 +112,18 @@ void UIManager::init() {
 // Purpose: Core main loop of the UI; continuously refreshes and processes input.
 // -----------------------------------------------------------------------------
 void UIManager::run() {
-    while (true) {
+    while (!quitRequested) {
         // Check current UI state and render the corresponding screen.
         if (currentState == STATE_MAIN_MENU) {
             renderMainMenu();
             // Wait for a keypress to drive the UI navigation.
-            char key = _getch();
+            char key = readKey();
             processInput(key);
         }
         else if (currentState == STATE_CALENDAR) {
             renderCalendar();
             // Similarly, block until user presses a key.
-            char key = _getch();
+            char key = readKey();
             processCalendarInput(key);
         }
     }
@@ -100,19 +131,63 @@ void UIManager::run() {
 
 // -----------------------------------------------------------------------------
 // Utility: clearScreen
-// Purpose: Clears the console window using system calls.
+// Purpose: Starts a new frame by blanking the off-screen buffer; nothing is
+//          sent to the console until the next key or line is read.
 // -----------------------------------------------------------------------------
 void UIManager::clearScreen() {
-    system("cls");
+    renderer.clear();
 }
 
 // -----------------------------------------------------------------------------
 // Utility: setCursorPosition
-// Purpose: Sets the console cursor at a given (x,y) position.
+// Purpose: Moves the drawing position in the off-screen buffer to (x,y).
 // -----------------------------------------------------------------------------
 void UIManager::setCursorPosition(int x, int y) {
-    COORD coord = { static_cast<SHORT>(x), static_cast<SHORT>(y) };
-    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
+    renderer.setCursor(x, y);
+}
+
+// -----------------------------------------------------------------------------
+// Utility: setTextColor
+// Purpose: Sets the color attribute used for subsequent output.
+// -----------------------------------------------------------------------------
+void UIManager::setTextColor(ColorAttribute color) {
+    renderer.setColor(color);
+}
+
+// -----------------------------------------------------------------------------
+// Utility: readKey
+// Purpose: Shows the finished frame, then waits for a single keypress. The
+//          time until the next frame is shown counts as that frame's time.
+// -----------------------------------------------------------------------------
+char UIManager::readKey() {
+    renderer.present();
+    char key = terminal.readKey();
+    renderer.beginFrame();
+    return key;
+}
+
+// -----------------------------------------------------------------------------
+// Utility: readLine
+// Purpose: Shows the finished frame and reads a line with console echo. The
+//          echo bypasses the buffer, so the next frame is redrawn in full.
+// -----------------------------------------------------------------------------
+void UIManager::readLine(std::string &line) {
+    renderer.present();
+    terminal.readLine(line);
+    renderer.invalidate();
+    renderer.beginFrame();
+}
+
+// -----------------------------------------------------------------------------
+// Utility: shownMonth
+// Purpose: Returns the grid of currentDate's month. Moving within a month
+//          reuses the cached layout; it is rebuilt only when the month changes.
+// -----------------------------------------------------------------------------
+const MonthLayout &UIManager::shownMonth() {
+    CivilDate shown = currentDate.civil();
+    if (!calendarMonth.isMonth(shown.year, shown.month))
+        calendarMonth = MonthLayout::of(shown.year, shown.month);
+    return calendarMonth;
 }
 
 // -----------------------------------------------------------------------------
@@ -135,15 +210,7 @@ void UIManager::drawBorder(int x, int y, int width, int height) {
 // Purpose: Formats the current date along with the day name (e.g., "15/04/2025 - Tuesday").
 // -----------------------------------------------------------------------------
 std::string UIManager::getDisplayDate() const {
-    int day, month, year;
-    sscanf_s(currentDate.c_str(), "%d/%d/%d", &day, &month, &year);
-    tm timeInfo = {};
-    timeInfo.tm_mday = day;
-    timeInfo.tm_mon = month - 1;
-    timeInfo.tm_year = year - 1900;
-    mktime(&timeInfo);
-    std::string dayName = getDayOfWeek(timeInfo);
-    return currentDate + " - " + dayName;
+    return currentDate.toString() + " - " + dayNames[currentDate.weekday()];
 }
 
 // -----------------------------------------------------------------------------
@@ -151,34 +218,22 @@ std::string UIManager::getDisplayDate() const {
 // Purpose: Modifies the current date by a given number of days (negative for previous day, positive for next day).
 // -----------------------------------------------------------------------------
 void UIManager::changeDateByOffset(int offset) {
-    int day, month, year;
-    sscanf_s(currentDate.c_str(), "%d/%d/%d", &day, &month, &year);
-    tm timeInfo = {};
-    timeInfo.tm_mday = day + offset;
-    timeInfo.tm_mon = month - 1;
-    timeInfo.tm_year = year - 1900;
-    mktime(&timeInfo);
-    char buffer[11];
-    sprintf_s(buffer, "%02d/%02d/%04d", timeInfo.tm_mday, timeInfo.tm_mon + 1, timeInfo.tm_year + 1900);
-    currentDate = buffer;
+    currentDate = currentDate + offset;
     // Provide feedback for page switching.
     Sounds::PlayPageSwitchSound();
 }
 
 // -----------------------------------------------------------------------------
 // Method: updateTotals
-// Purpose: Recalculates the total nutritional values for the current day from all food entries.
+// Purpose: Copies the current day's running totals, which DailyRecord keeps
+//          up to date on every change, so no food entries are visited.
 // -----------------------------------------------------------------------------
 void UIManager::updateTotals() {
-    totalCalories = totalCarbs = totalProtein = totalFat = 0;
-    DailyRecord &record = dataManager.getRecord(currentDate);
-    // Sum each nutritional field across all food entries.
-    for (const auto &food : record.foods) {
-        totalCalories += food.calories;
-        totalCarbs += food.carbs;
-        totalProtein += food.protein;
-        totalFat += food.fat;
-    }
+    const DailyTotals &totals = dataManager->findRecord(currentDate).totals;
+    totalCalories = totals.calories;
+    totalCarbs = totals.carbs;
+    totalProtein = totals.protein;
+    totalFat = totals.fat;
 }
 
 // -----------------------------------------------------------------------------
@@ -188,33 +243,39 @@ void UIManager::updateTotals() {
 // -----------------------------------------------------------------------------
 void UIManager::renderMainMenu() {
     clearScreen();
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
 
     // Define bright colors to be used for visual feedback.
-    int brightGreen   = FOREGROUND_GREEN | FOREGROUND_INTENSITY;
-    int brightCyan    = FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
-    int brightBlue    = FOREGROUND_BLUE | FOREGROUND_INTENSITY;
-    int brightMagenta = FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
-    int brightRed     = FOREGROUND_RED | FOREGROUND_INTENSITY;
-    int selectedBrightRed = brightRed | BACKGROUND_BLUE;  
-    int darkRed       = FOREGROUND_RED;
-    int gray = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE;
+    int brightGreen   = FG_GREEN | FG_INTENSITY;
+    int brightCyan    = FG_GREEN | FG_BLUE | FG_INTENSITY;
+    int brightBlue    = FG_BLUE | FG_INTENSITY;
+    int brightMagenta = FG_RED | FG_BLUE | FG_INTENSITY;
+    int brightRed     = FG_RED | FG_INTENSITY;
+    int selectedBrightRed = brightRed | BG_BLUE;  
+    int darkRed       = FG_RED;
+    int gray = FG_RED | FG_GREEN | FG_BLUE;
 
     // Render the date header.
-    SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+    setTextColor(FG_RED | FG_GREEN | FG_INTENSITY);
     setCursorPosition(0, 0);
     std::cout << getDisplayDate();
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
+
+    // Render the active profile name on the right of the header.
+    std::string profileLabel = "Profile: " + activeProfile;
+    setTextColor(8);
+    setCursorPosition(CONSOLE_WIDTH - static_cast<int>(profileLabel.length()), 0);
+    std::cout << profileLabel;
+    setTextColor(ConsoleColors::DEFAULT);
 
     updateTotals();  // Update totals before displaying nutritional info
-    DailyGoals goals = dataManager.getDailyGoals();
+    DailyGoals goals = dataManager->getDailyGoals();
 
     // Display the calories information with formatting.
     int calLineY = 2;
     setCursorPosition((CONSOLE_WIDTH / 2) - 10, calLineY);
-    SetConsoleTextAttribute(hConsole, brightGreen);
+    setTextColor(brightGreen);
     std::cout << "Calories: ";
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
     int dispTotalCal = (totalCalories > 9999) ? 9999 : totalCalories;
     int dispGoalCal = (goals.calories > 9999) ? 9999 : goals.calories;
     std::ostringstream calStream;
@@ -225,9 +286,9 @@ void UIManager::renderMainMenu() {
     std::cout << std::setfill(' ');
     if (totalCalories > goals.calories) {
         setCursorPosition((CONSOLE_WIDTH / 2) - 10 + 10, calLineY);
-        SetConsoleTextAttribute(hConsole, darkRed);
+        setTextColor(darkRed);
         std::cout << calStr;
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
     }
 
     // Display macronutrient details: Carbs, Protein, Fat.
@@ -257,15 +318,15 @@ void UIManager::renderMainMenu() {
     int macroStartX = (CONSOLE_WIDTH - static_cast<int>(macroCombined.length())) / 2;
     // Print Carbs info.
     setCursorPosition(macroStartX, macroLineY);
-    SetConsoleTextAttribute(hConsole, brightCyan);
+    setTextColor(brightCyan);
     std::cout << carbsLabel;
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
     int carbsNumbersX = macroStartX + static_cast<int>(carbsLabel.length());
     setCursorPosition(carbsNumbersX, macroLineY);
     if (totalCarbs > goals.carbs) {
-        SetConsoleTextAttribute(hConsole, darkRed);
+        setTextColor(darkRed);
         std::cout << carbsNum;
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
     } else {
         std::cout << carbsNum;
     }
@@ -273,15 +334,15 @@ void UIManager::renderMainMenu() {
     // Print Protein info.
     int protStartX = carbsNumbersX + static_cast<int>(carbsNum.length()) + 2;
     setCursorPosition(protStartX, macroLineY);
-    SetConsoleTextAttribute(hConsole, brightBlue);
+    setTextColor(brightBlue);
     std::cout << protLabel;
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
     int protNumbersX = protStartX + static_cast<int>(protLabel.length());
     setCursorPosition(protNumbersX, macroLineY);
     if (totalProtein > goals.protein) {
-        SetConsoleTextAttribute(hConsole, darkRed);
+        setTextColor(darkRed);
         std::cout << protNum;
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
     } else {
         std::cout << protNum;
     }
@@ -289,15 +350,15 @@ void UIManager::renderMainMenu() {
     // Print Fat info.
     int fatStartX = protNumbersX + static_cast<int>(protNum.length()) + 2;
     setCursorPosition(fatStartX, macroLineY);
-    SetConsoleTextAttribute(hConsole, brightMagenta);
+    setTextColor(brightMagenta);
     std::cout << fatLabel;
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
     int fatNumbersX = fatStartX + static_cast<int>(fatLabel.length());
     setCursorPosition(fatNumbersX, macroLineY);
     if (totalFat > goals.fat) {
-        SetConsoleTextAttribute(hConsole, darkRed);
+        setTextColor(darkRed);
         std::cout << fatNum;
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
     } else {
         std::cout << fatNum;
     }
@@ -307,9 +368,8 @@ void UIManager::renderMainMenu() {
     std::cout << std::string(CONSOLE_WIDTH, '=');
 
     int menuCount = static_cast<int>(menuItems.size());
-    DailyRecord &record = dataManager.getRecord(currentDate);
-    int foodCount = static_cast<int>(record.foods.size());
-    int totalSelectable = menuCount + foodCount;
+    const DailyRecord &record = dataManager->findRecord(currentDate);
+    int foodCount = static_cast<int>(record.foodCount());
     int menuStartY = 6;
     
     // Render main menu buttons.
@@ -318,13 +378,13 @@ void UIManager::renderMainMenu() {
         int xPos = (CONSOLE_WIDTH - static_cast<int>(displayText.length())) / 2;
         setCursorPosition(xPos, menuStartY + i);
         if (selectedIndex == i) {
-            SetConsoleTextAttribute(hConsole, selectedBrightRed);
+            setTextColor(selectedBrightRed);
             std::cout << displayText;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         } else {
-            SetConsoleTextAttribute(hConsole, brightRed);
+            setTextColor(brightRed);
             std::cout << displayText;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         }
     }
     
@@ -348,17 +408,19 @@ void UIManager::renderMainMenu() {
     for (int j = foodScrollOffset; j < foodCount && j < foodScrollOffset + visibleFoodSlots; j++) {
         int globalIndex = menuCount + j;
         int currentRow = foodListStartY + j - foodScrollOffset;
+        // Gather the entry from the column store once per row.
+        const Food food = record.foods()[j];
         // Format the food name to fit in the allocated width.
         std::stringstream nameStream;
-        nameStream << std::setw(maxNameLen) << std::left << record.foods[j].name;
+        nameStream << std::setw(maxNameLen) << std::left << food.name();
         std::string formattedName = nameStream.str();
 
         // Format food details for display.
-        int dispFoodGrams = (record.foods[j].grams > 9999) ? 9999 : record.foods[j].grams;
-        int dispFoodCal = (record.foods[j].calories > 9999) ? 9999 : record.foods[j].calories;
-        int dispFoodCarbs = (record.foods[j].carbs > 999) ? 999 : record.foods[j].carbs;
-        int dispFoodProtein = (record.foods[j].protein > 999) ? 999 : record.foods[j].protein;
-        int dispFoodFat = (record.foods[j].fat > 999) ? 999 : record.foods[j].fat;
+        int dispFoodGrams = (food.grams > 9999) ? 9999 : food.grams;
+        int dispFoodCal = (food.calories > 9999) ? 9999 : food.calories;
+        int dispFoodCarbs = (food.carbs > 999) ? 999 : food.carbs;
+        int dispFoodProtein = (food.protein > 999) ? 999 : food.protein;
+        int dispFoodFat = (food.fat > 999) ? 999 : food.fat;
 
         std::ostringstream gramsStream, calStreamFood, carbsStreamFood, protStreamFood, fatStreamFood;
         gramsStream << std::setw(4) << std::setfill('0') << dispFoodGrams << " grams";
@@ -381,46 +443,46 @@ void UIManager::renderMainMenu() {
 
         // Render the food details differently if this row is selected.
         if (selectedIndex == globalIndex) {
-            SetConsoleTextAttribute(hConsole, selectedBrightRed);
+            setTextColor(selectedBrightRed);
             setCursorPosition(0, currentRow);
             std::cout << formattedName;
             setCursorPosition(detailsPrintX, currentRow);
-            SetConsoleTextAttribute(hConsole, gray);
+            setTextColor(gray);
             std::cout << gramsStr;
             std::cout << " ";
-            SetConsoleTextAttribute(hConsole, brightGreen);
+            setTextColor(brightGreen);
             std::cout << calStrFood;
             std::cout << " ";
-            SetConsoleTextAttribute(hConsole, brightCyan);
+            setTextColor(brightCyan);
             std::cout << carbsStr;
             std::cout << " ";
-            SetConsoleTextAttribute(hConsole, brightBlue);
+            setTextColor(brightBlue);
             std::cout << protStr;
             std::cout << " ";
-            SetConsoleTextAttribute(hConsole, brightMagenta);
+            setTextColor(brightMagenta);
             std::cout << fatStr;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         } else {
             setCursorPosition(0, currentRow);
-            SetConsoleTextAttribute(hConsole, brightRed);
+            setTextColor(brightRed);
             std::cout << formattedName;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
             setCursorPosition(detailsPrintX, currentRow);
-            SetConsoleTextAttribute(hConsole, gray);
+            setTextColor(gray);
             std::cout << gramsStr;
             std::cout << " ";
-            SetConsoleTextAttribute(hConsole, brightGreen);
+            setTextColor(brightGreen);
             std::cout << calStrFood;
             std::cout << " ";
-            SetConsoleTextAttribute(hConsole, brightCyan);
+            setTextColor(brightCyan);
             std::cout << carbsStr;
             std::cout << " ";
-            SetConsoleTextAttribute(hConsole, brightBlue);
+            setTextColor(brightBlue);
             std::cout << protStr;
             std::cout << " ";
-            SetConsoleTextAttribute(hConsole, brightMagenta);
+            setTextColor(brightMagenta);
             std::cout << fatStr;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         }
     }
 
@@ -437,24 +499,24 @@ void UIManager::renderMainMenu() {
         if (scrollRange > 0) {
             indicatorRow = foodListStartY + (foodScrollOffset * maxIndicatorPosition) / scrollRange;
         }
-        SetConsoleTextAttribute(hConsole, selectedBrightRed);
+        setTextColor(selectedBrightRed);
         setCursorPosition(scrollColumn, indicatorRow);
         std::cout << char(219);
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
     }
     
     // Render tips and instructions along the bottom.
-    SetConsoleTextAttribute(hConsole, 8);
+    setTextColor(8);
     setCursorPosition(0, CONSOLE_HEIGHT - 3);
     std::cout << std::string(CONSOLE_WIDTH, '-');
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
     
     std::string tips = "[q] Quit  [j/k] Down/Up  [h/l] Prev Day/Next Day  [Enter] Select  [x] Delete";
-    SetConsoleTextAttribute(hConsole, 8);
+    setTextColor(8);
     int tipX = (CONSOLE_WIDTH - static_cast<int>(tips.length())) / 2;
     setCursorPosition(tipX, CONSOLE_HEIGHT - 2);
     std::cout << tips;
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
 }
 
 // -----------------------------------------------------------------------------
@@ -464,8 +526,8 @@ void UIManager::renderMainMenu() {
 // -----------------------------------------------------------------------------
 void UIManager::processInput(char key) {
     int menuCount = static_cast<int>(menuItems.size());
-    DailyRecord &record = dataManager.getRecord(currentDate);
-    int foodCount = static_cast<int>(record.foods.size());
+    const DailyRecord &record = dataManager->findRecord(currentDate);
+    int foodCount = static_cast<int>(record.foodCount());
     int totalSelectable = menuCount + foodCount;
     int borderY = 6 + menuItems.size();
     int visibleSlots = CONSOLE_HEIGHT - 4 - borderY;
@@ -528,6 +590,10 @@ void UIManager::processInput(char key) {
                 } else if (selectedIndex == 3) {
                     // Option to reset daily nutritional goals.
                     handleResetGoals();
+                } else if (selectedIndex == 4) {
+                    // Pick another profile or create one.
+                    handleSwitchProfile();
+                    return;
                 }
             } else {
                 int foodIndex = selectedIndex - menuCount;
@@ -541,10 +607,9 @@ void UIManager::processInput(char key) {
             if (selectedIndex >= menuCount) {
                 int foodIndex = selectedIndex - menuCount;
                 if (foodIndex >= 0 && foodIndex < foodCount) {
-                    record.foods.erase(record.foods.begin() + foodIndex);
-                    if (selectedIndex >= menuCount + static_cast<int>(record.foods.size()))
-                        selectedIndex = menuCount + static_cast<int>(record.foods.size()) - 1;
-                    dataManager.saveData();
+                    dataManager->removeFood(currentDate, foodIndex);
+                    if (selectedIndex >= menuCount + static_cast<int>(record.foodCount()))
+                        selectedIndex = menuCount + static_cast<int>(record.foodCount()) - 1;
                     Sounds::PlaySelectSound();
                 }
             }
@@ -558,10 +623,16 @@ void UIManager::processInput(char key) {
             changeDateByOffset(1);
             selectedIndex = 0;
             foodScrollOffset = 0;
+        } else if (key == 'f') {
+            // Show or hide the frame-time counter.
+            renderer.toggleFrameTime();
+        } else if (key == 'm') {
+            // Mute or unmute feedback tones.
+            Sounds::ToggleMute();
         } else if (key == 'q') {
-            // Quit the application.
+            // Quit the application; run() returns so pending changes are compacted on exit.
             Sounds::PlaySelectSound();
-            exit(0);
+            quitRequested = true;
         }
     }
 }
@@ -571,23 +642,21 @@ void UIManager::processInput(char key) {
 // Purpose: Provides inline editing functionality for an existing food entry.
 // -----------------------------------------------------------------------------
 void UIManager::handleEditFood(int foodIndex) {
-    DailyRecord &record = dataManager.getRecord(currentDate);
-    if (foodIndex < 0 || foodIndex >= record.foods.size()) return;
+    const DailyRecord &record = dataManager->findRecord(currentDate);
+    if (foodIndex < 0 || static_cast<size_t>(foodIndex) >= record.foodCount()) return;
     
-    Food &foodToEdit = record.foods[foodIndex];
+    const Food foodToEdit = record.foods()[foodIndex];
     clearScreen();
-    int midX = CONSOLE_WIDTH / 2;
     int startY = 8;
     int localSelection = 0;
     bool done = false;
     // Pre-populate local variables with the current food details.
-    std::string foodName = foodToEdit.name;
+    std::string foodName(foodToEdit.name());
     int calories = foodToEdit.calories;
     int carbs = foodToEdit.carbs;
     int protein = foodToEdit.protein;
     int fat = foodToEdit.fat;
     int grams = foodToEdit.grams;
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     
     while (!done) {
         clearScreen();
@@ -610,13 +679,13 @@ void UIManager::handleEditFood(int foodIndex) {
             int buttonX = (CONSOLE_WIDTH - static_cast<int>(buttonText.length())) / 2;
             setCursorPosition(buttonX, startY + i);
             if (localSelection == i) {
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY | BACKGROUND_BLUE);
+                setTextColor(FG_RED | FG_INTENSITY | BG_BLUE);
                 std::cout << buttonText;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
             } else {
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
+                setTextColor(FG_RED | FG_INTENSITY);
                 std::cout << buttonText;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
             }
         }
         
@@ -626,29 +695,29 @@ void UIManager::handleEditFood(int foodIndex) {
         int updateX = (CONSOLE_WIDTH - static_cast<int>(updateButton.length())) / 2;
         setCursorPosition(updateX, updateY);
         if (localSelection == 6) {
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY | BACKGROUND_BLUE);
+            setTextColor(FG_RED | FG_INTENSITY | BG_BLUE);
             std::cout << updateButton;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         } else {
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
+            setTextColor(FG_RED | FG_INTENSITY);
             std::cout << updateButton;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         }
         
         // Render tips at the bottom.
-        SetConsoleTextAttribute(hConsole, 8);
+        setTextColor(8);
         setCursorPosition(0, CONSOLE_HEIGHT - 3);
         std::cout << std::string(CONSOLE_WIDTH, '-');
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
         std::string tips = "[q] Back  [j/k] Down/Up  [Enter] Select";
         int tipX = (CONSOLE_WIDTH - static_cast<int>(tips.length())) / 2;
         setCursorPosition(tipX, CONSOLE_HEIGHT - 2);
-        SetConsoleTextAttribute(hConsole, 8);
+        setTextColor(8);
         std::cout << tips;
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
         
         // Process keyboard input for editing fields.
-        char key = _getch();
+        char key = readKey();
         if (key == 'j') {
             localSelection++;
             if (localSelection > 6)
@@ -675,7 +744,7 @@ void UIManager::handleEditFood(int foodIndex) {
                 std::cout << std::string(20, ' ');
                 setCursorPosition(editX, editY);
                 std::string input;
-                std::getline(std::cin, input);
+                readLine(input);
                 if (!input.empty()) {
                     if (localSelection == 0) {
                         if (input.size() > maxNameLen)
@@ -699,13 +768,8 @@ void UIManager::handleEditFood(int foodIndex) {
                 }
             } else if (localSelection == 6) {
                 // Update the food entry with new values.
-                foodToEdit.name = (foodName.empty() ? "<empty>" : foodName);
-                foodToEdit.calories = calories;
-                foodToEdit.carbs = carbs;
-                foodToEdit.protein = protein;
-                foodToEdit.fat = fat;
-                foodToEdit.grams = grams;
-                dataManager.saveData();
+                Food updated((foodName.empty() ? "<empty>" : foodName), calories, carbs, protein, fat, grams);
+                dataManager->updateFood(currentDate, foodIndex, updated);
                 done = true;
             }
         } else if (key == 'q') {
@@ -723,10 +787,8 @@ void UIManager::handleEditFood(int foodIndex) {
 void UIManager::handleAddFromTemplate() {
     std::string searchTerm = "";
     int localSelection = 0; // 0: [Search: <term>], 1: [Create new template], then subsequent options.
-    std::vector<Food> matches;
     bool done = false;
     bool searchEditing = false;
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
 
     int midY = CONSOLE_HEIGHT / 2;
     int popUpTop = midY - 4;
@@ -735,15 +797,17 @@ void UIManager::handleAddFromTemplate() {
     int templateScrollOffset = 0;
     int visibleRows = CONSOLE_HEIGHT - popUpTop - 6;  // Adjust rows for buttons and tips.
 
+    // Load the template library on first use.
+    g_templateStore.ensureLoaded();
+
     while (!done) {
         clearScreen();
-        matches.clear();
-        // Filter available templates based on search term.
-        for (const auto &tpl : g_foodTemplates) {
-            if (tpl.name.find(searchTerm) != std::string::npos) {
-                matches.push_back(tpl);
-            }
-        }
+        // Look up ranked, typo-tolerant matches through the search index; the
+        // result holds indices into the template list rather than copies, and
+        // only as many as the list can show down to the selection.
+        const std::vector<Food> &templates = g_templateStore.all();
+        size_t wanted = static_cast<size_t>(templateScrollOffset + visibleRows + localSelection) + 1;
+        const std::vector<uint32_t> &matches = g_templateIndex.search(g_templateStore, searchTerm, wanted);
         int totalOptions = 2 + static_cast<int>(matches.size()); // Top two options plus templates.
 
         // Render top buttons: Search and Create new template.
@@ -753,9 +817,9 @@ void UIManager::handleAddFromTemplate() {
         int opt1X = (CONSOLE_WIDTH - static_cast<int>(opt1.length())) / 2;
         setCursorPosition(opt0X, popUpTop);
         if (localSelection == 0) {
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | BACKGROUND_BLUE);
+            setTextColor(FG_RED | FG_GREEN | FG_BLUE | BG_BLUE);
             std::cout << opt0;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         } else {
             std::cout << opt0;
         }
@@ -763,9 +827,9 @@ void UIManager::handleAddFromTemplate() {
         setCursorPosition(opt1X, popUpTop + 1);
         if (localSelection == 1) {
             Sounds::PlaySelectSound();
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | BACKGROUND_BLUE);
+            setTextColor(FG_RED | FG_GREEN | FG_BLUE | BG_BLUE);
             std::cout << opt1;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         } else {
             std::cout << opt1;
         }
@@ -784,22 +848,23 @@ void UIManager::handleAddFromTemplate() {
         }
 
         // Render matching food templates.
-        for (size_t i = templateScrollOffset; i < matches.size() && i < templateScrollOffset + visibleRows; i++) {
+        for (size_t i = templateScrollOffset; i < matches.size() && i < static_cast<size_t>(templateScrollOffset + visibleRows); i++) {
             int selectionIndex = 2 + static_cast<int>(i - templateScrollOffset);
             int row = popUpTop + 3 + static_cast<int>(i - templateScrollOffset);
+            const Food &tpl = templates[matches[i]];
             // Format template fields.
             std::stringstream nameStream, gramsStream, calStream, carbsStream, protStream, fatStream;
-            nameStream << std::setw(maxNameLen) << std::left << matches[i].name;
+            nameStream << std::setw(maxNameLen) << std::left << tpl.name();
             std::string foodNameStr = nameStream.str();
-            gramsStream << std::setw(4) << std::setfill('0') << matches[i].grams << " grams";
+            gramsStream << std::setw(4) << std::setfill('0') << tpl.grams << " grams";
             std::string gramsStr = gramsStream.str();
-            calStream << std::setw(4) << std::setfill('0') << matches[i].calories << " calories";
+            calStream << std::setw(4) << std::setfill('0') << tpl.calories << " calories";
             std::string calStr = calStream.str();
-            carbsStream << std::setw(3) << std::setfill('0') << matches[i].carbs << " carbs";
+            carbsStream << std::setw(3) << std::setfill('0') << tpl.carbs << " carbs";
             std::string carbsStr = carbsStream.str();
-            protStream << std::setw(3) << std::setfill('0') << matches[i].protein << " protein";
+            protStream << std::setw(3) << std::setfill('0') << tpl.protein << " protein";
             std::string protStr = protStream.str();
-            fatStream << std::setw(3) << std::setfill('0') << matches[i].fat << " fat";
+            fatStream << std::setw(3) << std::setfill('0') << tpl.fat << " fat";
             std::string fatStr = fatStream.str();
 
             std::string combinedStr = foodNameStr + " " + gramsStr + " " + calStr + " " + carbsStr + " " + protStr + " " + fatStr;
@@ -807,66 +872,67 @@ void UIManager::handleAddFromTemplate() {
             setCursorPosition(startX, row);
 
             if (localSelection == selectionIndex) {
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | BACKGROUND_BLUE | FOREGROUND_INTENSITY);
+                setTextColor(FG_RED | BG_BLUE | FG_INTENSITY);
                 std::cout << foodNameStr;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
                 std::cout << " " << gramsStr;
-                SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+                setTextColor(FG_GREEN | FG_INTENSITY);
                 std::cout << " " << calStr;
-                SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY);
+                setTextColor(FG_GREEN | FG_BLUE | FG_INTENSITY);
                 std::cout << " " << carbsStr;
-                SetConsoleTextAttribute(hConsole, FOREGROUND_BLUE | FOREGROUND_INTENSITY);
+                setTextColor(FG_BLUE | FG_INTENSITY);
                 std::cout << " " << protStr;
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_INTENSITY);
+                setTextColor(FG_RED | FG_BLUE | FG_INTENSITY);
                 std::cout << " " << fatStr;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
             } else {
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
+                setTextColor(FG_RED | FG_INTENSITY);
                 std::cout << foodNameStr;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
                 std::cout << " " << gramsStr;
-                SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+                setTextColor(FG_GREEN | FG_INTENSITY);
                 std::cout << " " << calStr;
-                SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY);
+                setTextColor(FG_GREEN | FG_BLUE | FG_INTENSITY);
                 std::cout << " " << carbsStr;
-                SetConsoleTextAttribute(hConsole, FOREGROUND_BLUE | FOREGROUND_INTENSITY);
+                setTextColor(FG_BLUE | FG_INTENSITY);
                 std::cout << " " << protStr;
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_INTENSITY);
+                setTextColor(FG_RED | FG_BLUE | FG_INTENSITY);
                 std::cout << " " << fatStr;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
             }
         }
 
         // Optional vertical scroll indicator for template list.
-        if (matches.size() > static_cast<size_t>(visibleRows)) {
+        size_t matchCount = g_templateIndex.matchCount();
+        if (matchCount > static_cast<size_t>(visibleRows)) {
             int indicatorColumn = CONSOLE_WIDTH - 2;
             for (int r = popUpTop + 3; r < popUpTop + 3 + visibleRows; r++) {
                 setCursorPosition(indicatorColumn, r);
                 std::cout << "|";
             }
-            int scrollRange = static_cast<int>(matches.size()) - visibleRows;
+            int scrollRange = static_cast<int>(matchCount) - visibleRows;
             int indicatorRow = popUpTop + 3;
             if (scrollRange > 0)
                 indicatorRow += (templateScrollOffset * (visibleRows - 1)) / scrollRange;
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | BACKGROUND_BLUE | FOREGROUND_INTENSITY);
+            setTextColor(FG_RED | BG_BLUE | FG_INTENSITY);
             setCursorPosition(indicatorColumn, indicatorRow);
             std::cout << char(219);
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         }
 
         // Render bottom tips for this UI.
-        SetConsoleTextAttribute(hConsole, 8);
+        setTextColor(8);
         setCursorPosition(0, CONSOLE_HEIGHT - 3);
         std::cout << std::string(CONSOLE_WIDTH, '-');
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
         std::string tips = "[q] Back  [j/k] Down/Up  [Enter] Select  [x] Delete";
         int tipX = (CONSOLE_WIDTH - static_cast<int>(tips.length())) / 2;
         setCursorPosition(tipX, CONSOLE_HEIGHT - 2);
-        SetConsoleTextAttribute(hConsole, 8);
+        setTextColor(8);
         std::cout << tips;
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
 
-        char key = _getch();
+        char key = readKey();
 
         if (localSelection == 0) {
             if (!searchEditing) {
@@ -897,10 +963,14 @@ void UIManager::handleAddFromTemplate() {
                 localSelection = 0;
             Sounds::PlayNavigationSound();
         } else if (key == 'k') {
-            if (localSelection > 0)
+            if (localSelection > 0) {
                 localSelection--;
-            else
+            } else {
+                // Wrapping to the last match needs all of them ranked.
+                if (!g_templateIndex.complete())
+                    totalOptions = 2 + static_cast<int>(g_templateIndex.search(g_templateStore, searchTerm).size());
                 localSelection = totalOptions - 1;
+            }
             Sounds::PlayNavigationSound();
         } else if (key == '\r') {
             if (localSelection == 0) {
@@ -926,9 +996,9 @@ void UIManager::handleAddFromTemplate() {
                         int buttonX = (CONSOLE_WIDTH - static_cast<int>(buttonText.length())) / 2;
                         setCursorPosition(buttonX, startY + i);
                         if (editSelection == i) {
-                            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY | BACKGROUND_BLUE);
+                            setTextColor(FG_RED | FG_INTENSITY | BG_BLUE);
                             std::cout << buttonText;
-                            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                            setTextColor(ConsoleColors::DEFAULT);
                         } else {
                             std::cout << buttonText;
                         }
@@ -939,23 +1009,23 @@ void UIManager::handleAddFromTemplate() {
                     setCursorPosition(addX, addY);
                     if (editSelection == 5) {
                         Sounds::PlaySelectSound();
-                        SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY | BACKGROUND_BLUE);
+                        setTextColor(FG_RED | FG_INTENSITY | BG_BLUE);
                         std::cout << addButton;
-                        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                        setTextColor(ConsoleColors::DEFAULT);
                     } else {
                         std::cout << addButton;
                     }
                     
-                    SetConsoleTextAttribute(hConsole, 8);
+                    setTextColor(8);
                     setCursorPosition(0, CONSOLE_HEIGHT - 3);
                     std::cout << std::string(CONSOLE_WIDTH, '-');
                     std::string tips = "[q] Back  [j/k] Down/Up  [Enter] Select";
                     int tipX = (CONSOLE_WIDTH - static_cast<int>(tips.length())) / 2;
                     setCursorPosition(tipX, CONSOLE_HEIGHT - 2);
                     std::cout << tips;
-                    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                    setTextColor(ConsoleColors::DEFAULT);
 
-                    char editKey = _getch();
+                    char editKey = readKey();
                     if (editKey == 'j') {
                         editSelection++;
                         if (editSelection > 5) editSelection = 0;
@@ -975,7 +1045,7 @@ void UIManager::handleAddFromTemplate() {
                             setCursorPosition(buttonX + static_cast<int>(prefix.str().length()), fieldY);
                             std::cout << std::string(10, ' ');
                             setCursorPosition(buttonX + static_cast<int>(prefix.str().length()), fieldY);
-                            std::getline(std::cin, input);
+                            readLine(input);
                             if (editSelection == 0) {
                                 tplName = input;
                             } else {
@@ -992,12 +1062,9 @@ void UIManager::handleAddFromTemplate() {
                                 }
                             }
                         } else {
-                            // Create the new template and add to the global template list.
+                            // Create the new template and add it to the template library.
                             Food newTpl(tplName, cal, carbs, prot, fat, 0);
-                            g_foodTemplates.push_back(newTpl);
-                            std::sort(g_foodTemplates.begin(), g_foodTemplates.end(), [](const Food &a, const Food &b) {
-                                return a.name < b.name;
-                            });
+                            g_templateStore.add(newTpl);
                             break;
                         }
                     }
@@ -1011,30 +1078,35 @@ void UIManager::handleAddFromTemplate() {
                 Sounds::PlaySelectSound();
                 int templateIndex = localSelection - 2 + templateScrollOffset;
                 if (templateIndex >= 0 && templateIndex < static_cast<int>(matches.size())) {
-                    Food selectedTemplate = matches[templateIndex];
+                    Food selectedTemplate = templates[matches[templateIndex]];
                     done = true;
                     clearScreen();
                     setCursorPosition((CONSOLE_WIDTH - 30) / 2, midY - 1);
-                    std::cout << "Template: " << selectedTemplate.name;
+                    std::cout << "Template: " << selectedTemplate.name();
                     setCursorPosition((CONSOLE_WIDTH - 30) / 2, midY + 1);
                     std::cout << "Enter grams to add: ";
-                    int grams;
-                    std::cin >> grams;
+                    std::string gramsInput;
+                    readLine(gramsInput);
+                    int grams = 0;
+                    try {
+                        grams = std::stoi(gramsInput);
+                    } catch (...) {
+                        // Treat unreadable input as zero grams.
+                    }
                     Food newFood = selectedTemplate;
                     newFood.grams = grams;
                     newFood.calories = (selectedTemplate.calories * grams) / 100;
                     newFood.carbs = (selectedTemplate.carbs * grams) / 100;
                     newFood.protein = (selectedTemplate.protein * grams) / 100;
                     newFood.fat = (selectedTemplate.fat * grams) / 100;
-                    DailyRecord &currentRecord = dataManager.getRecord(currentDate);
-                    currentRecord.foods.push_back(newFood);
-                    dataManager.saveData();
+                    dataManager->addFood(currentDate, newFood);
+                    g_templateStore.recordUse(matches[templateIndex]);  // Frequently used templates rank first
                     clearScreen();
                     setCursorPosition((CONSOLE_WIDTH - 30) / 2, midY);
                     std::cout << "Template food added.";
                     setCursorPosition((CONSOLE_WIDTH - 30) / 2, midY + 1);
                     std::cout << "Press any key to continue.";
-                    (void)_getch();
+                    (void)readKey();
                     return;
                 }
             }
@@ -1044,11 +1116,7 @@ void UIManager::handleAddFromTemplate() {
                 Sounds::PlaySelectSound();
                 int index = localSelection - 2 + templateScrollOffset;
                 if (index >= 0 && index < static_cast<int>(matches.size())) {
-                    auto it = std::remove_if(g_foodTemplates.begin(), g_foodTemplates.end(),
-                        [&matches, index](const Food &tpl) {
-                            return tpl.name == matches[index].name;
-                        });
-                    g_foodTemplates.erase(it, g_foodTemplates.end());
+                    g_templateStore.remove(matches[index]);
                     searchTerm = "";
                     localSelection = 0;
                     templateScrollOffset = 0;
@@ -1067,7 +1135,6 @@ void UIManager::handleAddFromTemplate() {
 // -----------------------------------------------------------------------------
 void UIManager::handleAddCustomFood() {
     clearScreen();
-    int midX = CONSOLE_WIDTH / 2;
     int startY = 8;
     int localSelection = 0;
     bool done = false;
@@ -1077,7 +1144,6 @@ void UIManager::handleAddCustomFood() {
     int protein = -1;
     int fat = -1;
     int grams = -1;
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     
     while (!done) {
         clearScreen();
@@ -1100,13 +1166,13 @@ void UIManager::handleAddCustomFood() {
             int buttonX = (CONSOLE_WIDTH - static_cast<int>(buttonText.length())) / 2;
             setCursorPosition(buttonX, startY + i);
             if (localSelection == i) {
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY | BACKGROUND_BLUE);
+                setTextColor(FG_RED | FG_INTENSITY | BG_BLUE);
                 std::cout << buttonText;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
             } else {
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
+                setTextColor(FG_RED | FG_INTENSITY);
                 std::cout << buttonText;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
             }
         }
         
@@ -1116,28 +1182,28 @@ void UIManager::handleAddCustomFood() {
         int addX = (CONSOLE_WIDTH - static_cast<int>(addButton.length())) / 2;
         setCursorPosition(addX, addY);
         if (localSelection == 6) {
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY | BACKGROUND_BLUE);
+            setTextColor(FG_RED | FG_INTENSITY | BG_BLUE);
             std::cout << addButton;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         } else {
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
+            setTextColor(FG_RED | FG_INTENSITY);
             std::cout << addButton;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         }
         
         // Render bottom tips.
-        SetConsoleTextAttribute(hConsole, 8);
+        setTextColor(8);
         setCursorPosition(0, CONSOLE_HEIGHT - 3);
         std::cout << std::string(CONSOLE_WIDTH, '-');
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
         std::string tips = "[q] Back  [j/k] Down/Up  [Enter] Select";
         int tipX = (CONSOLE_WIDTH - static_cast<int>(tips.length())) / 2;
         setCursorPosition(tipX, CONSOLE_HEIGHT - 2);
-        SetConsoleTextAttribute(hConsole, 8);
+        setTextColor(8);
         std::cout << tips;
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
         
-        char key = _getch();
+        char key = readKey();
         if (key == 'j') {
             localSelection++;
             if (localSelection > 6)
@@ -1164,7 +1230,7 @@ void UIManager::handleAddCustomFood() {
                 std::cout << std::string(20, ' ');
                 setCursorPosition(editX, editY);
                 std::string input;
-                std::getline(std::cin, input);
+                readLine(input);
                 if (!input.empty()) {
                     if (localSelection == 0) {
                         if (input.size() > maxNameLen)
@@ -1193,9 +1259,7 @@ void UIManager::handleAddCustomFood() {
                 int finalProtein = (protein == -1 ? 0 : protein);
                 int finalFat = (fat == -1 ? 0 : fat);
                 int finalGrams = (grams == -1 ? 0 : grams);
-                DailyRecord &record = dataManager.getRecord(currentDate);
-                record.foods.push_back(Food(finalName, finalCalories, finalCarbs, finalProtein, finalFat, finalGrams));
-                dataManager.saveData();
+                dataManager->addFood(currentDate, Food(finalName, finalCalories, finalCarbs, finalProtein, finalFat, finalGrams));
                 return;
             }
         } else if (key == 'q') {
@@ -1211,13 +1275,11 @@ void UIManager::handleAddCustomFood() {
 //          enter their daily nutritional goals using inline editing.
 // -----------------------------------------------------------------------------
 void UIManager::handleStartGoals() {
-    int midX = CONSOLE_WIDTH / 2;
     int startY = 8;
     int localSelection = 0;  // Fields: Calories, Carbs, Protein, Fat, and then the [Start] button.
     bool done = false;
     std::string fieldLabels[4] = { "Calories", "Carbs", "Protein", "Fat" };
     int fieldValues[4] = { 0, 0, 0, 0 };
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     
     while (!done) {
         clearScreen();
@@ -1229,13 +1291,13 @@ void UIManager::handleStartGoals() {
             int buttonX = (CONSOLE_WIDTH - static_cast<int>(buttonText.length())) / 2;
             setCursorPosition(buttonX, startY + i);
             if (localSelection == i) {
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY | BACKGROUND_BLUE);
+                setTextColor(FG_RED | FG_INTENSITY | BG_BLUE);
                 std::cout << buttonText;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
             } else {
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
+                setTextColor(FG_RED | FG_INTENSITY);
                 std::cout << buttonText;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
             }
         }
         // Render the Start button.
@@ -1244,27 +1306,27 @@ void UIManager::handleStartGoals() {
         int buttonX = (CONSOLE_WIDTH - static_cast<int>(startButton.length())) / 2;
         setCursorPosition(buttonX, buttonY);
         if (localSelection == 4) {
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY | BACKGROUND_BLUE);
+            setTextColor(FG_RED | FG_INTENSITY | BG_BLUE);
             std::cout << startButton;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         } else {
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
+            setTextColor(FG_RED | FG_INTENSITY);
             std::cout << startButton;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         }
         
         // Display tips.
-        SetConsoleTextAttribute(hConsole, 8);
+        setTextColor(8);
         setCursorPosition(0, CONSOLE_HEIGHT - 3);
         std::cout << std::string(CONSOLE_WIDTH, '-');
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
         std::string tips = "[q] Cancel  [j/k] Down/Up  [Enter] Select";
         int tipX = (CONSOLE_WIDTH - static_cast<int>(tips.length())) / 2;
         setCursorPosition(tipX, CONSOLE_HEIGHT - 2);
         std::cout << tips;
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
 
-        char key = _getch();
+        char key = readKey();
         
         if (key == 'j') {
             localSelection++;
@@ -1292,7 +1354,7 @@ void UIManager::handleStartGoals() {
                 std::cout << std::string(10, ' ');
                 setCursorPosition(editX, editY);
                 std::string input;
-                std::getline(std::cin, input);
+                readLine(input);
                 if (!input.empty()) {
                     try {
                         int value = std::stoi(input);
@@ -1310,8 +1372,7 @@ void UIManager::handleStartGoals() {
                 newGoals.carbs = fieldValues[1];
                 newGoals.protein = fieldValues[2];
                 newGoals.fat = fieldValues[3];
-                dataManager.setDailyGoals(newGoals);
-                dataManager.saveData();
+                dataManager->setDailyGoals(newGoals);
                 done = true;
             }
         } else if (key == 'q') {
@@ -1326,14 +1387,12 @@ void UIManager::handleStartGoals() {
 // Purpose: Allows the user to reset current nutritional goals via an inline editing screen.
 // -----------------------------------------------------------------------------
 void UIManager::handleResetGoals() {
-    int midX = CONSOLE_WIDTH / 2;
     int startY = 8;
     int localSelection = 0;  // Fields: Calories, Carbs, Protein, Fat, then Update button.
     bool done = false;
-    DailyGoals currentGoals = dataManager.getDailyGoals();
+    DailyGoals currentGoals = dataManager->getDailyGoals();
     std::string fieldLabels[4] = { "Calories", "Carbs", "Protein", "Fat" };
     int fieldValues[4] = { currentGoals.calories, currentGoals.carbs, currentGoals.protein, currentGoals.fat };
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     
     while (!done) {
         clearScreen();
@@ -1345,13 +1404,13 @@ void UIManager::handleResetGoals() {
             int buttonX = (CONSOLE_WIDTH - static_cast<int>(buttonText.length())) / 2;
             setCursorPosition(buttonX, startY + i);
             if (localSelection == i) {
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY | BACKGROUND_BLUE);
+                setTextColor(FG_RED | FG_INTENSITY | BG_BLUE);
                 std::cout << buttonText;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
             } else {
-                SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
+                setTextColor(FG_RED | FG_INTENSITY);
                 std::cout << buttonText;
-                SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+                setTextColor(ConsoleColors::DEFAULT);
             }
         }
         // Render the Update button.
@@ -1360,28 +1419,28 @@ void UIManager::handleResetGoals() {
         int updateX = (CONSOLE_WIDTH - static_cast<int>(updateButton.length())) / 2;
         setCursorPosition(updateX, updateY);
         if (localSelection == 4) {
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY | BACKGROUND_BLUE);
+            setTextColor(FG_RED | FG_INTENSITY | BG_BLUE);
             std::cout << updateButton;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         } else {
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
+            setTextColor(FG_RED | FG_INTENSITY);
             std::cout << updateButton;
-            SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+            setTextColor(ConsoleColors::DEFAULT);
         }
         
         // Render bottom tips.
-        SetConsoleTextAttribute(hConsole, 8);
+        setTextColor(8);
         setCursorPosition(0, CONSOLE_HEIGHT - 3);
         std::cout << std::string(CONSOLE_WIDTH, '-');
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
         std::string tips = "[q] Back  [j/k] Down/Up  [Enter] Select";
         int tipX = (CONSOLE_WIDTH - static_cast<int>(tips.length())) / 2;
         setCursorPosition(tipX, CONSOLE_HEIGHT - 2);
-        SetConsoleTextAttribute(hConsole, 8);
+        setTextColor(8);
         std::cout << tips;
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+        setTextColor(ConsoleColors::DEFAULT);
         
-        char key = _getch();
+        char key = readKey();
         if (key == 'j') {
             localSelection++;
             if (localSelection > 4)
@@ -1408,7 +1467,7 @@ void UIManager::handleResetGoals() {
                 std::cout << std::string(10, ' ');
                 setCursorPosition(editX, editY);
                 std::string input;
-                std::getline(std::cin, input);
+                readLine(input);
                 if (!input.empty()) {
                     try {
                         int value = std::stoi(input);
@@ -1423,8 +1482,7 @@ void UIManager::handleResetGoals() {
                 newGoals.carbs = fieldValues[1];
                 newGoals.protein = fieldValues[2];
                 newGoals.fat = fieldValues[3];
-                dataManager.setDailyGoals(newGoals);
-                dataManager.saveData();
+                dataManager->setDailyGoals(newGoals);
                 done = true;
             }
         } else if (key == 'q') {
@@ -1434,95 +1492,229 @@ void UIManager::handleResetGoals() {
     }
 }
 
+// -----------------------------------------------------------------------------
+// Method: handleSwitchProfile
+// Purpose: Lists the profiles with a [New profile] entry at the end. Picking
+//          a profile makes it active; a new profile is named inline and
+//          opened straight away.
+// -----------------------------------------------------------------------------
+void UIManager::handleSwitchProfile() {
+    int startY = 4;
+    const std::vector<std::string> &names = profiles.names();
+    int localSelection = 0;
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == activeProfile)
+            localSelection = static_cast<int>(i);
+    }
+    std::string message;  // Shown under the list after a rejected name
+
+    while (true) {
+        clearScreen();
+        int entryCount = static_cast<int>(names.size()) + 1;
+        int visibleRows = CONSOLE_HEIGHT - 6 - startY;
+        int scroll = localSelection >= visibleRows ? localSelection - visibleRows + 1 : 0;
+
+        setTextColor(FG_RED | FG_GREEN | FG_INTENSITY);
+        std::string title = "Profiles";
+        setCursorPosition((CONSOLE_WIDTH - static_cast<int>(title.length())) / 2, startY - 2);
+        std::cout << title;
+        setTextColor(ConsoleColors::DEFAULT);
+
+        // Render the profile names, the active one marked, then [New profile].
+        for (int row = 0; row < visibleRows && scroll + row < entryCount; row++) {
+            int i = scroll + row;
+            std::string text;
+            if (i < static_cast<int>(names.size()))
+                text = (names[i] == activeProfile ? "* " : "  ") + names[i];
+            else
+                text = "[New profile]";
+            setCursorPosition((CONSOLE_WIDTH - 36) / 2, startY + row);
+            setTextColor(i == localSelection ? FG_RED | FG_INTENSITY | BG_BLUE : FG_RED | FG_INTENSITY);
+            std::cout << text;
+            setTextColor(ConsoleColors::DEFAULT);
+        }
+        if (!message.empty()) {
+            setTextColor(FG_RED);
+            setCursorPosition((CONSOLE_WIDTH - static_cast<int>(message.length())) / 2, CONSOLE_HEIGHT - 5);
+            std::cout << message;
+            setTextColor(ConsoleColors::DEFAULT);
+        }
+
+        // Render bottom tips.
+        setTextColor(8);
+        setCursorPosition(0, CONSOLE_HEIGHT - 3);
+        std::cout << std::string(CONSOLE_WIDTH, '-');
+        setTextColor(ConsoleColors::DEFAULT);
+        std::string tips = "[q] Back  [j/k] Down/Up  [Enter] Select";
+        int tipX = (CONSOLE_WIDTH - static_cast<int>(tips.length())) / 2;
+        setCursorPosition(tipX, CONSOLE_HEIGHT - 2);
+        setTextColor(8);
+        std::cout << tips;
+        setTextColor(ConsoleColors::DEFAULT);
+
+        char key = readKey();
+        if (key == 'j') {
+            localSelection = (localSelection + 1) % entryCount;
+            Sounds::PlayNavigationSound();
+        } else if (key == 'k') {
+            localSelection = (localSelection + entryCount - 1) % entryCount;
+            Sounds::PlayNavigationSound();
+        } else if (key == '\r') {
+            Sounds::PlaySelectSound();
+            if (localSelection < static_cast<int>(names.size())) {
+                switchProfile(names[localSelection]);
+                return;
+            }
+            // Name the new profile in place of the [New profile] entry.
+            int editY = startY + (localSelection - scroll);
+            setCursorPosition((CONSOLE_WIDTH - 36) / 2, editY);
+            std::cout << std::string(36, ' ');
+            setCursorPosition((CONSOLE_WIDTH - 36) / 2, editY);
+            std::cout << "Name: ";
+            std::string input;
+            readLine(input);
+            if (input.empty())
+                continue;
+            if (!profiles.add(input)) {
+                message = profiles.contains(input) ? "A profile with that name already exists."
+                                                   : "Use up to 32 letters, digits, '-' or '_'.";
+                continue;
+            }
+            switchProfile(input);
+            return;
+        } else if (key == 'q') {
+            Sounds::PlaySelectSound();
+            return;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Method: switchProfile
+// Purpose: Points the UI at another profile's data. A profile still in memory
+//          is a lookup; otherwise it is loaded, and a brand-new one asks for
+//          its goals as on a first run.
+// -----------------------------------------------------------------------------
+void UIManager::switchProfile(const std::string &name) {
+    if (name == activeProfile)
+        return;
+    bool wasLoaded = profiles.isLoaded(name);
+    dataManager = &profiles.open(name);
+    activeProfile = name;
+    selectedIndex = 0;
+    foodScrollOffset = 0;
+    if (!wasLoaded && dataManager->isFirstRun())
+        handleStartGoals();
+}
+
 // -----------------------------------------------------------------------------
 // Method: renderCalendar
 // Purpose: Displays a calendar view for the user to choose a specific date.
 // -----------------------------------------------------------------------------
 void UIManager::renderCalendar() {
     clearScreen();
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-
-    int day, month, year;
-    sscanf_s(currentDate.c_str(), "%d/%d/%d", &day, &month, &year);
-
-    // Calculate the first day of the month.
-    tm firstDay = {};
-    firstDay.tm_mday = 1;
-    firstDay.tm_mon = month - 1;
-    firstDay.tm_year = year - 1900;
-    mktime(&firstDay);
-    int startWeekday = firstDay.tm_wday;
-
-    // Calculate the number of days in the month.
-    tm nextMonth = firstDay;
-    nextMonth.tm_mon += 1;
-    mktime(&nextMonth);
-    time_t firstOfNextMonth = mktime(&nextMonth);
-    time_t lastDayTime = firstOfNextMonth - 86400;
-    tm lastDay;
-    localtime_s(&lastDay, &lastDayTime);
-    int daysInMonth = lastDay.tm_mday;
-
-    int gridRows = (startWeekday + daysInMonth + 6) / 7;
+
+    const MonthLayout &layout = shownMonth();
+    int gridRows = layout.rows;
     int calendarBlockHeight = 2 + gridRows;
     int verticalOffset = (CONSOLE_HEIGHT - calendarBlockHeight) / 2;
     if (verticalOffset < 0)
         verticalOffset = 0;
 
     // Render the calendar header with month and year.
-    SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+    setTextColor(FG_RED | FG_GREEN | FG_INTENSITY);
     static const char* monthNames[] = {"January", "February", "March", "April", "May", "June",
                                         "July", "August", "September", "October", "November", "December"};
-    std::string header = std::string(monthNames[month-1]) + " " + std::to_string(year);
+    std::string header = std::string(monthNames[layout.month-1]) + " " + std::to_string(layout.year);
     int headerStartX = (CONSOLE_WIDTH - static_cast<int>(header.length())) / 2;
     setCursorPosition(headerStartX, verticalOffset);
     std::cout << header;
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
 
     // Render the weekday names.
-    SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+    setTextColor(FG_RED | FG_GREEN | FG_INTENSITY);
     std::string daysHeader = "Su Mo Tu We Th Fr Sa";
     int daysHeaderStartX = (CONSOLE_WIDTH - static_cast<int>(daysHeader.length())) / 2;
     setCursorPosition(daysHeaderStartX, verticalOffset + 1);
     std::cout << daysHeader;
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
 
-    // Render the days grid.
+    // Render the days grid, each day coloured by its calories against the
+    // goal. The whole month's per-day summaries come from one lookup.
+    RangeValues daySummaries[31];
+    dataManager->summarizeDays(layout.firstDay, static_cast<size_t>(layout.dayCount), daySummaries);
+    int calorieGoal = dataManager->getDailyGoals().calories;
     int gridStartRow = verticalOffset + 2;
-    int currentRow = gridStartRow;
-    int currentCol = startWeekday;
     int colStart = daysHeaderStartX;
-    for (int d = 1; d <= daysInMonth; d++) {
-        int posX = colStart + currentCol * 3;
-        int posY = currentRow;
-        if (d == selectedCalendarDay) {
-            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | BACKGROUND_BLUE);
-        }
-        setCursorPosition(posX, posY);
-        if (d < 10)
-            std::cout << "  " << d;
-        else
-            std::cout << " " << d;
-        SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
-        currentCol++;
-        if (currentCol > 6) {
-            currentCol = 0;
-            currentRow++;
+    for (int row = 0; row < layout.rows; row++) {
+        for (int col = 0; col < MonthLayout::COLUMNS; col++) {
+            int d = layout.cells[row][col];
+            if (d == 0)
+                continue;
+            ColorAttribute heat = heatmapColor(daySummaries[d - 1], calorieGoal);
+            if (d == selectedCalendarDay) {
+                setTextColor(heat == HEAT_EMPTY ? FG_RED | FG_GREEN | FG_BLUE | BG_BLUE : heat | BG_BLUE);
+            } else {
+                setTextColor(heat);
+            }
+            setCursorPosition(colStart + col * 3, gridStartRow + row);
+            if (d < 10)
+                std::cout << "  " << d;
+            else
+                std::cout << " " << d;
+            setTextColor(ConsoleColors::DEFAULT);
         }
     }
 
+    // Render the month's totals below the grid (one range query, not a loop over days).
+    RangeSummary monthSummary = dataManager->summarizeRange(layout.firstDay, layout.lastDay());
+    std::stringstream summaryStream;
+    summaryStream << "Month: " << monthSummary.totals.calories << " kcal";
+    if (monthSummary.totals.loggedDays > 0) {
+        summaryStream << "  Avg: " << monthSummary.totals.calories / monthSummary.totals.loggedDays
+                      << " kcal over " << monthSummary.totals.loggedDays << " logged days";
+    }
+    std::string summaryLine = summaryStream.str();
+    setTextColor(8);
+    setCursorPosition((CONSOLE_WIDTH - static_cast<int>(summaryLine.length())) / 2, gridStartRow + gridRows + 1);
+    std::cout << summaryLine;
+
+    // And the whole history's totals, including the grams the range
+    // aggregate does not track: one column pass over the days in memory.
+    ColumnTotals history = dataManager->summarizeHistory();
+    std::stringstream historyStream;
+    historyStream << "All time: " << history.values[COLUMN_CALORIES] << " kcal, "
+                  << history.values[COLUMN_GRAMS] << " g of food";
+    std::string historyLine = historyStream.str();
+    setCursorPosition((CONSOLE_WIDTH - static_cast<int>(historyLine.length())) / 2, gridStartRow + gridRows + 3);
+    std::cout << historyLine;
+    setTextColor(ConsoleColors::DEFAULT);
+
+    // Render the heatmap legend.
+    static const struct { ColorAttribute color; const char *label; } legend[] = {
+        { HEAT_UNDER, "Under" }, { HEAT_ON_TARGET, "On target" },
+        { HEAT_SLIGHTLY_OVER, "Up to 10% over" }, { HEAT_OVER, "Over" }
+    };
+    std::string legendText = "Under  On target  Up to 10% over  Over";
+    setCursorPosition((CONSOLE_WIDTH - static_cast<int>(legendText.length())) / 2, gridStartRow + gridRows + 2);
+    for (size_t i = 0; i < sizeof(legend) / sizeof(legend[0]); i++) {
+        setTextColor(legend[i].color);
+        std::cout << (i > 0 ? "  " : "") << legend[i].label;
+    }
+    setTextColor(ConsoleColors::DEFAULT);
+
     // Render bottom tips.
-    SetConsoleTextAttribute(hConsole, 8);
+    setTextColor(8);
     setCursorPosition(0, CONSOLE_HEIGHT - 3);
     std::cout << std::string(CONSOLE_WIDTH, '-');
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
 
     std::string calendarTips = "[q] Back  [j/k] Down/Up  [h/l] Left/Right  [b/w] Previous/Next  [Enter] Select";
     int tipStartX = (CONSOLE_WIDTH - static_cast<int>(calendarTips.length())) / 2;
     setCursorPosition(tipStartX, CONSOLE_HEIGHT - 2);
-    SetConsoleTextAttribute(hConsole, 8);
+    setTextColor(8);
     std::cout << calendarTips;
-    SetConsoleTextAttribute(hConsole, ConsoleColors::DEFAULT);
+    setTextColor(ConsoleColors::DEFAULT);
 }
 
 // -----------------------------------------------------------------------------
@@ -1530,42 +1722,28 @@ void UIManager::renderCalendar() {
 // Purpose: Process key events in the calendar view to allow date navigation.
 // -----------------------------------------------------------------------------
 void UIManager::processCalendarInput(char key) {
-    int day, month, year;
-    sscanf_s(currentDate.c_str(), "%d/%d/%d", &day, &month, &year);
-    tm firstDay = {};
-    firstDay.tm_mday = 1;
-    firstDay.tm_mon = month - 1;
-    firstDay.tm_year = year - 1900;
-    mktime(&firstDay);
-    tm nextMonth = firstDay;
-    nextMonth.tm_mon += 1;
-    mktime(&nextMonth);
-    time_t firstOfNextMonth = mktime(&nextMonth);
-    time_t lastDayTime = firstOfNextMonth - 86400;
-    tm lastDay;
-    localtime_s(&lastDay, &lastDayTime);
-    int daysInMonth = lastDay.tm_mday;
-
-    int startWeekday = firstDay.tm_wday;
-    int col = (startWeekday + selectedCalendarDay - 1) % 7;
-
-    // Navigate between months.
+    const MonthLayout &layout = shownMonth();
+    int month = layout.month;
+    int year = layout.year;
+    int daysInMonth = layout.dayCount;
+    int col = layout.column(selectedCalendarDay);
+
+    // Navigate between months. The first of the month is shown, so the day
+    // always exists.
     if (key == 'b') {
         month--;
         if (month < 1) { month = 12; year--; }
         selectedCalendarDay = 1;
-        char buffer[11];
-        sprintf_s(buffer, "%02d/%02d/%04d", day, month, year);
-        currentDate = buffer;
+        if (Date::isValid(year, month, 1))
+            currentDate = Date::fromCivil(year, month, 1);
         Sounds::PlayPageSwitchSound();
     }
     else if (key == 'w') {
         month++;
         if (month > 12) { month = 1; year++; }
         selectedCalendarDay = 1;
-        char buffer[11];
-        sprintf_s(buffer, "%02d/%02d/%04d", day, month, year);
-        currentDate = buffer;
+        if (Date::isValid(year, month, 1))
+            currentDate = Date::fromCivil(year, month, 1);
         Sounds::PlayPageSwitchSound();
     }
     else if (key == 'q') {
@@ -1573,6 +1751,12 @@ void UIManager::processCalendarInput(char key) {
         currentDate = calendarOriginalDate;  // Restore original date if user cancels.
         currentState = STATE_MAIN_MENU;
     }
+    else if (key == 'f') {
+        renderer.toggleFrameTime();
+    }
+    else if (key == 'm') {
+        Sounds::ToggleMute();
+    }
     else if (key == 'h') {
         if (selectedCalendarDay > 1 && col > 0) {
             selectedCalendarDay--;
@@ -1599,9 +1783,7 @@ void UIManager::processCalendarInput(char key) {
     }
     else if (key == '\r') {
         // Set current date to selected date from the calendar.
-        char buffer[11];
-        sprintf_s(buffer, "%02d/%02d/%04d", selectedCalendarDay, month, year);
-        currentDate = buffer;
+        currentDate = layout.dateOf(selectedCalendarDay);
         currentState = STATE_MAIN_MENU;
         Sounds::PlaySelectSound();
     }
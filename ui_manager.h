@@ -11,6 +11,9 @@
 #include <string>
 #include <vector>
 #include "data_manager.h"  // Provides access to persistent data
+#include "profile_registry.h"  // One DataManager per profile, loaded on demand
+#include "console_renderer.h"  // Off-screen cell buffer behind all drawing
+#include "calendar_layout.h"   // Month grid for the calendar view
 
 // -----------------------------------------------------------------------------
 // Enum: UIState
@@ -29,13 +32,14 @@ enum UIState {
 // -----------------------------------------------------------------------------
 class UIManager {
 public:
-    // Constructor: requires a reference to a DataManager instance.
-    UIManager(DataManager &dataManager);
+    // Constructor: requires the profile registry and the profile to start in.
+    UIManager(ProfileRegistry &profiles, const std::string &profile);
     ~UIManager();
 
     // Initializes the console UI; hides the cursor and clears the screen.
     void init();
     // Enters the main application loop waiting for user input to update the UI.
+    // Returns when the user quits.
     void run();
     // Renders the main menu screen including nutritional totals and food lists.
     void renderMainMenu();
@@ -45,10 +49,12 @@ public:
     void processInput(char key);
     // Processes key inputs when in the calendar view.
     void processCalendarInput(char key);
-    // Utility to clear the console screen.
+    // Utility to start a new, blank frame.
     void clearScreen();
-    // Utility to set the console cursor to a specific (x,y) location.
+    // Utility to move the drawing position to a specific (x,y) location.
     void setCursorPosition(int x, int y);
+    // Utility to set the color of subsequent output.
+    void setTextColor(ColorAttribute color);
     // Draws borders around UI components (e.g., for better visual grouping).
     void drawBorder(int x, int y, int width, int height);
     // Returns the current date formatted as "DD/MM/YYYY - DayName".
@@ -64,18 +70,25 @@ public:
     void handleStartGoals();
 
 private:
-    std::string calendarOriginalDate;  // Stores date before switching to calendar view
+    Date calendarOriginalDate;  // Stores date before switching to calendar view
     // Private helper methods for food template operations and UI updates.
     void handleEditFood(int foodIndex);    // Edit an existing food entry
     void handleAddFromTemplate();          // Add food from a list of predefined templates
     void handleAddCustomFood();            // Add a food entry manually
-    void updateTotals();                   // Recalculates nutritional totals for the day
+    void updateTotals();                   // Reads the day's running nutritional totals
     void playSoundForKey(char key);        // (Future extension) Play a sound based on key input
     void handleResetGoals();               // Reset current daily nutritional goals
+    void handleSwitchProfile();            // Pick or create a profile
+    void switchProfile(const std::string &name);  // Make 'name' the active profile
+    char readKey();                        // Present the frame, then wait for a key
+    void readLine(std::string &line);      // Present the frame, then read an echoed line
+    const MonthLayout &shownMonth();       // Grid of currentDate's month, rebuilt only when the month changes
 
-    DataManager &dataManager;  // Reference to the DataManager object for data operations.
+    ProfileRegistry &profiles;  // Every profile; owns the DataManagers
+    std::string activeProfile;  // Name of the profile being shown
+    DataManager *dataManager;   // Data of the active profile, owned by 'profiles'
     UIState currentState;      // Represents the current state of the UI.
-    std::string currentDate;   // Stores the current date in "DD/MM/YYYY" format.
+    Date currentDate;          // The day being shown and edited.
 
     // Variables to manage selection in menus and scrolling for food entries.
     int selectedIndex;                 // Global selection index for menu and food list items.
@@ -90,6 +103,15 @@ private:
 
     // Variables specific to the calendar view.
     int selectedCalendarDay;  // Currently selected day in the calendar grid.
+    MonthLayout calendarMonth;  // Cached grid, reused between keypresses in the same month
+
+    bool quitRequested;       // Set by [q] in the main menu to leave run().
+
+    // Rendering: all std::cout output lands in 'renderer' and is shown by readKey/readLine.
+    Terminal &terminal;                  // Console backend for this platform
+    ConsoleRenderer renderer;            // Diffs each frame against the previous one
+    RendererStreamBuf rendererStream;    // Installed as std::cout's buffer by init()
+    std::streambuf *previousCoutBuffer;  // Restored by the destructor
 };
 
 #endif // UI_MANAGER_H